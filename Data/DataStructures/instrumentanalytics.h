@@ -13,6 +13,13 @@ struct InstrumentAnalytics {
     double maxPeriodVolatility = 0.0;  // Maximum volatility from calculated periods
     bool volatilityCalculated = false; // Status flag
 
+    // --- OHLC Volatility Estimators (21 daily bars, per-day std dev; series via DataManager::getRealizedVolatility) ---
+    double parkinsonVol21 = 0.0;       // High/low range estimator
+    double garmanKlassVol21 = 0.0;     // Open/high/low/close estimator
+    double rogersSatchellVol21 = 0.0;  // Drift-independent OHLC estimator
+    double yangZhangVol21 = 0.0;       // Overnight + open-to-close + Rogers-Satchell
+    bool ohlcVolatilityCalculated = false; // Status flag
+
     // --- Daily Range Bands (Based on Previous Day's Close) ---
     double prevDayClose = 0.0;         // The closing price used for calculation
     double rangeUpperBand_PC = 0.0;    // Upper band = Ceil(PrevClose + (PrevClose * AvgVol * GoldenRatio))
@@ -31,6 +38,13 @@ struct InstrumentAnalytics {
     double ema21_5Min = 0.0;           // EMA(21) based on 5-minute closing prices
     bool ema21_5Min_Calculated = false; // Status flag
 
+    // --- Range Indicators (5-minute, TA::rangeIndicators) ---
+    double atr14_5Min = 0.0;           // Wilder ATR(14)
+    double adx14_5Min = 0.0;           // ADX(14)
+    double supertrend_5Min = 0.0;      // Supertrend(10, 3) line
+    int supertrendDir_5Min = 0;        // +1 up-trend, -1 down-trend
+    bool rangeIndicators_5Min_Calculated = false; // Status flag
+
     // --- Swing High/Low (Based on Daily Data) ---
     double high_7D = 0.0;              // Highest high over the last 7 daily candles
     double low_7D = 0.0;               // Lowest low over the last 7 daily candles
@@ -47,6 +61,10 @@ struct InstrumentAnalytics {
 
     // --- Meta Data ---
     QDateTime lastCalculationTime;     // Timestamp when these analytics were last updated
+    quint64 dailySeriesVersion = 0;    // DataManager::seriesVersion(token, "day") the daily fields came from
+    QDateTime dailyLastBar;            // Last daily bar included
+    quint64 fiveMinSeriesVersion = 0;  // DataManager::seriesVersion(token, "5minute") the 5-min fields came from
+    QDateTime fiveMinLastBar;          // Last 5-minute bar included
 };
 
 #endif // INSTRUMENTANALYTICS_H
@@ -19,6 +19,7 @@ struct InstrumentData {
     QString instrumentType;
     QString segment;
     QString exchange;
+    bool continuousHistory = false; // NFO futures/options: daily history requested with continuous=1
 };
 
 #endif // INSTRUMENTDATA_H
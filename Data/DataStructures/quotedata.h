@@ -0,0 +1,53 @@
+#ifndef QUOTEDATA_H
+#define QUOTEDATA_H
+
+#include <QtGlobal>
+#include <type_traits>
+
+// One price level of the 5-deep market depth.
+struct QuoteDepthLevel {
+    double price = 0.0;
+    qint32 quantity = 0;
+    qint32 orders = 0;
+};
+
+// Snapshot from Kite /quote, /quote/ohlc or /quote/ltp, parsed straight from the JSON.
+// Fixed layout (no QString/QDateTime) so batches are flat arrays that copy with memcpy;
+// fields a mode does not return stay 0.
+struct QuoteData {
+    enum Mode : quint8 {
+        Ltp = 0,    // last_price only
+        Ohlc = 1,   // + ohlc
+        Full = 2    // + volume, OI, circuit limits, depth
+    };
+
+    quint32 instrumentToken = 0;
+    Mode mode = Ltp;
+    qint64 timestampMs = 0;        // exchange timestamp, ms since epoch (Full only)
+    qint64 lastTradeTimeMs = 0;    // (Full only)
+
+    double lastPrice = 0.0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;            // previous session close
+    double netChange = 0.0;
+    double averagePrice = 0.0;
+    double lowerCircuit = 0.0;
+    double upperCircuit = 0.0;
+
+    qint64 lastQuantity = 0;
+    qint64 volume = 0;
+    qint64 buyQuantity = 0;
+    qint64 sellQuantity = 0;
+    qint64 oi = 0;
+    qint64 oiDayHigh = 0;
+    qint64 oiDayLow = 0;
+
+    QuoteDepthLevel buy[5];
+    QuoteDepthLevel sell[5];
+};
+
+static_assert(std::is_trivially_copyable<QuoteData>::value, "QuoteData must stay trivially copyable");
+
+#endif // QUOTEDATA_H
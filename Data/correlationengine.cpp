@@ -0,0 +1,216 @@
+#include "Data/correlationengine.h"
+
+#include <QtMath>
+#include <limits>
+
+namespace {
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const int kTile = 32;           // 32 x 32 doubles = 8 KB per tile
+const int kRebuildEvery = 8;    // Window mode: exact rebuild every 8 windows to cancel drift
+const int kMaxPendingRows = 16; // incomplete rows kept while waiting for a lagging instrument
+}
+
+CorrelationEngine::CorrelationEngine(Mode mode, int lengthBars, int blockThreshold, int blockRows)
+    : m_mode(mode)
+    , m_length(qMax(2, lengthBars))
+    , m_lambda(qPow(0.5, 1.0 / qMax(2, lengthBars)))
+    , m_blockThreshold(qMax(1, blockThreshold))
+    , m_blockRows(qMax(1, blockRows))
+{
+}
+
+void CorrelationEngine::setInstruments(const QStringList &tokens)
+{
+    m_tokens = tokens;
+    m_index.clear();
+    for (int i = 0; i < tokens.size(); ++i) m_index.insert(tokens[i], i);
+    m_n = tokens.size();
+    m_rows = 0;
+    m_sinceRebuild = 0;
+    m_lastClose.fill(0.0, m_n);
+    m_lastBarMs.fill(std::numeric_limits<qint64>::min(), m_n);
+    m_pending.clear();
+    m_window.clear();
+    m_sum.fill(0.0, m_n);
+    m_cross.fill(0.0, m_n * m_n);
+    m_weight = 0.0;
+    m_queue.clear();
+    m_queueWeight.clear();
+    m_queueDecay = 1.0;
+}
+
+// ---------- input ----------
+void CorrelationEngine::addBar(const QString &token, const QDateTime &timestamp, double close)
+{
+    const int i = indexOf(token);
+    if (i < 0 || !timestamp.isValid() || !(close > 0.0)) return;
+    const qint64 ms = timestamp.toMSecsSinceEpoch();
+    if (ms <= m_lastBarMs[i]) return;
+    m_lastBarMs[i] = ms;
+
+    // An instrument that stops reporting would keep every other timestamp pending forever, so
+    // only the newest kMaxPendingRows incomplete rows are kept.
+    auto slot = m_pending.find(ms);
+    if (slot == m_pending.end()) {
+        if (m_pending.size() >= kMaxPendingRows) {
+            if (ms < m_pending.firstKey()) return; // older than every row kept: dropped first anyway
+            m_pending.erase(m_pending.begin());
+        }
+        slot = m_pending.insert(ms, Pending());
+    }
+    Pending &p = slot.value();
+    if (p.close.isEmpty()) p.close.fill(kNaN, m_n);
+    p.close[i] = close;
+    if (++p.count < m_n) return;
+
+    // Row complete: anything older can never complete now (every instrument has moved past it).
+    const QVector<double> closes = p.close;
+    while (!m_pending.isEmpty() && m_pending.firstKey() <= ms) m_pending.erase(m_pending.begin());
+
+    bool haveReturns = true;
+    QVector<double> x(m_n);
+    for (int k = 0; k < m_n; ++k) {
+        if (!(m_lastClose[k] > 0.0)) haveReturns = false;
+        else x[k] = qLn(closes[k] / m_lastClose[k]);
+    }
+    m_lastClose = closes;
+    if (haveReturns) commitRow(x);
+}
+
+void CorrelationEngine::commitRow(const QVector<double> &x)
+{
+    ++m_rows;
+    if (m_mode == Mode::Exponential) {
+        // Rows already queued decay with the matrix; the new row enters with weight (1 - lambda).
+        for (double &w : m_queueWeight) w *= m_lambda;
+        m_queueDecay *= m_lambda;
+        queueRow(x, 1.0 - m_lambda);
+    } else {
+        m_window.append(x);
+        queueRow(x, 1.0);
+        if (m_window.size() > m_length) {
+            queueRow(m_window.first(), -1.0);
+            m_window.removeFirst();
+        }
+        if (++m_sinceRebuild >= kRebuildEvery * m_length) rebuildWindow();
+    }
+    if (m_n < m_blockThreshold || m_queue.size() >= m_blockRows) flush();
+}
+
+void CorrelationEngine::queueRow(const QVector<double> &x, double weight)
+{
+    m_queue.append(x);
+    m_queueWeight.append(weight);
+}
+
+// Applies decay and all queued rows as one rank-k update of the upper triangle, tile by tile, so
+// each tile of the matrix is loaded once per flush whatever the number of queued rows.
+void CorrelationEngine::flush() const
+{
+    if (m_queue.isEmpty()) return;
+    const int n = m_n;
+    const int k = m_queue.size();
+    const double decay = m_queueDecay;
+
+    double addWeight = 0.0;
+    for (int r = 0; r < k; ++r) addWeight += m_queueWeight[r];
+    m_weight = decay * m_weight + addWeight;
+    for (int i = 0; i < n; ++i) {
+        double s = decay * m_sum[i];
+        for (int r = 0; r < k; ++r) s += m_queueWeight[r] * m_queue[r][i];
+        m_sum[i] = s;
+    }
+
+    double *c = m_cross.data();
+    for (int i0 = 0; i0 < n; i0 += kTile) {
+        const int i1 = qMin(n, i0 + kTile);
+        for (int j0 = i0; j0 < n; j0 += kTile) {
+            const int j1 = qMin(n, j0 + kTile);
+            if (decay != 1.0) {
+                for (int i = i0; i < i1; ++i)
+                    for (int j = qMax(i, j0); j < j1; ++j) c[i * n + j] *= decay;
+            }
+            for (int r = 0; r < k; ++r) {
+                const double *x = m_queue[r].constData();
+                const double w = m_queueWeight[r];
+                for (int i = i0; i < i1; ++i) {
+                    const double a = w * x[i];
+                    double *row = c + i * n;
+#pragma omp simd
+                    for (int j = qMax(i, j0); j < j1; ++j) row[j] += a * x[j];
+                }
+            }
+        }
+    }
+
+    m_queue.clear();
+    m_queueWeight.clear();
+    m_queueDecay = 1.0;
+}
+
+void CorrelationEngine::rebuildWindow()
+{
+    m_sinceRebuild = 0;
+    m_queue = m_window;
+    m_queueWeight.fill(1.0, m_window.size());
+    m_queueDecay = 0.0;
+    flush();
+}
+
+// ---------- reads ----------
+double CorrelationEngine::covariance(int i, int j) const
+{
+    if (i < 0 || j < 0 || i >= m_n || j >= m_n || m_rows < 2) return kNaN;
+    flush();
+    if (!(m_weight > 0.0)) return kNaN;
+    const double mi = m_sum[i] / m_weight;
+    const double mj = m_sum[j] / m_weight;
+    return cross(i, j) / m_weight - mi * mj;
+}
+
+double CorrelationEngine::correlation(int i, int j) const
+{
+    const double cov = covariance(i, j);
+    const double vi = covariance(i, i);
+    const double vj = covariance(j, j);
+    if (!qIsFinite(cov) || !(vi > 0.0) || !(vj > 0.0)) return kNaN;
+    return qBound(-1.0, cov / qSqrt(vi * vj), 1.0);
+}
+
+double CorrelationEngine::beta(int i, int j) const
+{
+    const double cov = covariance(i, j);
+    const double vj = covariance(j, j);
+    return (qIsFinite(cov) && vj > 0.0) ? cov / vj : kNaN;
+}
+
+double CorrelationEngine::spread(int i, int j) const
+{
+    const double b = beta(i, j);
+    if (!qIsFinite(b) || !(m_lastClose.value(i) > 0.0) || !(m_lastClose.value(j) > 0.0)) return kNaN;
+    return qLn(m_lastClose[i]) - b * qLn(m_lastClose[j]);
+}
+
+QVector<double> CorrelationEngine::correlationMatrix() const
+{
+    QVector<double> out(m_n * m_n, kNaN);
+    if (m_rows < 2) return out;
+    flush();
+    if (!(m_weight > 0.0)) return out;
+
+    QVector<double> sd(m_n);
+    for (int i = 0; i < m_n; ++i) {
+        const double m = m_sum[i] / m_weight;
+        const double v = cross(i, i) / m_weight - m * m;
+        sd[i] = v > 0.0 ? qSqrt(v) : kNaN;
+    }
+    for (int i = 0; i < m_n; ++i) {
+        const double mi = m_sum[i] / m_weight;
+        for (int j = i; j < m_n; ++j) {
+            const double cov = cross(i, j) / m_weight - mi * m_sum[j] / m_weight;
+            if (!qIsFinite(sd[i]) || !qIsFinite(sd[j])) continue;
+            out[i * m_n + j] = out[j * m_n + i] = (i == j) ? 1.0 : qBound(-1.0, cov / (sd[i] * sd[j]), 1.0);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,82 @@
+#ifndef CORRELATIONENGINE_H
+#define CORRELATIONENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDateTime>
+#include <limits>
+
+// Rolling co-moments of log returns across a set of instruments (e.g. NIFTY, BANKNIFTY and
+// their futures), giving correlation, covariance, beta/hedge ratio and spread per pair.
+//
+// Bars arrive per instrument; a return row is committed once every instrument has a bar for
+// the same timestamp. Each row updates the raw moments (sum x, sum x x^T) in O(1) per pair:
+//   - Exponential: S <- lambda * S + (1 - lambda) * x x^T   (lengthBars = half-life)
+//   - Window:      S <- S + x_new x_new^T - x_old x_old^T   (lengthBars = window)
+// For larger sets (blockThreshold instruments or more) rows are queued and applied as one
+// rank-k update in cache-sized tiles, so the n x n matrix is streamed once per block of rows
+// rather than once per row. Reads flush any queued rows first.
+class CorrelationEngine
+{
+public:
+    enum class Mode { Exponential, Window };
+
+    explicit CorrelationEngine(Mode mode = Mode::Exponential, int lengthBars = 60,
+                               int blockThreshold = 24, int blockRows = 16);
+
+    void setInstruments(const QStringList &tokens); // resets all state
+    QStringList instruments() const { return m_tokens; }
+    int indexOf(const QString &token) const { return m_index.value(token, -1); }
+    int rowsSeen() const { return m_rows; }
+
+    // Streaming input. Bars older than the instrument's last bar are ignored.
+    void addBar(const QString &token, const QDateTime &timestamp, double close);
+    qint64 lastBarMsecs(int i) const { return m_lastBarMs.value(i, std::numeric_limits<qint64>::min()); }
+
+    double covariance(int i, int j) const;
+    double correlation(int i, int j) const;
+    // Beta of i on j (hedge ratio: units of j's return per unit of i's).
+    double beta(int i, int j) const;
+    // ln(P_i) - beta(i, j) * ln(P_j) at the latest committed prices.
+    double spread(int i, int j) const;
+    QVector<double> correlationMatrix() const; // row-major n x n
+
+private:
+    struct Pending { int count = 0; QVector<double> close; };
+
+    void commitRow(const QVector<double> &x);
+    void queueRow(const QVector<double> &x, double weight);
+    void flush() const;
+    void rebuildWindow();
+    double cross(int i, int j) const { return i <= j ? m_cross[i * m_n + j] : m_cross[j * m_n + i]; }
+
+    Mode m_mode;
+    int m_length;
+    double m_lambda;
+    int m_blockThreshold;
+    int m_blockRows;
+
+    QStringList m_tokens;
+    QHash<QString, int> m_index;
+    int m_n = 0;
+    int m_rows = 0;
+    int m_sinceRebuild = 0;
+
+    QVector<double> m_lastClose;        // latest committed close per instrument
+    QVector<qint64> m_lastBarMs;        // latest bar seen per instrument
+    QMap<qint64, Pending> m_pending;    // timestamp -> closes collected so far (newest few only)
+    QVector<QVector<double>> m_window;  // Window mode: committed rows, oldest first
+
+    // Moments are mutable so const reads can flush queued rows.
+    mutable QVector<double> m_sum;      // n
+    mutable QVector<double> m_cross;    // n x n row-major, upper triangle used
+    mutable double m_weight = 0.0;      // total weight (rows in Window mode, ~1 in Exponential)
+    mutable QVector<QVector<double>> m_queue;   // rows awaiting a blocked update
+    mutable QVector<double> m_queueWeight;      // their weights (negative = leaving the window)
+    mutable double m_queueDecay = 1.0;          // lambda^k to apply before the queued rows
+};
+
+#endif // CORRELATIONENGINE_H
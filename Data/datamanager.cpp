@@ -12,11 +12,17 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <utility>
 #include <QJsonValue>
 #include <QVariant>
 #include <QSet>
 #include <QStringConverter>
 #include "Utils/ta_simple.h"
+#include "Utils/realizedvol.h"
+#include "Utils/logger.h"
+#include "Utils/latencymonitor.h"
+#include "Utils/tracer.h"
+#include "Utils/configurationmanager.h"
 
 // ---------- static ----------
 DataManager* DataManager::m_instance = nullptr;
@@ -30,25 +36,45 @@ static double calculateStdDevInternal(const QVector<double>& values) {
     const double sd  = var > 0 ? qSqrt(var) : 0.0;
     return qIsNaN(sd) ? 0.0 : sd;
 }
-static double calculateLogReturnVolatilityInternal(const QVector<double>& closes) {
-    if (closes.size() < 2) return 0.0;
-    QVector<double> lr; lr.reserve(closes.size() - 1);
-    for (int i = 1; i < closes.size(); ++i) {
-        const double p = closes[i], pp = closes[i-1];
-        if (p <= std::numeric_limits<double>::epsilon() ||
-            pp <= std::numeric_limits<double>::epsilon()) {
-            return std::numeric_limits<double>::quiet_NaN();
+
+// Merges a fetched batch into a sorted, de-duplicated series. Fetched bars replace stored bars
+// with the same timestamp (a still-forming candle gets revised). Returns the timestamp of the
+// earliest bar added or changed, or an invalid QDateTime when the batch changes nothing.
+static QDateTime mergeCandles(QVector<CandleData> &dst, QVector<CandleData> batch) {
+    auto byTime = [](const CandleData& a, const CandleData& b){ return a.timestamp < b.timestamp; };
+    std::stable_sort(batch.begin(), batch.end(), byTime);
+
+    // Common case: a refresh that only extends the series.
+    if (dst.isEmpty() || batch.first().timestamp > dst.last().timestamp) {
+        for (const auto& c : batch)
+            if (dst.isEmpty() || c.timestamp != dst.last().timestamp) dst.append(c);
+            else dst.last() = c;
+        return batch.first().timestamp;
+    }
+
+    QDateTime earliest;
+    QVector<CandleData> added;
+    for (const auto& c : batch) {
+        auto it = std::lower_bound(dst.begin(), dst.end(), c, byTime);
+        if (it != dst.end() && it->timestamp == c.timestamp) {
+            if (it->open != c.open || it->high != c.high || it->low != c.low ||
+                it->close != c.close || it->volume != c.volume) {
+                *it = c;
+                if (!earliest.isValid()) earliest = c.timestamp;  // batch is sorted
+            }
+        } else if (!added.isEmpty() && added.last().timestamp == c.timestamp) {
+            added.last() = c;
+        } else {
+            added.append(c);
         }
-        lr.append(qLn(p/pp));
     }
-    if (lr.isEmpty()) return 0.0;
-    const double sd = calculateStdDevInternal(lr);
-    return qIsNaN(sd) ? std::numeric_limits<double>::quiet_NaN() : sd;
-}
-static double calculateHistoricalVolatility(const QVector<double>& closes, int lookback) {
-    if (lookback < 1 || closes.size() < lookback + 1) return 0.0;
-    const auto recent = closes.sliced(closes.size() - (lookback + 1));
-    return calculateLogReturnVolatilityInternal(recent);
+    if (!added.isEmpty()) {
+        const int mid = dst.size();
+        dst += added;
+        std::inplace_merge(dst.begin(), dst.begin() + mid, dst.end(), byTime);
+        if (!earliest.isValid() || added.first().timestamp < earliest) earliest = added.first().timestamp;
+    }
+    return earliest;
 }
 
 // ---------- singleton ----------
@@ -59,6 +85,7 @@ DataManager* DataManager::instance() {
 
 DataManager::DataManager(QObject *parent)
     : QObject(parent)
+    , m_correlation(CorrelationEngine::Mode::Exponential, 75) // half-life of one session of 5-min bars
 {
     // Seed the two indices so the UI has them immediately
     InstrumentData nifty50;
@@ -85,6 +112,8 @@ DataManager::DataManager(QObject *parent)
     banknifty.lotSize         = 1;
     m_instruments.insert(banknifty.instrumentToken, banknifty);
 
+    loadSignalDefinitions();
+
     qInfo() << "DataManager initialized. Added NIFTY 50 and NIFTY BANK indices.";
 }
 
@@ -96,6 +125,10 @@ DataManager::~DataManager() {
 InstrumentData DataManager::getInstrument(const QString &instrumentToken) const {
     return m_instruments.value(instrumentToken, InstrumentData());
 }
+bool DataManager::isContinuousHistory(const QString &instrumentToken) const {
+    const auto it = m_instruments.constFind(instrumentToken);
+    return it != m_instruments.constEnd() && it->continuousHistory;
+}
 QHash<QString, InstrumentData> DataManager::getAllInstruments() const {
     return m_instruments;
 }
@@ -106,6 +139,39 @@ QVector<CandleData> DataManager::getStoredHistoricalData(const QString &instrume
 InstrumentAnalytics DataManager::getInstrumentAnalytics(const QString &instrumentToken) const {
     return m_instrumentAnalyticsMap.value(instrumentToken, InstrumentAnalytics());
 }
+quint64 DataManager::seriesVersion(const QString &instrumentToken, const QString &interval) const {
+    return m_seriesVersions.value(instrumentToken).value(interval, 0);
+}
+TA::RealizedVol DataManager::getRealizedVolatility(const QString &instrumentToken) const {
+    return m_realizedVolMap.value(instrumentToken);
+}
+PriceLadder DataManager::getPriceLadder(const QString &instrumentToken) const {
+    return m_priceLadders.value(instrumentToken);
+}
+VolumeProfile DataManager::getVolumeProfile(const QString &instrumentToken, const QDate &session) const {
+    const auto it = m_volumeProfiles.constFind(instrumentToken);
+    if (it == m_volumeProfiles.constEnd() || it->isEmpty()) return VolumeProfile();
+    return session.isValid() ? it->value(session) : it->last();
+}
+IntradaySeasonality DataManager::getIntradaySeasonality(const QString &instrumentToken) const {
+    return m_seasonality.value(instrumentToken);
+}
+double DataManager::relativeVolume(const QString &instrumentToken, const QTime &time, qlonglong slotVolume) const {
+    const auto it = m_seasonality.constFind(instrumentToken);
+    if (it == m_seasonality.constEnd()) return std::numeric_limits<double>::quiet_NaN();
+    return it->rvol(it->slotFor(time), double(slotVolume));
+}
+CorrelationEngine DataManager::getCorrelationEngine() const {
+    return m_correlation;
+}
+VolumeProfile DataManager::compositeVolumeProfile(const QString &instrumentToken, int sessions) const {
+    const auto it = m_volumeProfiles.constFind(instrumentToken);
+    if (it == m_volumeProfiles.constEnd() || it->isEmpty() || sessions <= 0) return VolumeProfile();
+    auto p = it->constEnd();
+    VolumeProfile composite = *(--p);
+    for (int k = 1; k < sessions && p != it->constBegin(); ++k) composite.merge(*(--p));
+    return composite;
+}
 
 // ---------- expiry helpers (public, read-only) ----------
 QDate DataManager::nearestWeeklyExpiry(const QString& underlying, const QDate& fromDate) const {
@@ -198,6 +264,14 @@ QString DataManager::currentMonthFutureToken(const QString& underlying) const
 }
 
 // ---------- instruments load path ----------
+// accept only NIFTY/BANKNIFTY derivatives (avoid NIFTY NEXT 50 etc.)
+static QString niftyOrBank(const InstrumentData &d) {
+    const QString base = d.name.trimmed().toUpper();
+    if (base == "NIFTY")     return "NIFTY";
+    if (base == "BANKNIFTY") return "BANKNIFTY";
+    return {};
+}
+
 void DataManager::loadInstrumentsFromFile(const QString &filename)
 {
     qDebug() << "DataManager::loadInstrumentsFromFile:" << filename;
@@ -208,29 +282,17 @@ void DataManager::loadInstrumentsFromFile(const QString &filename)
         emit errorOccurred("loadInstrumentsFromFile", "Cannot open " + filename);
         return;
     }
+    const QByteArray csv = file.readAll();
+    file.close();
+    loadInstruments(parseInstrumentsCsv(csv));
+}
 
-    // 1) Clear previous NFO rows (keep indices)
-    {
-        int removed = 0;
-        for (auto it = m_instruments.begin(); it != m_instruments.end(); ) {
-            const auto &inst = it.value();
-            if (inst.segment.startsWith("NFO")) { it = m_instruments.erase(it); ++removed; }
-            else { ++it; }
-        }
-        qDebug() << "Cleared previous NFO instruments:" << removed;
-    }
-
-    QTextStream in(&file);
+QVector<InstrumentData> DataManager::parseInstrumentsCsv(const QByteArray &csv)
+{
+    TRACE_ZONE("data", "DataManager::parseInstrumentsCsv");
+    QTextStream in(csv);
     QString header = in.readLine(); Q_UNUSED(header);
-    int linesRead = 0, parsed = 0;
-
-    // accept only NIFTY/BANKNIFTY derivatives (avoid NIFTY NEXT 50 etc.)
-    auto isNiftyOrBank = [](const InstrumentData &d) -> QString {
-        const QString base = d.name.trimmed().toUpper();
-        if (base == "NIFTY")     return "NIFTY";
-        if (base == "BANKNIFTY") return "BANKNIFTY";
-        return {};
-    };
+    int linesRead = 0;
 
     QVector<InstrumentData> candidates; candidates.reserve(200000);
 
@@ -246,21 +308,29 @@ void DataManager::loadInstrumentsFromFile(const QString &filename)
             continue; // strict on bad expiry rows
         }
 
+        // keep indices as-is (already present); only NIFTY/BANKNIFTY derivatives are candidates
         const bool isDeriv = (d.segment == "NFO-OPT" || d.segment == "NFO-FUT");
-        if (isDeriv) {
-            const QString u = isNiftyOrBank(d);
-            if (!u.isEmpty()) {
-                candidates.push_back(d);
-                ++parsed;
-            }
-        } else {
-            // keep indices as-is (already present), do nothing here
-        }
+        if (isDeriv && !niftyOrBank(d).isEmpty()) candidates.push_back(d);
     }
-    file.close();
+    candidates.squeeze();
 
     qDebug().noquote() << QString("Finished reading %1 lines, parsed %2 NFO candidates.")
-                              .arg(linesRead).arg(parsed);
+                              .arg(linesRead).arg(candidates.size());
+    return candidates;
+}
+
+void DataManager::loadInstruments(const QVector<InstrumentData> &candidates)
+{
+    // 1) Clear previous NFO rows (keep indices)
+    {
+        int removed = 0;
+        for (auto it = m_instruments.begin(); it != m_instruments.end(); ) {
+            const auto &inst = it.value();
+            if (inst.segment.startsWith("NFO")) { it = m_instruments.erase(it); ++removed; }
+            else { ++it; }
+        }
+        qDebug() << "Cleared previous NFO instruments:" << removed;
+    }
 
     if (candidates.isEmpty()) {
         qWarning() << "No NIFTY/BANKNIFTY NFO rows found. Aborting.";
@@ -287,7 +357,7 @@ void DataManager::loadInstrumentsFromFile(const QString &filename)
 
     // 3) Prune everything else (keep: NIFTY/BANKNIFTY OPT for weekly or monthly, FUT only monthly)
     auto shouldKeep = [&](const InstrumentData &d) -> bool {
-        const QString base = isNiftyOrBank(d);
+        const QString base = niftyOrBank(d);
         if (base.isEmpty()) return false;
 
         if (d.segment == "NFO-OPT") {
@@ -370,6 +440,7 @@ InstrumentData DataManager::parseInstrumentCSVLine(const QString &line) {
             qWarning() << "Invalid expiry date:" << d.expiry << "for" << d.tradingSymbol;
         }
     }
+    d.continuousHistory = (d.segment == "NFO-FUT" || d.segment == "NFO-OPT");
     return d;
 }
 
@@ -412,7 +483,7 @@ void DataManager::saveParsedInstrumentsToFile() {
 void DataManager::requestHistoricalData(const QString &instrumentToken,
                                         const QString &interval)
 {
-    qDebug() << "requestHistoricalData:" << instrumentToken << interval;
+    LOG_DEBUG("requestHistoricalData: {} {}", instrumentToken, interval);
 
     const QDate today = QDate::currentDate();
     const QTime tOpen(9, 15, 0);
@@ -426,7 +497,6 @@ void DataManager::requestHistoricalData(const QString &instrumentToken,
 
         // daily needs ~250 bars → ~400 calendar days
         from = today.addDays(-400);
-        qDebug() << "Requesting ~18 months daily data...";
 
     }
     else if (interval.compare("5minute", Qt::CaseInsensitive) == 0)
@@ -442,47 +512,20 @@ void DataManager::requestHistoricalData(const QString &instrumentToken,
     const QString fromStr = QDateTime(from,  tOpen ).toString("yyyy-MM-dd+HH:mm:ss");
     const QString toStr   = QDateTime(today, tClose).toString("yyyy-MM-dd+HH:mm:ss");
 
-    qDebug() << "Historical from:" << fromStr << "to:" << toStr;
+    LOG_DEBUG("Historical from: {} to: {}", fromStr, toStr);
     emit fetchHistoricalDataRequested(instrumentToken, interval, fromStr, toStr);
 }
 
+// Candles arrive already decoded (KiteConnectAPI parses them on the network thread)
 void DataManager::onHistoricalDataReceived(const QString &instrumentToken,
                                            const QString &interval,
-                                           const QJsonArray &candles)
+                                           const QVector<CandleData> &candles)
 {
-    qDebug() << "onHistoricalDataReceived:" << instrumentToken << interval
-             << "count:" << candles.size();
-    if (candles.isEmpty()) return;
-
-    QVector<CandleData> vec; vec.reserve(candles.size());
-    for (const QJsonValue &v : candles) {
-        if (!v.isArray()) continue;
-        const QJsonArray c = v.toArray();
-        if (c.size() < 6) continue; // ts,o,h,l,c,v
-
-        CandleData d;
-        d.timestamp = QDateTime::fromString(c[0].toString(), Qt::ISODateWithMs);
-        if (!d.timestamp.isValid())
-            d.timestamp = QDateTime::fromString(c[0].toString(), Qt::ISODate);
-        if (!d.timestamp.isValid()) continue;
-
-        if (!c[1].isDouble() || !c[2].isDouble() || !c[3].isDouble() || !c[4].isDouble())
-            continue;
-
-        d.open  = c[1].toDouble();
-        d.high  = c[2].toDouble();
-        d.low   = c[3].toDouble();
-        d.close = c[4].toDouble();
-
-        bool volOk = false;
-        d.volume = c[5].toVariant().toLongLong(&volOk);
-        if (!volOk) continue;
-
-        vec.append(d);
-    }
-
-    if (!vec.isEmpty()) {
-        storeHistoricalData(instrumentToken, interval, vec);
+    TRACE_ZONE("data", "DataManager::onHistoricalDataReceived");
+    TRACE_FLOW_END("http", "request", Tracer::currentFlow());
+    LOG_DEBUG("onHistoricalDataReceived: {} {} count: {}", instrumentToken, interval, candles.size());
+    if (!candles.isEmpty()) {
+        storeHistoricalData(instrumentToken, interval, candles);
     }
 }
 
@@ -493,24 +536,31 @@ void DataManager::storeHistoricalData(const QString &instrumentToken,
 {
     if (newData.isEmpty()) return;
 
+    TRACE_ZONE("data", "DataManager::storeHistoricalData");
+    LATENCY_SCOPE("store.total");
     QVector<CandleData> &dst = m_historicalDataMap[instrumentToken][interval];
-    dst += newData;
-
-    // sort by timestamp & dedup on timestamp
-    std::sort(dst.begin(), dst.end(),
-              [](const CandleData& a, const CandleData& b){ return a.timestamp < b.timestamp; });
-    auto last = std::unique(dst.begin(), dst.end(),
-                            [](const CandleData& a, const CandleData& b){ return a.timestamp == b.timestamp; });
-    dst.erase(last, dst.end());
+    QDateTime changedFrom;
+    {
+        LATENCY_SCOPE("store.merge");
+        changedFrom = mergeCandles(dst, newData);
+    }
+    // Nothing new: analytics, engines and listeners are already up to date.
+    if (!changedFrom.isValid()) return;
+    ++m_seriesVersions[instrumentToken][interval];
 
     if (interval.compare("day", Qt::CaseInsensitive) == 0) {
         calculateDailyAnalytics(instrumentToken);
     } else if (interval.compare("5minute", Qt::CaseInsensitive) == 0) {
-        calculate5MinAnalytics(instrumentToken);
+        calculate5MinAnalytics(instrumentToken, changedFrom);
+        updateVolumeProfiles(instrumentToken, dst, changedFrom);
+        updateSeasonality(instrumentToken, dst);
+        updateCorrelation(instrumentToken, dst);
+        updateSignals(instrumentToken, dst, changedFrom);
 
         // For futures only, compute previous-day VWAP stats
         const auto inst = getInstrument(instrumentToken);
         if (inst.segment == "NFO-FUT") {
+            updateVwapEngine(instrumentToken, dst, changedFrom);
             calculatePreviousDayVWAPStats(instrumentToken);
         }
     }
@@ -554,14 +604,39 @@ void DataManager::calculateDailyAnalytics(const QString &instrumentToken) {
     if (!m_historicalDataMap.contains(instrumentToken) ||
         !m_historicalDataMap.value(instrumentToken).contains("day")) {
         m_instrumentAnalyticsMap.remove(instrumentToken);
+        m_realizedVolMap.remove(instrumentToken);
         return;
     }
     const auto& daily = m_historicalDataMap[instrumentToken]["day"];
     const int n = daily.size();
     const QString name = getInstrument(instrumentToken).tradingSymbol;
 
+    // Only called when the daily series changed (storeHistoricalData skips no-op merges)
+    const auto prev = m_instrumentAnalyticsMap.constFind(instrumentToken);
+    TRACE_ZONE("analytics", "analytics.daily");
+    LATENCY_SCOPE("analytics.daily");
+
     InstrumentAnalytics a;
+    if (prev != m_instrumentAnalyticsMap.constEnd()) {
+        // Intraday fields are owned by the 5-minute path, which now only reruns when its series
+        // changes, so they must survive a daily recompute.
+        a.ema21_5Min = prev->ema21_5Min;
+        a.ema21_5Min_Calculated = prev->ema21_5Min_Calculated;
+        a.atr14_5Min = prev->atr14_5Min;
+        a.adx14_5Min = prev->adx14_5Min;
+        a.supertrend_5Min = prev->supertrend_5Min;
+        a.supertrendDir_5Min = prev->supertrendDir_5Min;
+        a.rangeIndicators_5Min_Calculated = prev->rangeIndicators_5Min_Calculated;
+        a.prevDayVWAP_High = prev->prevDayVWAP_High;
+        a.prevDayVWAP_Low = prev->prevDayVWAP_Low;
+        a.prevDayVWAP_Close = prev->prevDayVWAP_Close;
+        a.prevDayVWAP_Stats_Calculated = prev->prevDayVWAP_Stats_Calculated;
+        a.fiveMinSeriesVersion = prev->fiveMinSeriesVersion;
+        a.fiveMinLastBar = prev->fiveMinLastBar;
+    }
     a.lastCalculationTime = QDateTime::currentDateTime();
+    a.dailySeriesVersion = seriesVersion(instrumentToken, "day");
+    if (n > 0) a.dailyLastBar = daily.last().timestamp;
     if (n < 1) { m_instrumentAnalyticsMap[instrumentToken] = a; return; }
 
     a.prevDayClose = daily.last().close;
@@ -569,12 +644,16 @@ void DataManager::calculateDailyAnalytics(const QString &instrumentToken) {
     QVector<double> closes; closes.reserve(n);
     for (const auto& c : daily) closes.append(c.close);
 
+    // One pass builds prefix sums for every estimator; each lookback below is O(1).
+    TA::RealizedVol &rv = m_realizedVolMap[instrumentToken];
+    rv.build(daily);
+
     if (n >= 22) {
         const QList<int> looks = {3,5,8,13,21};
         QVector<double> vols; vols.reserve(looks.size());
         bool ok = true;
         for (int L : looks) {
-            const double v = calculateHistoricalVolatility(closes, L);
+            const double v = rv.latest(TA::RealizedVol::Estimator::CloseToClose, L);
             if (qIsNaN(v)) { ok = false; break; }
             vols.append(qMax(0.0, v));
         }
@@ -596,6 +675,15 @@ void DataManager::calculateDailyAnalytics(const QString &instrumentToken) {
         }
     }
 
+    if (n >= 22) {
+        using E = TA::RealizedVol::Estimator;
+        a.parkinsonVol21      = rv.latest(E::Parkinson, 21);
+        a.garmanKlassVol21    = rv.latest(E::GarmanKlass, 21);
+        a.rogersSatchellVol21 = rv.latest(E::RogersSatchell, 21);
+        a.yangZhangVol21      = rv.latest(E::YangZhang, 21);
+        a.ohlcVolatilityCalculated = qIsFinite(a.yangZhangVol21);
+    }
+
     if (a.volatilityCalculated && a.prevDayClose > 0) {
         const double phi  = 1.618034;
         const double eff  = a.prevDayClose * a.avgVolatility;
@@ -615,85 +703,52 @@ void DataManager::calculateDailyAnalytics(const QString &instrumentToken) {
     }
 
     m_instrumentAnalyticsMap[instrumentToken] = a;
+    rebuildPriceLadder(instrumentToken);
 
 
-    const int warmup = qMax(5*21, 200);
-    const int effWarmup = qMin(warmup, closes.size());
-    qDebug() << ">>> Daily closes =" << closes.size() << "warmup(eff)=" << effWarmup;
-    auto ema21Daily = TA::ema(closes, 21, effWarmup);
-
-    double ema21DailyLast = ema21Daily.isEmpty() ? qQNaN() : ema21Daily.last();
-    qDebug() << ">>> Daily Indicators: EMA(21)=" << ema21DailyLast;
+    if constexpr (Logger::enabled(Log::Level::Debug)) {
+        // Diagnostics only: computed for the log, compiled out with it.
+        const int warmup = qMax(5*21, 200);
+        const int effWarmup = qMin(warmup, closes.size());
+        auto ema21Daily = TA::ema(closes, 21, effWarmup);
+        const double ema21DailyLast = ema21Daily.isEmpty() ? qQNaN() : ema21Daily.last();
+        LOG_DEBUG(">>> Daily closes = {} warmup(eff)= {} EMA(21)= {}", closes.size(), effWarmup, ema21DailyLast);
 
-    if (!daily.isEmpty()) {
         const auto& pd = daily.last(); // most recent completed daily bar
         const double H = pd.high, L = pd.low, C = pd.close;
         const double range = H - L;
 
-
         // --- Classic ---
         const double P  = (H + L + C) / 3.0;
-        const double R1 = 2*P - L;
-        const double S1 = 2*P - H;
-        const double R2 = P + range;
-        const double S2 = P - range;
-        const double R3 = H + 2*(P - L);
-        const double S3 = L - 2*(H - P);
-
-        qDebug() << ">>> Daily Pivots (Classic):"
-                 << "P=" << P << "R1=" << R1 << "R2=" << R2 << "R3=" << R3
-                 << "S1=" << S1 << "S2=" << S2 << "S3=" << S3;
-
+        LOG_DEBUG(">>> Daily Pivots (Classic): P= {:.2f} R1= {:.2f} R2= {:.2f} R3= {:.2f} S1= {:.2f} S2= {:.2f} S3= {:.2f}",
+                  P, 2*P - L, P + range, H + 2*(P - L), 2*P - H, P - range, L - 2*(H - P));
         // --- Fibonacci (R1..R3 / S1..S3) ---
-        const double R1F = P + 0.382*range;
-        const double R2F = P + 0.618*range;
-        const double R3F = P + 1.000*range;
-        const double S1F = P - 0.382*range;
-        const double S2F = P - 0.618*range;
-        const double S3F = P - 1.000*range;
-
-        qDebug() << ">>> Daily Pivots (Fibo):"
-                 << "R1=" << R1F << "R2=" << R2F << "R3=" << R3F
-                 << "S1=" << S1F << "S2=" << S2F << "S3=" << S3F;
-
+        LOG_DEBUG(">>> Daily Pivots (Fibo): R1= {:.2f} R2= {:.2f} R3= {:.2f} S1= {:.2f} S2= {:.2f} S3= {:.2f}",
+                  P + 0.382*range, P + 0.618*range, P + range, P - 0.382*range, P - 0.618*range, P - range);
         // --- Camarilla (H3/H4/L3/L4 core levels; we can extend to H1..H8 later) ---
-        const double H3 = C + (range * 1.1 / 3.0);
-        const double H4 = C + (range * 1.1 / 2.0);
-        const double L3 = C - (range * 1.1 / 3.0);
-        const double L4 = C - (range * 1.1 / 2.0);
-
-        qDebug() << ">>> Daily Pivots (Camarilla):"
-                 << "H3=" << H3 << "H4=" << H4 << "L3=" << L3 << "L4=" << L4;
-    } else {
-        qDebug() << ">>> Daily Pivots: insufficient bars";
+        LOG_DEBUG(">>> Daily Pivots (Camarilla): H3= {:.2f} H4= {:.2f} L3= {:.2f} L4= {:.2f}",
+                  C + (range * 1.1 / 3.0), C + (range * 1.1 / 2.0), C - (range * 1.1 / 3.0), C - (range * 1.1 / 2.0));
     }
 
-    // friendly console summary
-    qInfo().noquote() << QString("=== Daily Analytics Updated: %1 (%2) ===")
-                             .arg(name.isEmpty() ? instrumentToken : name)
-                             .arg(instrumentToken);
+    // friendly summary
+    LOG_INFO("=== Daily Analytics Updated: {} ({}) ===", name.isEmpty() ? instrumentToken : name, instrumentToken);
     if (a.volatilityCalculated)
-        qInfo().noquote() << QString("  Volatility (Avg/Min/Max): %1 / %2 / %3")
-                                 .arg(a.avgVolatility, 0, 'g', 5)
-                                 .arg(a.minPeriodVolatility, 0, 'g', 5)
-                                 .arg(a.maxPeriodVolatility, 0, 'g', 5);
+        LOG_INFO("  Volatility (Avg/Min/Max): {} / {} / {}",
+                 a.avgVolatility, a.minPeriodVolatility, a.maxPeriodVolatility);
+    if (a.ohlcVolatilityCalculated)
+        LOG_INFO("  Volatility 21D (PK/GK/RS/YZ): {} / {} / {} / {}",
+                 a.parkinsonVol21, a.garmanKlassVol21, a.rogersSatchellVol21, a.yangZhangVol21);
     if (a.rangeBands_PC_Calculated)
-        qInfo().noquote() << QString("  Range (PrevCl=%1): L=%2 U=%3")
-                                 .arg(a.prevDayClose, 0, 'f', 2)
-                                 .arg(a.rangeLowerBand_PC, 0, 'f', 2)
-                                 .arg(a.rangeUpperBand_PC, 0, 'f', 2);
+        LOG_INFO("  Range (PrevCl={:.2f}): L={:.2f} U={:.2f}", a.prevDayClose, a.rangeLowerBand_PC, a.rangeUpperBand_PC);
     if (a.swing_7D_Calculated)
-        qInfo().noquote() << QString("  Swing 7D (L/H): %1 / %2")
-                                 .arg(a.low_7D, 0, 'f', 2).arg(a.high_7D, 0, 'f', 2);
+        LOG_INFO("  Swing 7D (L/H): {:.2f} / {:.2f}", a.low_7D, a.high_7D);
     if (a.swing_21D_Calculated)
-        qInfo().noquote() << QString("  Swing 21D (L/H): %1 / %2")
-                                 .arg(a.low_21D, 0, 'f', 2).arg(a.high_21D, 0, 'f', 2);
+        LOG_INFO("  Swing 21D (L/H): {:.2f} / {:.2f}", a.low_21D, a.high_21D);
     if (a.ema21_Daily_Calculated)
-        qInfo().noquote() << QString("  Daily EMA(21): %1").arg(a.ema21_Daily, 0, 'f', 2);
-    qInfo() << "==================================================";
+        LOG_INFO("  Daily EMA(21): {:.2f}", a.ema21_Daily);
 }
 
-void DataManager::calculate5MinAnalytics(const QString &instrumentToken) {
+void DataManager::calculate5MinAnalytics(const QString &instrumentToken, const QDateTime &changedFrom) {
     if (!m_historicalDataMap.contains(instrumentToken) ||
         !m_historicalDataMap.value(instrumentToken).contains("5minute")) {
         return;
@@ -703,8 +758,13 @@ void DataManager::calculate5MinAnalytics(const QString &instrumentToken) {
     QString name = getInstrument(instrumentToken).tradingSymbol;
     if (name.isEmpty()) name = instrumentToken;
 
+    // Only called when the 5-minute series changed (storeHistoricalData skips no-op merges)
     auto a = m_instrumentAnalyticsMap.value(instrumentToken);
+    TRACE_ZONE("analytics", "analytics.5min");
+    LATENCY_SCOPE("analytics.5min");
     a.lastCalculationTime = QDateTime::currentDateTime();
+    a.fiveMinSeriesVersion = seriesVersion(instrumentToken, "5minute");
+    a.fiveMinLastBar = n > 0 ? five.last().timestamp : QDateTime();
 
     if (n >= 21) {
         QVector<double> closes; closes.reserve(n);
@@ -712,43 +772,62 @@ void DataManager::calculate5MinAnalytics(const QString &instrumentToken) {
         a.ema21_5Min = calculateEMA(closes, 21);
         a.ema21_5Min_Calculated = !qIsNaN(a.ema21_5Min) && a.ema21_5Min != 0.0;
 
-        // Warmup policy you approved: max(5×period, 200)
-        const int warmup = qMax(5*21, 200);
-        const int effWarmup = qMin(warmup, closes.size());
-        qDebug() << ">>> 5min closes =" << closes.size() << "warmup(eff)=" << effWarmup;
-        auto ema21Series = TA::ema(closes, 21, effWarmup);
-
-        double ema21Last = ema21Series.isEmpty() ? qQNaN() : ema21Series.last();
-        qDebug() << ">>> 5-Min Indicators: EMA(21)=" << ema21Last;
-
-
-        const int bbWarmup = qMax(5*21, 200);
-        auto bb = TA::bollinger(closes, 21, 2.0, qMin(bbWarmup, closes.size()));
-        if (!bb.upper.isEmpty() && !bb.mid.isEmpty() && !bb.lower.isEmpty()) {
-            qDebug() << ">>> 5-Min BB(21,2):"
-                     << "U=" << bb.upper.last()
-                     << "M=" << bb.mid.last()
-                     << "L=" << bb.lower.last();
-        } else {
-            qDebug() << ">>> 5-Min BB(20,2): insufficient bars";
+        if constexpr (Logger::enabled(Log::Level::Debug)) {
+            // Diagnostics only: computed for the log, compiled out with it.
+            QVector<double> highs; highs.reserve(n);
+            QVector<double> lows;  lows.reserve(n);
+            for (const auto& c : five) { highs.push_back(c.high); lows.push_back(c.low); }
+
+            // Warmup policy you approved: max(5×period, 200)
+            const int warmup = qMax(5*21, 200);
+            const int effWarmup = qMin(warmup, closes.size());
+            auto ema21Series = TA::ema(closes, 21, effWarmup);
+            const double ema21Last = ema21Series.isEmpty() ? qQNaN() : ema21Series.last();
+            LOG_DEBUG(">>> 5min closes = {} warmup(eff)= {} EMA(21)= {}", closes.size(), effWarmup, ema21Last);
+
+            auto bb = TA::bollinger(closes, 21, 2.0, qMin(warmup, closes.size()));
+            if (!bb.upper.isEmpty() && !bb.mid.isEmpty() && !bb.lower.isEmpty())
+                LOG_DEBUG(">>> 5-Min BB(21,2): U= {} M= {} L= {}", bb.upper.last(), bb.mid.last(), bb.lower.last());
+            else
+                LOG_DEBUG(">>> 5-Min BB(21,2): insufficient bars");
+
+            const int stWarmup = qMax(5*14, 200);
+            auto st = TA::stochastics(highs, lows, closes,
+                                      /*kPeriod*/14, /*kSmooth*/3, /*dPeriod*/3,
+                                      qMin(stWarmup, closes.size()));
+            if (!st.k.isEmpty() && !st.d.isEmpty())
+                LOG_DEBUG(">>> 5-Min Stoch(14,3,3): %K= {} %D= {}", st.k.last(), st.d.last());
+            else
+                LOG_DEBUG(">>> 5-Min Stoch: insufficient bars");
         }
 
-        // Build highs/lows once from the same 5-min candles you used for 'closes'
-        QVector<double> highs; highs.reserve(n);
-        QVector<double> lows;  lows.reserve(n);
-        for (const auto& c : five) { highs.push_back(c.high); lows.push_back(c.low); }
-
-        const int stWarmup = qMax(5*14, 200);
-        auto st = TA::stochastics(highs, lows, closes,
-                                  /*kPeriod*/14, /*kSmooth*/3, /*dPeriod*/3,
-                                  qMin(stWarmup, closes.size()));
-        if (!st.k.isEmpty() && !st.d.isEmpty()) {
-            qDebug() << ">>> 5-Min Stoch(14,3,3):"
-                     << "%K=" << st.k.last()
-                     << "%D=" << st.d.last();
+        // ATR / ADX / Supertrend / Keltner, streamed. The feed holds the state through the
+        // next-to-last bar, so only bars closed since the last call are added; the last bar may
+        // still be forming and is applied to a copy. A change at or before the last closed bar
+        // replays the series.
+        RangeFeed &feed = m_rangeFeeds[instrumentToken];
+        auto it = five.cbegin();
+        if (!feed.lastClosed.isValid() || changedFrom <= feed.lastClosed) {
+            feed.closed.reset();
+            feed.lastClosed = QDateTime();
         } else {
-            qDebug() << ">>> 5-Min Stoch: insufficient bars";
+            it = std::upper_bound(five.cbegin(), five.cend(), feed.lastClosed,
+                                  [](const QDateTime& ts, const CandleData& c){ return ts < c.timestamp; });
         }
+        for (const auto end = five.cend() - 1; it < end; ++it) {
+            feed.closed.update(it->high, it->low, it->close);
+            feed.lastClosed = it->timestamp;
+        }
+        TA::RangeIndicators forming = feed.closed;
+        const TA::RangeValues rv = forming.update(five.last().high, five.last().low, five.last().close);
+        a.atr14_5Min          = rv.atr;
+        a.adx14_5Min          = rv.adx;
+        a.supertrend_5Min     = rv.supertrend;
+        a.supertrendDir_5Min  = rv.supertrendDir;
+        a.rangeIndicators_5Min_Calculated = qIsFinite(a.atr14_5Min) && a.supertrendDir_5Min != 0;
+        LOG_DEBUG(">>> 5-Min Range: ATR(14)= {} ADX(14)= {} +DI= {} -DI= {} ST(10,3)= {} dir= {} KC(20,2)= {} / {}",
+                  a.atr14_5Min, a.adx14_5Min, rv.plusDI, rv.minusDI,
+                  a.supertrend_5Min, a.supertrendDir_5Min, rv.keltnerLower, rv.keltnerUpper);
 
     } else {
         a.ema21_5Min_Calculated = false;
@@ -756,73 +835,300 @@ void DataManager::calculate5MinAnalytics(const QString &instrumentToken) {
 
     m_instrumentAnalyticsMap[instrumentToken] = a;
 
-    if (a.ema21_5Min_Calculated) {
-        qInfo().noquote() << QString(">>> 5-Min Analytics: %1 (%2) | EMA(21): %3")
-        .arg(name).arg(instrumentToken).arg(a.ema21_5Min, 0, 'f', 2);
+    if (a.ema21_5Min_Calculated)
+        LOG_INFO(">>> 5-Min Analytics: {} ({}) | EMA(21): {:.2f}", name, instrumentToken, a.ema21_5Min);
+}
+
+// Feeds only the bars the engine has not seen. The last seen bar is re-sent so a candle that
+// was still forming is replaced; only a change older than that rebuilds the engine from scratch.
+// Routine re-fetches overlap the stored days but leave those bars untouched, so they stay O(new bars).
+void DataManager::updateVwapEngine(const QString &instrumentToken,
+                                   const QVector<CandleData> &stored,
+                                   const QDateTime &changedFrom)
+{
+    TRACE_ZONE("analytics", "analytics.vwap");
+    LATENCY_SCOPE("analytics.vwap");
+    VwapEngine &engine = m_vwapEngines[instrumentToken];
+    const QDateTime last = engine.lastTimestamp();
+
+    const bool backfill = last.isValid() && changedFrom < last;
+    if (backfill) engine.reset();
+
+    auto it = stored.cbegin();
+    if (last.isValid() && !backfill) {
+        it = std::lower_bound(stored.cbegin(), stored.cend(), last,
+                              [](const CandleData& c, const QDateTime& ts){ return c.timestamp < ts; });
     }
+    for (; it != stored.cend(); ++it) engine.addBar(*it);
 }
 
 void DataManager::calculatePreviousDayVWAPStats(const QString &instrumentToken) {
-    // Need 5-min data
-    if (!m_historicalDataMap.contains(instrumentToken) ||
-        !m_historicalDataMap.value(instrumentToken).contains("5minute")) {
-        return;
-    }
-    const auto& five = m_historicalDataMap[instrumentToken]["5minute"];
-    if (five.isEmpty()) return;
+    TRACE_ZONE("analytics", "analytics.prevDayVwap");
+    LATENCY_SCOPE("analytics.prevDayVwap");
+    const auto engineIt = m_vwapEngines.constFind(instrumentToken);
+    if (engineIt == m_vwapEngines.constEnd()) return;
 
     auto* cal = MarketCalendar::instance();
     if (!cal) return;
     const QDate prevDay = cal->getPreviousTradingDay(QDate::currentDate());
     if (!prevDay.isValid()) return;
 
-    double pv = 0.0;
-    qlonglong vol = 0;
-    double vwapHigh = 0.0;
-    double vwapLow  = std::numeric_limits<double>::max();
-    double vwapClose = 0.0;
-    bool any = false;
-
-    for (const auto& c : five) {
-        if (c.timestamp.date() != prevDay) {
-            if (any && c.timestamp.date() > prevDay) break;
-            continue;
-        }
-        if (!c.timestamp.isValid() || c.volume <= 0 ||
-            c.high < c.low || c.low < 0 || c.close < 0) continue;
-
-        any = true;
-        const double tp = (c.high + c.low + c.close) / 3.0;
-        pv  += tp * c.volume;
-        vol += c.volume;
-        if (vol > 0) {
-            const double vwap = pv / vol;
-            vwapClose = vwap;
-            if (!qIsNaN(vwap) && !qIsInf(vwap)) {
-                vwapHigh = qMax(vwapHigh, vwap);
-                vwapLow  = qMin(vwapLow,  vwap);
-            }
-        }
-    }
+    const VwapStats prev = engineIt.value().session(prevDay);
+    const bool any = prev.isValid();
 
     auto a = m_instrumentAnalyticsMap.value(instrumentToken);
-    if (any && vol > 0) {
-        a.prevDayVWAP_High  = vwapHigh;
-        a.prevDayVWAP_Low   = (vwapLow == std::numeric_limits<double>::max()) ? 0.0 : vwapLow;
-        a.prevDayVWAP_Close = vwapClose;
+    if (any) {
+        a.prevDayVWAP_High  = prev.high;
+        a.prevDayVWAP_Low   = prev.low;
+        a.prevDayVWAP_Close = prev.close;
         a.prevDayVWAP_Stats_Calculated = true;
 
         QString name = getInstrument(instrumentToken).tradingSymbol;
         if (name.isEmpty()) name = instrumentToken;
-        qInfo().noquote() << QString(">>> PrevDay VWAP: %1 (%2) | H:%3 L:%4 C:%5")
-                                 .arg(name).arg(instrumentToken)
-                                 .arg(a.prevDayVWAP_High,  0, 'f', 2)
-                                 .arg(a.prevDayVWAP_Low,   0, 'f', 2)
-                                 .arg(a.prevDayVWAP_Close, 0, 'f', 2);
+        LOG_INFO(">>> PrevDay VWAP: {} ({}) | H:{:.2f} L:{:.2f} C:{:.2f}", name, instrumentToken,
+                 a.prevDayVWAP_High, a.prevDayVWAP_Low, a.prevDayVWAP_Close);
     } else {
         a.prevDayVWAP_High = a.prevDayVWAP_Low = a.prevDayVWAP_Close = 0.0;
         a.prevDayVWAP_Stats_Calculated = false;
     }
     a.lastCalculationTime = QDateTime::currentDateTime();
     m_instrumentAnalyticsMap[instrumentToken] = a;
+    rebuildPriceLadder(instrumentToken);
+}
+
+// ---------- price levels ----------
+void DataManager::rebuildPriceLadder(const QString &instrumentToken) {
+    TRACE_ZONE("analytics", "analytics.priceLadder");
+    LATENCY_SCOPE("analytics.priceLadder");
+    const auto tokenIt = m_historicalDataMap.constFind(instrumentToken);
+    CandleData prevDay;
+    if (tokenIt != m_historicalDataMap.constEnd()) {
+        const auto dailyIt = tokenIt->constFind("day");
+        if (dailyIt != tokenIt->constEnd() && !dailyIt->isEmpty()) prevDay = dailyIt->last();
+    }
+
+    const PriceLadder ladder = PriceLadder::fromAnalytics(m_instrumentAnalyticsMap.value(instrumentToken), prevDay);
+    m_priceLadders[instrumentToken] = ladder;
+
+    // Touch zone: one tick, or 2 bps of the reference price if wider.
+    const double ref = prevDay.close > 0 ? prevDay.close : 0.0;
+    const double tol = qMax(getInstrument(instrumentToken).tickSize, ref * 0.0002);
+    m_levelDetectors[instrumentToken].setTouchTolerance(tol);
+}
+
+void DataManager::updateLastPrice(const QString &instrumentToken, double price, const QDateTime &timestamp) {
+    const auto ladderIt = m_priceLadders.constFind(instrumentToken);
+    if (ladderIt == m_priceLadders.constEnd() || ladderIt->isEmpty()) return;
+
+    const QVector<PriceLevelEvent> events = m_levelDetectors[instrumentToken].update(*ladderIt, price, timestamp);
+    for (const auto &e : events) emit priceLevelEvent(instrumentToken, e);
+}
+
+void DataManager::onQuotesReceived(const QVector<QuoteData> &quotes) {
+    for (const QuoteData &q : quotes) {
+        if (!q.instrumentToken) continue;
+        const QString token = QString::number(q.instrumentToken);
+        QuoteData &slot = m_latestQuotes[token];
+        const bool moved = slot.lastPrice != q.lastPrice;
+        slot = q;
+        if (moved && q.lastPrice > 0.0) {
+            const QDateTime ts = q.timestampMs ? QDateTime::fromMSecsSinceEpoch(q.timestampMs)
+                                               : QDateTime::currentDateTime();
+            updateLastPrice(token, q.lastPrice, ts);
+        }
+    }
+}
+
+QuoteData DataManager::getLatestQuote(const QString &instrumentToken) const {
+    return m_latestQuotes.value(instrumentToken);
+}
+
+// ---------- volume profile ----------
+// Same incremental feed as the VWAP engine: only unseen bars, the last bar replaced in place,
+// and a full rebuild only when the merge changed a bar older than the last one fed.
+void DataManager::updateVolumeProfiles(const QString &instrumentToken,
+                                       const QVector<CandleData> &stored,
+                                       const QDateTime &changedFrom)
+{
+    TRACE_ZONE("analytics", "analytics.volumeProfile");
+    LATENCY_SCOPE("analytics.volumeProfile");
+    const int kSessionsToKeep = 10;
+    auto *cal = MarketCalendar::instance();
+    QMap<QDate, VolumeProfile> &profiles = m_volumeProfiles[instrumentToken];
+    const auto lastIt = m_volumeProfileLastBar.constFind(instrumentToken);
+    const bool hasLast = lastIt != m_volumeProfileLastBar.constEnd();
+    const QDateTime lastTs = hasLast ? lastIt->timestamp : QDateTime();
+
+    const bool backfill = hasLast && changedFrom < lastTs;
+
+    auto it = stored.cbegin();
+    if (hasLast && !backfill) {
+        it = std::lower_bound(stored.cbegin(), stored.cend(), lastTs,
+                              [](const CandleData& c, const QDateTime& ts){ return c.timestamp < ts; });
+        if (it != stored.cend() && it->timestamp == lastTs) {
+            // still-forming candle re-sent: back out the previous version first
+            auto pit = profiles.find(cal->tradingDateFor(lastTs));
+            if (pit != profiles.end()) pit->removeBar(*lastIt);
+        }
+    } else if (backfill) {
+        profiles.clear();
+    }
+    if (it == stored.cend()) return;
+
+    const InstrumentData inst = getInstrument(instrumentToken);
+    const double tick = inst.tickSize > 0 ? inst.tickSize : 0.05;
+    int &ticksPerBin = m_volumeProfileTicksPerBin[instrumentToken];
+    if (ticksPerBin <= 0) // ~1 bp of price per bin, in whole ticks
+        ticksPerBin = qMax(1, qRound(it->close * 0.0001 / tick));
+
+    for (; it != stored.cend(); ++it) {
+        const QDate session = cal->tradingDateFor(it->timestamp);
+        auto pit = profiles.find(session);
+        if (pit == profiles.end()) {
+            VolumeProfile p(tick, ticksPerBin);
+            p.setSession(session, QDateTime(session, cal->getTradingStartTime()));
+            pit = profiles.insert(session, p);
+        }
+        pit->addBar(*it);
+        m_volumeProfileLastBar[instrumentToken] = *it;
+    }
+    while (profiles.size() > kSessionsToKeep) profiles.erase(profiles.begin());
+}
+
+// ---------- strategy signals ----------
+// Compiles the "signals" of every strategy in config.json once; bad expressions are logged and skipped.
+void DataManager::loadSignalDefinitions()
+{
+    auto *config = ConfigurationManager::instance();
+    for (const QString &strategy : config->getStrategyNames()) {
+        QStringList errors;
+        const auto compiled = SignalExpression::fromStrategyConfig(config->getStrategyConfig(strategy), &errors);
+        for (const QString &e : std::as_const(errors))
+            LOG_WARN("Strategy {}: signal skipped: {}", strategy, e);
+        for (auto c = compiled.constBegin(); c != compiled.constEnd(); ++c)
+            m_signalDefs.append(SignalDef{ strategy, c.key(), c.value() });
+    }
+    if (!m_signalDefs.isEmpty())
+        LOG_INFO("DataManager: {} strategy signal(s) evaluated on 5-minute bars", m_signalDefs.size());
+}
+
+// Same feed as the range indicators: each evaluator holds the state through the next-to-last bar,
+// the possibly still-forming last bar is only peeked at, and only a change at or before the
+// last closed bar replays the series.
+void DataManager::updateSignals(const QString &instrumentToken, const QVector<CandleData> &stored,
+                                const QDateTime &changedFrom)
+{
+    if (m_signalDefs.isEmpty() || stored.isEmpty()) return;
+    TRACE_ZONE("analytics", "analytics.signals");
+    LATENCY_SCOPE("analytics.signals");
+
+    QVector<SignalFeed> &feeds = m_signalFeeds[instrumentToken];
+    if (feeds.size() != m_signalDefs.size()) {
+        feeds.clear();
+        for (const SignalDef &def : std::as_const(m_signalDefs))
+            feeds.append(SignalFeed{ def.expression.streamingEvaluator(), QDateTime(), qQNaN() });
+    }
+    for (SignalFeed &feed : feeds) {
+        auto it = stored.cbegin();
+        if (!feed.lastClosed.isValid() || changedFrom <= feed.lastClosed) {
+            feed.closed.reset();
+            feed.lastClosed = QDateTime();
+        } else {
+            it = std::upper_bound(stored.cbegin(), stored.cend(), feed.lastClosed,
+                                  [](const QDateTime& ts, const CandleData& c){ return ts < c.timestamp; });
+        }
+        for (const auto end = stored.cend() - 1; it < end; ++it) {
+            feed.closed.update(*it);
+            feed.lastClosed = it->timestamp;
+        }
+        feed.value = feed.closed.peek(stored.last());
+    }
+}
+
+double DataManager::getSignalValue(const QString &instrumentToken, const QString &strategy,
+                                   const QString &signal) const
+{
+    const auto feeds = m_signalFeeds.constFind(instrumentToken);
+    if (feeds == m_signalFeeds.constEnd()) return qQNaN();
+    for (int i = 0; i < m_signalDefs.size() && i < feeds->size(); ++i) {
+        const SignalDef &def = m_signalDefs.at(i);
+        if (def.name == signal && def.strategy == strategy) return feeds->at(i).value;
+    }
+    return qQNaN();
+}
+
+// ---------- intraday seasonality ----------
+// Adds each completed session (before today) not yet in the profile, once. Only bars after the
+// last added day are visited.
+void DataManager::updateSeasonality(const QString &instrumentToken, const QVector<CandleData> &stored)
+{
+    TRACE_ZONE("analytics", "analytics.seasonality");
+    LATENCY_SCOPE("analytics.seasonality");
+    if (stored.isEmpty()) return;
+    auto *cal = MarketCalendar::instance();
+
+    auto sit = m_seasonality.find(instrumentToken);
+    if (sit == m_seasonality.end()) {
+        const int kWindowDays = 20;
+        sit = m_seasonality.insert(instrumentToken,
+                                   IntradaySeasonality(kWindowDays, cal->getTradingStartTime(), cal->getTradingEndTime()));
+    }
+    IntradaySeasonality &season = sit.value();
+
+    const QDate today = QDate::currentDate();
+    auto it = stored.cbegin();
+    if (season.lastDay().isValid()) {
+        const QDateTime after = QDateTime::fromMSecsSinceEpoch(cal->sessionEndMsecs(season.lastDay()));
+        it = std::lower_bound(stored.cbegin(), stored.cend(), after,
+                              [](const CandleData& c, const QDateTime& ts){ return c.timestamp < ts; });
+    }
+
+    QVector<CandleData> dayBars;
+    QDate day;
+    for (; it != stored.cend(); ++it) {
+        const QDate d = cal->tradingDateFor(it->timestamp);
+        if (d >= today) break;
+        if (d != day) {
+            if (!dayBars.isEmpty()) season.addDay(day, dayBars);
+            dayBars.clear();
+            day = d;
+        }
+        dayBars.append(*it);
+    }
+    if (!dayBars.isEmpty()) season.addDay(day, dayBars);
+}
+
+// ---------- cross-instrument correlation ----------
+void DataManager::setCorrelationUniverse(const QStringList &instrumentTokens)
+{
+    m_correlation.setInstruments(instrumentTokens);
+    // Replay what is already stored so the new universe starts warm.
+    for (const QString &token : instrumentTokens)
+        updateCorrelation(token, m_historicalDataMap.value(token).value("5minute"));
+}
+
+// Feeds completed 5-minute closes newer than the last one the engine saw. The still-forming bar
+// is held back: the engine is append-only and would otherwise keep its provisional close.
+void DataManager::updateCorrelation(const QString &instrumentToken, const QVector<CandleData> &stored)
+{
+    TRACE_ZONE("analytics", "analytics.correlation");
+    LATENCY_SCOPE("analytics.correlation");
+    if (stored.isEmpty()) return;
+    if (m_correlation.instruments().isEmpty()) {
+        QStringList tokens{ "256265", "260105" };
+        for (const QString &underlying : QStringList{ "NIFTY", "BANKNIFTY" }) {
+            const QString fut = currentMonthFutureToken(underlying);
+            if (!fut.isEmpty()) tokens << fut;
+        }
+        m_correlation.setInstruments(tokens);
+    }
+    const int idx = m_correlation.indexOf(instrumentToken);
+    if (idx < 0) return;
+
+    const qint64 lastMs = m_correlation.lastBarMsecs(idx);
+    auto it = std::upper_bound(stored.cbegin(), stored.cend(), lastMs,
+                               [](qint64 ms, const CandleData& c){ return ms < c.timestamp.toMSecsSinceEpoch(); });
+    const QDateTime formingAfter = QDateTime::currentDateTime().addSecs(-5 * 60);
+    for (; it != stored.cend() && it->timestamp <= formingAfter; ++it)
+        m_correlation.addBar(instrumentToken, it->timestamp, it->close);
 }
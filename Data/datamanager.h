@@ -14,6 +14,15 @@
 #include "Data/DataStructures/instrumentdata.h"
 #include "Data/DataStructures/candle.h"
 #include "Data/DataStructures/instrumentanalytics.h"
+#include "Data/DataStructures/quotedata.h"
+#include "Data/vwapengine.h"
+#include "Data/priceladder.h"
+#include "Data/volumeprofile.h"
+#include "Data/intradayseasonality.h"
+#include "Data/correlationengine.h"
+#include "Utils/realizedvol.h"
+#include "Utils/ta_simple.h"
+#include "Utils/signalexpression.h"
 
 // Market calendar (for prev trading day etc.)
 #include "Utils/marketcalendar.h"
@@ -28,9 +37,34 @@ public:
 
     // Basic accessors
     InstrumentData getInstrument(const QString &instrumentToken) const;
+    // Lookup without copying the instrument (request path).
+    bool isContinuousHistory(const QString &instrumentToken) const;
     QHash<QString, InstrumentData> getAllInstruments() const;
     QVector<CandleData> getStoredHistoricalData(const QString &instrumentToken, const QString &interval) const;
     InstrumentAnalytics getInstrumentAnalytics(const QString &instrumentToken) const;
+    // Bumped each time a fetch actually changes a stored series (0 = nothing stored yet).
+    quint64 seriesVersion(const QString &instrumentToken, const QString &interval) const;
+    // Daily realized-volatility estimators (any estimator/lookback, latest value or full series).
+    TA::RealizedVol getRealizedVolatility(const QString &instrumentToken) const;
+    // Sorted key levels (pivots, swings, range bands, prev-day VWAP) rebuilt with the analytics.
+    PriceLadder getPriceLadder(const QString &instrumentToken) const;
+    // Volume/TPO profile of one session from 5-minute bars (invalid date = latest session),
+    // or the merge of the last `sessions` sessions.
+    VolumeProfile getVolumeProfile(const QString &instrumentToken, const QDate &session = QDate()) const;
+    VolumeProfile compositeVolumeProfile(const QString &instrumentToken, int sessions) const;
+    // Time-of-day profiles of volume/range/returns over the last N completed sessions.
+    IntradaySeasonality getIntradaySeasonality(const QString &instrumentToken) const;
+    // O(1) RVOL for the 5-minute slot containing `time` (NaN without history).
+    double relativeVolume(const QString &instrumentToken, const QTime &time, qlonglong slotVolume) const;
+    // Rolling correlations/betas/spreads across the correlation universe (5-minute returns).
+    // Defaults to NIFTY 50, NIFTY BANK and their current-month futures.
+    CorrelationEngine getCorrelationEngine() const;
+    // Latest value of a configured strategy signal ("strategies": { <strategy>: { "signals": ... } }
+    // in config.json) on the instrument's 5-minute series. NaN while warming up or unknown.
+    double getSignalValue(const QString &instrumentToken, const QString &strategy, const QString &signal) const;
+    void setCorrelationUniverse(const QStringList &instrumentTokens);
+    // Latest polled quote snapshot (instrumentToken 0 if none yet).
+    QuoteData getLatestQuote(const QString &instrumentToken) const;
 
     // --- Option expiry helpers (read-only utilities) ---
     // Pick the earliest expiry >= fromDate (i.e., "weekly" by convention).
@@ -58,17 +92,30 @@ signals:
                                       const QString &fromDate,
                                       const QString &toDate);
     void errorOccurred(const QString& context, const QString& message);
+    // Level crosses/touches detected by updateLastPrice().
+    void priceLevelEvent(const QString &instrumentToken, const PriceLevelEvent &event);
 
 public slots:
     // Input slots
     void onInstrumentsFetched(const QString &filePath);
     void onHistoricalDataReceived(const QString &instrumentToken,
                                   const QString &interval,
-                                  const QJsonArray &candles);
+                                  const QVector<CandleData> &candles);
 
     // Actions
     void loadInstrumentsFromFile(const QString &filename);
+    // Installs NIFTY/BANKNIFTY derivative rows already parsed by parseInstrumentsCsv() and keeps
+    // the current weekly/monthly expiries (cheap; the parsing is the expensive part).
+    void loadInstruments(const QVector<InstrumentData> &candidates);
+    // Parses a Kite instruments CSV into the NIFTY/BANKNIFTY NFO rows loadInstruments() takes.
+    // Touches no DataManager state, so it runs on the network thread.
+    static QVector<InstrumentData> parseInstrumentsCsv(const QByteArray &csv);
     void requestHistoricalData(const QString &instrumentToken, const QString &interval);
+    // Streaming price input: runs the level detector and emits priceLevelEvent for each hit.
+    void updateLastPrice(const QString &instrumentToken, double price,
+                         const QDateTime &timestamp = QDateTime::currentDateTime());
+    // Polled quote snapshots: stored, and changed last prices go through updateLastPrice().
+    void onQuotesReceived(const QVector<QuoteData> &quotes);
 
 private:
     explicit DataManager(QObject *parent = nullptr);
@@ -79,9 +126,26 @@ private:
     QHash<QString, InstrumentData> m_instruments; // includes indices + filtered NFO
     QMap<QString, QMap<QString, QVector<CandleData>>> m_historicalDataMap; // token -> interval -> candles
     QMap<QString, InstrumentAnalytics> m_instrumentAnalyticsMap;            // token -> analytics
+    QHash<QString, QHash<QString, quint64>> m_seriesVersions;               // token -> interval -> version
+    QHash<QString, VwapEngine> m_vwapEngines;                               // token -> streaming 5-min VWAP
+    QHash<QString, TA::RealizedVol> m_realizedVolMap;                       // token -> daily vol estimators
+    struct RangeFeed { TA::RangeIndicators closed; QDateTime lastClosed; }; // state through the next-to-last bar
+    QHash<QString, RangeFeed> m_rangeFeeds;                                 // token -> streaming 5-min ATR/ADX/ST/KC
+    struct SignalDef { QString strategy, name; SignalExpression expression; };
+    struct SignalFeed { SignalExpression::Evaluator closed; QDateTime lastClosed; double value = qQNaN(); };
+    QVector<SignalDef> m_signalDefs;                                        // compiled from config at construction
+    QHash<QString, QVector<SignalFeed>> m_signalFeeds;                      // token -> one feed per m_signalDefs entry
+    QHash<QString, PriceLadder> m_priceLadders;                             // token -> key levels
+    QHash<QString, LevelCrossDetector> m_levelDetectors;                    // token -> streaming cross/touch state
+    QHash<QString, QMap<QDate, VolumeProfile>> m_volumeProfiles;            // token -> session -> profile
+    QHash<QString, CandleData> m_volumeProfileLastBar;                      // token -> last bar fed to the profile
+    QHash<QString, int> m_volumeProfileTicksPerBin;                         // token -> bin width (ticks), fixed so sessions merge
+    QHash<QString, IntradaySeasonality> m_seasonality;                      // token -> time-of-day profiles
+    CorrelationEngine m_correlation;                                        // cross-instrument co-moments
+    QHash<QString, QuoteData> m_latestQuotes;                               // token -> last polled snapshot
 
     // --- Helpers: file parse / persist ---
-    InstrumentData parseInstrumentCSVLine(const QString &line);
+    static InstrumentData parseInstrumentCSVLine(const QString &line);
     void saveParsedInstrumentsToFile();
 
     // --- Storage & analytics ---
@@ -90,8 +154,20 @@ private:
                              const QVector<CandleData> &data);
 
     void calculateDailyAnalytics(const QString &instrumentToken);
-    void calculate5MinAnalytics(const QString &instrumentToken);
+    void calculate5MinAnalytics(const QString &instrumentToken, const QDateTime &changedFrom);
+    void updateVwapEngine(const QString &instrumentToken,
+                          const QVector<CandleData> &stored,
+                          const QDateTime &changedFrom);
     void calculatePreviousDayVWAPStats(const QString &instrumentToken);
+    void rebuildPriceLadder(const QString &instrumentToken);
+    void updateVolumeProfiles(const QString &instrumentToken,
+                              const QVector<CandleData> &stored,
+                              const QDateTime &changedFrom);
+    void updateSeasonality(const QString &instrumentToken, const QVector<CandleData> &stored);
+    void updateCorrelation(const QString &instrumentToken, const QVector<CandleData> &stored);
+    void loadSignalDefinitions();
+    void updateSignals(const QString &instrumentToken, const QVector<CandleData> &stored,
+                       const QDateTime &changedFrom);
 
     // --- Math helpers ---
     double calculateEMA(const QVector<double>& prices, int period) const;
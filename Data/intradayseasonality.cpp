@@ -0,0 +1,119 @@
+#include "Data/intradayseasonality.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+}
+
+IntradaySeasonality::IntradaySeasonality(int windowDays, const QTime &sessionStart,
+                                         const QTime &sessionEnd, int slotMinutes)
+    : m_window(qMax(1, windowDays))
+    , m_start(sessionStart)
+    , m_slotSecs(qMax(1, slotMinutes) * 60)
+    , m_slots(qMax(1, sessionStart.secsTo(sessionEnd) / m_slotSecs))
+{
+    m_columns.resize(kMetrics * m_slots);
+    m_cumMeanVolume.fill(0.0, m_slots);
+}
+
+int IntradaySeasonality::slotFor(const QTime &time) const
+{
+    const int secs = m_start.secsTo(time);
+    if (secs < 0) return -1;
+    const int slot = secs / m_slotSecs;
+    return slot < m_slots ? slot : -1;
+}
+
+// ---------- daily update ----------
+bool IntradaySeasonality::addDay(const QDate &date, const QVector<CandleData> &bars)
+{
+    if (!date.isValid() || (!m_days.isEmpty() && date <= m_days.last().date)) return false;
+
+    Day day;
+    day.date = date;
+    day.values.fill(kNaN, kMetrics * m_slots);
+    bool any = false;
+    for (const auto &b : bars) {
+        const int s = slotFor(b.timestamp.time());
+        if (s < 0 || !(b.open > 0.0) || !(b.close > 0.0) || b.high < b.low) continue;
+        day.values[int(Metric::Volume) * m_slots + s] = double(b.volume);
+        day.values[int(Metric::Range) * m_slots + s] = (b.high - b.low) / b.close;
+        day.values[int(Metric::Return) * m_slots + s] = qLn(b.close / b.open);
+        any = true;
+    }
+    if (!any) return false;
+
+    if (m_days.size() >= m_window) {
+        apply(m_days.first(), false);
+        m_days.removeFirst();
+    }
+    apply(day, true);
+    m_days.append(day);
+
+    double cum = 0.0;
+    for (int s = 0; s < m_slots; ++s) {
+        const double m = mean(Metric::Volume, s);
+        if (qIsFinite(m)) cum += m;
+        m_cumMeanVolume[s] = cum;
+    }
+    return true;
+}
+
+void IntradaySeasonality::apply(const Day &day, bool add)
+{
+    for (int m = 0; m < kMetrics; ++m) {
+        for (int s = 0; s < m_slots; ++s) {
+            const double v = day.values[m * m_slots + s];
+            if (!qIsFinite(v)) continue;
+            Column &c = column(Metric(m), s);
+            auto pos = std::lower_bound(c.sorted.begin(), c.sorted.end(), v);
+            if (add) {
+                c.sum += v;
+                c.sorted.insert(pos, v);
+            } else if (pos != c.sorted.end() && *pos == v) {
+                c.sum -= v;
+                c.sorted.erase(pos);
+            }
+        }
+    }
+}
+
+// ---------- lookups ----------
+int IntradaySeasonality::samples(Metric m, int slot) const
+{
+    if (slot < 0 || slot >= m_slots) return 0;
+    return column(m, slot).sorted.size();
+}
+
+double IntradaySeasonality::mean(Metric m, int slot) const
+{
+    if (slot < 0 || slot >= m_slots) return kNaN;
+    const Column &c = column(m, slot);
+    return c.sorted.isEmpty() ? kNaN : c.sum / c.sorted.size();
+}
+
+double IntradaySeasonality::quantile(Metric m, int slot, double q) const
+{
+    if (slot < 0 || slot >= m_slots) return kNaN;
+    const Column &c = column(m, slot);
+    if (c.sorted.isEmpty()) return kNaN;
+    const int n = c.sorted.size();
+    const int rank = qBound(0, int(qCeil(qBound(0.0, q, 1.0) * n)) - 1, n - 1);
+    return c.sorted[rank];
+}
+
+double IntradaySeasonality::rvol(int slot, double volume) const
+{
+    const double m = mean(Metric::Volume, slot);
+    return (qIsFinite(m) && m > 0.0) ? volume / m : kNaN;
+}
+
+double IntradaySeasonality::cumulativeRvol(int slot, double cumulativeVolume) const
+{
+    if (slot < 0 || slot >= m_slots) return kNaN;
+    const double m = m_cumMeanVolume[slot];
+    return m > 0.0 ? cumulativeVolume / m : kNaN;
+}
@@ -0,0 +1,76 @@
+#ifndef INTRADAYSEASONALITY_H
+#define INTRADAYSEASONALITY_H
+
+#include <QVector>
+#include <QList>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+
+#include "Data/DataStructures/candle.h"
+
+// Rolling N-day time-of-day profiles on the fixed session grid (9:15-15:30 in 5-minute slots
+// = 75 slots for NSE).
+//
+// Each completed day is added once: per slot it contributes volume, relative range
+// (high - low) / close and return ln(close / open). Per slot and metric the builder keeps a
+// running sum and a sorted window of the last N values, so adding a day (and dropping the
+// oldest) costs O(slots * N) once a day, and mean/quantile/RVOL lookups are O(1).
+class IntradaySeasonality
+{
+public:
+    enum class Metric { Volume = 0, Range = 1, Return = 2 };
+
+    explicit IntradaySeasonality(int windowDays = 20,
+                                 const QTime &sessionStart = QTime(9, 15),
+                                 const QTime &sessionEnd = QTime(15, 30),
+                                 int slotMinutes = 5);
+
+    int slotCount() const { return m_slots; }
+    int windowDays() const { return m_window; }
+    int dayCount() const { return m_days.size(); }
+    QDate lastDay() const { return m_days.isEmpty() ? QDate() : m_days.last().date; }
+
+    // Slot of a time of day, or -1 outside the session.
+    int slotFor(const QTime &time) const;
+    QTime slotStart(int slot) const { return m_start.addSecs(slot * m_slotSecs); }
+
+    // Adds one completed day's bars (any order; bars outside the grid are ignored). Days must
+    // be added in date order; an older or repeated date is rejected.
+    bool addDay(const QDate &date, const QVector<CandleData> &bars);
+
+    double mean(Metric m, int slot) const;
+    // q in [0, 1], nearest-rank over the days that had a bar in this slot.
+    double quantile(Metric m, int slot, double q) const;
+    int samples(Metric m, int slot) const;
+
+    // Relative volume: this slot's volume vs. its N-day mean, and cumulative volume so far
+    // today vs. the mean cumulative volume through this slot.
+    double rvol(int slot, double volume) const;
+    double cumulativeRvol(int slot, double cumulativeVolume) const;
+
+private:
+    static const int kMetrics = 3;
+    struct Day {
+        QDate date;
+        QVector<double> values; // [metric * slots + slot], NaN when the slot had no bar
+    };
+    struct Column {
+        double sum = 0.0;
+        QVector<double> sorted;
+    };
+
+    Column &column(Metric m, int slot) { return m_columns[int(m) * m_slots + slot]; }
+    const Column &column(Metric m, int slot) const { return m_columns[int(m) * m_slots + slot]; }
+    void apply(const Day &day, bool add);
+
+    int m_window;
+    QTime m_start;
+    int m_slotSecs;
+    int m_slots;
+    QList<Day> m_days;          // oldest first, at most m_window
+    QVector<Column> m_columns;  // kMetrics * m_slots
+    QVector<double> m_cumMeanVolume; // prefix sums of mean volume per slot
+};
+
+#endif // INTRADAYSEASONALITY_H
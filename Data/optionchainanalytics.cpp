@@ -0,0 +1,221 @@
+#include "Data/optionchainanalytics.h"
+#include "Data/datamanager.h"
+
+#include <QDebug>
+#include <algorithm>
+
+// ---------- Fenwick / MaxTree ----------
+int OptionChainAnalytics::Fenwick::lowerBound(double target) const
+{
+    const int n = t.size() - 1;
+    int pos = 0;
+    int step = 1;
+    while (step * 2 <= n) step *= 2;
+    for (; step > 0; step /= 2) {
+        if (pos + step <= n && t[pos + step] < target) {
+            pos += step;
+            target -= t[pos];
+        }
+    }
+    return pos; // 0-based index of the first prefix reaching target (n if none)
+}
+
+void OptionChainAnalytics::MaxTree::init(const QVector<qlonglong> &values)
+{
+    const int n = values.size();
+    size = 1;
+    while (size < n) size *= 2;
+    idx.fill(-1, 2 * size);
+    for (int i = 0; i < n; ++i) idx[size + i] = i;
+    for (int i = size - 1; i >= 1; --i) {
+        const int l = idx[2 * i], r = idx[2 * i + 1];
+        idx[i] = (r < 0 || (l >= 0 && values[l] >= values[r])) ? l : r;
+    }
+    if (n == 0) size = 0;
+}
+
+void OptionChainAnalytics::MaxTree::update(int i, const QVector<qlonglong> &values)
+{
+    for (int p = (size + i) / 2; p >= 1; p /= 2) {
+        const int l = idx[2 * p], r = idx[2 * p + 1];
+        idx[p] = (r < 0 || (l >= 0 && values[l] >= values[r])) ? l : r;
+    }
+}
+
+// ---------- chain setup ----------
+bool OptionChainAnalytics::loadChain(const QString &underlying, const QDate &expiry)
+{
+    const QVector<InstrumentData> options = DataManager::instance()->optionsForUnderlyingAndExpiry(underlying, expiry);
+    setChain(underlying, expiry, options);
+    if (options.isEmpty()) {
+        qWarning() << "OptionChainAnalytics: no options for" << underlying << expiry.toString(Qt::ISODate);
+        return false;
+    }
+    return true;
+}
+
+void OptionChainAnalytics::setChain(const QString &underlying, const QDate &expiry,
+                                    const QVector<InstrumentData> &options)
+{
+    m_underlying = underlying;
+    m_expiry = expiry;
+
+    m_strikes.clear();
+    for (const auto &o : options) {
+        if (o.instrumentType == "CE" || o.instrumentType == "PE") m_strikes.append(o.strike);
+    }
+    std::sort(m_strikes.begin(), m_strikes.end());
+    m_strikes.erase(std::unique(m_strikes.begin(), m_strikes.end()), m_strikes.end());
+
+    m_legs.clear();
+    for (const auto &o : options) {
+        if (o.instrumentType != "CE" && o.instrumentType != "PE") continue;
+        Leg leg;
+        leg.strikeIndex = int(std::lower_bound(m_strikes.begin(), m_strikes.end(), o.strike) - m_strikes.begin());
+        leg.isCall = (o.instrumentType == "CE");
+        m_legs.insert(o.instrumentToken, leg);
+    }
+
+    const int n = m_strikes.size();
+    for (QVector<qlonglong> *v : { &m_callOI, &m_putOI, &m_callVol, &m_putVol, &m_callBase, &m_putBase })
+        v->fill(0, n);
+    m_cum.init(n);
+    m_callSum.init(n);
+    m_callK.init(n);
+    m_putSum.init(n);
+    m_putK.init(n);
+    m_callWall.init(m_callOI);
+    m_putWall.init(m_putOI);
+    m_agg = ChainAggregates();
+    refreshDerived();
+}
+
+// ---------- updates ----------
+void OptionChainAnalytics::setOI(int j, bool isCall, qlonglong oi)
+{
+    qlonglong &cur = isCall ? m_callOI[j] : m_putOI[j];
+    const qlonglong d = oi - cur;
+    if (d == 0) return;
+    cur = oi;
+
+    const double k = m_strikes[j];
+    m_cum.add(j, double(d));
+    if (isCall) {
+        m_callSum.add(j, double(d));
+        m_callK.add(j, double(d) * k);
+        m_callWall.update(j, m_callOI);
+        m_agg.callOI += d;
+    } else {
+        m_putSum.add(j, double(d));
+        m_putK.add(j, double(d) * k);
+        m_putWall.update(j, m_putOI);
+        m_agg.putOI += d;
+    }
+}
+
+void OptionChainAnalytics::updateQuote(const QString &instrumentToken, qlonglong oi, qlonglong volume)
+{
+    auto it = m_legs.find(instrumentToken);
+    if (it == m_legs.end()) return;
+    Leg &leg = it.value();
+    const int j = leg.strikeIndex;
+
+    if (oi >= 0) {
+        if (leg.baseline < 0) setBaselineOI(instrumentToken, oi);
+        const qlonglong before = leg.isCall ? m_callOI[j] : m_putOI[j];
+        setOI(j, leg.isCall, oi);
+        (leg.isCall ? m_agg.callOIChange : m_agg.putOIChange) += oi - before;
+    }
+    if (volume >= 0) {
+        qlonglong &cur = leg.isCall ? m_callVol[j] : m_putVol[j];
+        (leg.isCall ? m_agg.callVolume : m_agg.putVolume) += volume - cur;
+        cur = volume;
+    }
+    refreshDerived();
+}
+
+void OptionChainAnalytics::setBaselineOI(const QString &instrumentToken, qlonglong oi)
+{
+    auto it = m_legs.find(instrumentToken);
+    if (it == m_legs.end() || oi < 0) return;
+    Leg &leg = it.value();
+    const int j = leg.strikeIndex;
+    qlonglong &base = leg.isCall ? m_callBase[j] : m_putBase[j];
+    qlonglong &change = leg.isCall ? m_agg.callOIChange : m_agg.putOIChange;
+    const qlonglong cur = leg.isCall ? m_callOI[j] : m_putOI[j];
+    // change total = sum(oi - base) over legs with a baseline
+    if (leg.baseline >= 0) change += base;
+    else change += cur; // leg joins the total
+    base = oi;
+    leg.baseline = oi;
+    change -= base;
+}
+
+void OptionChainAnalytics::resetDay()
+{
+    for (auto it = m_legs.begin(); it != m_legs.end(); ++it) it.value().baseline = -1;
+    m_callBase = m_callOI; // no change until a contract's first quote of the day
+    m_putBase = m_putOI;
+    m_callVol.fill(0);
+    m_putVol.fill(0);
+    m_agg.callOIChange = m_agg.putOIChange = 0;
+    m_agg.callVolume = m_agg.putVolume = 0;
+    refreshDerived();
+}
+
+// PCR, walls and max pain from the maintained structures: O(log n).
+void OptionChainAnalytics::refreshDerived()
+{
+    m_agg.pcrOI = m_agg.callOI > 0 ? double(m_agg.putOI) / double(m_agg.callOI) : 0.0;
+    m_agg.pcrVolume = m_agg.callVolume > 0 ? double(m_agg.putVolume) / double(m_agg.callVolume) : 0.0;
+
+    const int cw = m_callWall.top(), pw = m_putWall.top();
+    m_agg.callWallStrike = (cw >= 0 && m_callOI[cw] > 0) ? m_strikes[cw] : 0.0;
+    m_agg.callWallOI = (cw >= 0) ? m_callOI[cw] : 0;
+    m_agg.putWallStrike = (pw >= 0 && m_putOI[pw] > 0) ? m_strikes[pw] : 0.0;
+    m_agg.putWallOI = (pw >= 0) ? m_putOI[pw] : 0;
+
+    if (m_strikes.isEmpty() || m_agg.callOI + m_agg.putOI <= 0) {
+        m_agg.maxPainStrike = m_agg.maxPainValue = 0.0;
+        return;
+    }
+    // Payout slope right of strike j is callOI(<=j) - putOI(>j); it first turns >= 0 where
+    // cumulative call+put OI reaches total put OI.
+    const int j = qMin(m_cum.lowerBound(double(m_agg.putOI)), int(m_strikes.size()) - 1);
+    m_agg.maxPainStrike = m_strikes[j];
+    m_agg.maxPainValue = payoutAt(j);
+}
+
+// ---------- reads ----------
+double OptionChainAnalytics::payoutAt(int j) const
+{
+    if (j < 0 || j >= m_strikes.size()) return 0.0;
+    const double k = m_strikes[j];
+    const double cLe = m_callSum.prefix(j), ckLe = m_callK.prefix(j);
+    const double pLe = m_putSum.prefix(j), pkLe = m_putK.prefix(j);
+    const double pTotal = double(m_agg.putOI);
+    const double pkTotal = m_putK.prefix(m_strikes.size() - 1);
+    return (k * cLe - ckLe) + ((pkTotal - pkLe) - k * (pTotal - pLe));
+}
+
+StrikeOpenInterest OptionChainAnalytics::strikeData(int j) const
+{
+    StrikeOpenInterest s;
+    if (j < 0 || j >= m_strikes.size()) return s;
+    s.strike = m_strikes[j];
+    s.callOI = m_callOI[j];
+    s.putOI = m_putOI[j];
+    s.callOIChange = m_callOI[j] - m_callBase[j];
+    s.putOIChange = m_putOI[j] - m_putBase[j];
+    s.callVolume = m_callVol[j];
+    s.putVolume = m_putVol[j];
+    return s;
+}
+
+QVector<StrikeOpenInterest> OptionChainAnalytics::strikeDistribution() const
+{
+    QVector<StrikeOpenInterest> out;
+    out.reserve(m_strikes.size());
+    for (int j = 0; j < m_strikes.size(); ++j) out.append(strikeData(j));
+    return out;
+}
@@ -0,0 +1,105 @@
+#ifndef OPTIONCHAINANALYTICS_H
+#define OPTIONCHAINANALYTICS_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+
+#include "Data/DataStructures/instrumentdata.h"
+
+// Open interest / volume for one strike of a chain.
+struct StrikeOpenInterest {
+    double strike = 0.0;
+    qlonglong callOI = 0;
+    qlonglong putOI = 0;
+    qlonglong callOIChange = 0; // vs. the day's baseline
+    qlonglong putOIChange = 0;
+    qlonglong callVolume = 0;
+    qlonglong putVolume = 0;
+};
+
+// Chain-wide aggregates, read in O(1) (max pain and walls are maintained, not searched).
+struct ChainAggregates {
+    qlonglong callOI = 0, putOI = 0;
+    qlonglong callVolume = 0, putVolume = 0;
+    qlonglong callOIChange = 0, putOIChange = 0;
+    double pcrOI = 0.0;          // putOI / callOI
+    double pcrVolume = 0.0;      // putVolume / callVolume
+    double maxPainStrike = 0.0;  // strike where option holders' intrinsic payout is smallest
+    double maxPainValue = 0.0;   // that payout, in OI x points
+    double callWallStrike = 0.0; // highest call OI
+    qlonglong callWallOI = 0;
+    double putWallStrike = 0.0;  // highest put OI
+    qlonglong putWallOI = 0;
+};
+
+// Incremental OI/volume aggregates for one underlying + expiry.
+//
+// A quote update touches only its own strike: PCR and OI-change totals adjust in O(1), the
+// call/put walls live in max segment trees and the OI sums in Fenwick trees (O(log n) each).
+// Max pain is where the payout slope changes sign, i.e. the first strike whose cumulative
+// call+put OI reaches total put OI, found by a Fenwick descent in O(log n).
+class OptionChainAnalytics
+{
+public:
+    OptionChainAnalytics() = default;
+
+    // Loads the chain's strikes from DataManager::optionsForUnderlyingAndExpiry.
+    bool loadChain(const QString &underlying, const QDate &expiry);
+    void setChain(const QString &underlying, const QDate &expiry, const QVector<InstrumentData> &options);
+
+    QString underlying() const { return m_underlying; }
+    QDate expiry() const { return m_expiry; }
+    int strikeCount() const { return m_strikes.size(); }
+
+    // Quote input (oi and the day's cumulative volume). Unknown tokens are ignored.
+    // The first OI seen for a contract since resetDay() becomes its baseline unless
+    // setBaselineOI() set one.
+    void updateQuote(const QString &instrumentToken, qlonglong oi, qlonglong volume);
+    void setBaselineOI(const QString &instrumentToken, qlonglong oi);
+    // Clears baselines and volumes for a new session; OI is kept.
+    void resetDay();
+
+    const ChainAggregates &aggregates() const { return m_agg; }
+    StrikeOpenInterest strikeData(int index) const;
+    QVector<StrikeOpenInterest> strikeDistribution() const;
+    // Holders' payout if the underlying settles at strike index j. O(log n).
+    double payoutAt(int index) const;
+
+private:
+    // Fenwick tree over strike indices (sums).
+    struct Fenwick {
+        QVector<double> t;
+        void init(int n) { t.fill(0.0, n + 1); }
+        void add(int i, double d) { for (++i; i < t.size(); i += i & -i) t[i] += d; }
+        double prefix(int i) const { double s = 0.0; for (++i; i > 0; i -= i & -i) s += t[i]; return s; }
+        int lowerBound(double target) const; // first index whose prefix sum >= target
+    };
+    // Max segment tree over a value column, holding the argmax (lowest strike on ties).
+    struct MaxTree {
+        int size = 0;
+        QVector<int> idx;
+        void init(const QVector<qlonglong> &values);
+        void update(int i, const QVector<qlonglong> &values);
+        int top() const { return size > 0 ? idx[1] : -1; }
+    };
+    struct Leg { int strikeIndex = -1; bool isCall = true; qlonglong baseline = -1; };
+
+    void setOI(int strikeIndex, bool isCall, qlonglong oi);
+    void refreshDerived();
+
+    QString m_underlying;
+    QDate m_expiry;
+    QHash<QString, Leg> m_legs;
+    QVector<double> m_strikes; // ascending
+    QVector<qlonglong> m_callOI, m_putOI, m_callVol, m_putVol, m_callBase, m_putBase;
+
+    Fenwick m_cum;             // callOI + putOI
+    Fenwick m_callSum, m_callK; // callOI, callOI * K
+    Fenwick m_putSum, m_putK;   // putOI, putOI * K
+    MaxTree m_callWall, m_putWall;
+    ChainAggregates m_agg;
+};
+
+#endif // OPTIONCHAINANALYTICS_H
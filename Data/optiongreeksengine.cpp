@@ -0,0 +1,180 @@
+#include "Data/optiongreeksengine.h"
+#include "Data/datamanager.h"
+#include "Utils/black76.h"
+#include "Utils/configurationmanager.h"
+#include "Utils/marketcalendar.h"
+
+#include <QDebug>
+#include <QJsonObject>
+#include <QPair>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const double kMsPerYear = 365.0 * 86400000.0;
+const double kMinTimeToExpiry = 60000.0 / kMsPerYear; // floor at one minute
+}
+
+// ---------- chain setup ----------
+bool OptionGreeksEngine::loadChain(const QString &underlying, const QDate &expiry)
+{
+    DataManager *dm = DataManager::instance();
+    const QVector<InstrumentData> options = dm->optionsForUnderlyingAndExpiry(underlying, expiry);
+    setChain(underlying, expiry, options);
+    m_futureToken = dm->currentMonthFutureToken(underlying);
+    if (options.isEmpty()) {
+        qWarning() << "OptionGreeksEngine: no options for" << underlying << expiry.toString(Qt::ISODate);
+        return false;
+    }
+    return true;
+}
+
+void OptionGreeksEngine::setChain(const QString &underlying, const QDate &expiry,
+                                  const QVector<InstrumentData> &options)
+{
+    m_underlying = underlying;
+    m_expiry = expiry;
+    m_expiryClose = QDateTime(expiry, MarketCalendar::instance()->getTradingEndTime());
+
+    const QJsonObject risk = ConfigurationManager::instance()->getRiskParameters();
+    m_rate = risk.value("risk_free_rate").toDouble(m_rate);
+
+    // Sort by strike, CE before PE, so each refresh walks memory in order.
+    QVector<InstrumentData> sorted;
+    sorted.reserve(options.size());
+    for (const auto &o : options) {
+        if (o.instrumentType == "CE" || o.instrumentType == "PE") sorted.push_back(o);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const InstrumentData &a, const InstrumentData &b) {
+        if (a.strike != b.strike) return a.strike < b.strike;
+        return a.instrumentType < b.instrumentType;
+    });
+
+    const int n = sorted.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_tokens.resize(n);
+    m_indexOfToken.clear();
+    m_strike.resize(n);
+    m_sign.resize(n);
+    m_price.fill(0.0, n);
+    m_iv.fill(nan, n);
+    m_delta.fill(nan, n);
+    m_gamma.fill(nan, n);
+    m_vega.fill(nan, n);
+    m_theta.fill(nan, n);
+    m_scratch.fill(0, n);
+    m_pairCall.clear();
+    m_pairPut.clear();
+    m_pairStrike.clear();
+
+    for (int i = 0; i < n; ++i) {
+        const InstrumentData &o = sorted[i];
+        m_tokens[i] = o.instrumentToken;
+        m_indexOfToken.insert(o.instrumentToken, i);
+        m_strike[i] = o.strike;
+        m_sign[i] = (o.instrumentType == "CE") ? 1.0 : -1.0;
+
+        if (m_pairStrike.isEmpty() || m_pairStrike.last() != o.strike) {
+            m_pairStrike.append(o.strike);
+            m_pairCall.append(-1);
+            m_pairPut.append(-1);
+        }
+        (m_sign[i] > 0 ? m_pairCall.last() : m_pairPut.last()) = i;
+    }
+    m_forward = 0.0;
+    m_forwardSource = ForwardSource::None;
+}
+
+void OptionGreeksEngine::setOptionPrice(const QString &instrumentToken, double price)
+{
+    const auto it = m_indexOfToken.constFind(instrumentToken);
+    if (it != m_indexOfToken.constEnd()) m_price[it.value()] = price;
+}
+
+// ---------- forward ----------
+// Put-call parity: F = K + (C - P) * e^{rT}. Uses the strikes where |C - P| is smallest
+// (closest to the money) and takes the median of up to three estimates.
+double OptionGreeksEngine::syntheticForward() const
+{
+    const double growth = qExp(m_rate * m_timeToExpiry);
+    QVector<QPair<double, double>> candidates; // (|C-P|, forward)
+    candidates.reserve(m_pairStrike.size());
+    for (int s = 0; s < m_pairStrike.size(); ++s) {
+        const int ci = m_pairCall[s], pi = m_pairPut[s];
+        if (ci < 0 || pi < 0) continue;
+        const double c = m_price[ci], p = m_price[pi];
+        if (!(c > 0.0) || !(p > 0.0)) continue;
+        candidates.append({ qAbs(c - p), m_pairStrike[s] + (c - p) * growth });
+    }
+    if (candidates.isEmpty()) return 0.0;
+    const int k = qMin(3, int(candidates.size()));
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(),
+                      [](const QPair<double, double> &a, const QPair<double, double> &b) { return a.first < b.first; });
+    QVector<double> f;
+    for (int i = 0; i < k; ++i) f.append(candidates[i].second);
+    std::sort(f.begin(), f.end());
+    return f[k / 2];
+}
+
+// ---------- refresh ----------
+int OptionGreeksEngine::refresh(const QDateTime &now)
+{
+    m_timeToExpiry = qMax(kMinTimeToExpiry, now.msecsTo(m_expiryClose) / kMsPerYear);
+
+    const double synthetic = syntheticForward();
+    if (synthetic > 0.0) {
+        m_forward = synthetic;
+        m_forwardSource = ForwardSource::Synthetic;
+    } else if (m_futurePrice > 0.0) {
+        m_forward = m_futurePrice;
+        m_forwardSource = ForwardSource::Future;
+    } else {
+        m_forwardSource = ForwardSource::None;
+        return 0;
+    }
+
+    Black76::ChainArrays arrays;
+    arrays.n = m_strike.size();
+    arrays.strike = m_strike.constData();
+    arrays.sign = m_sign.constData();
+    arrays.price = m_price.constData();
+    arrays.iv = m_iv.data();
+    arrays.delta = m_delta.data();
+    arrays.gamma = m_gamma.data();
+    arrays.vega = m_vega.data();
+    arrays.theta = m_theta.data();
+    arrays.scratch = m_scratch.data();
+    return Black76::solveChain(arrays, m_forward, m_timeToExpiry, m_rate);
+}
+
+// ---------- accessors ----------
+OptionGreeks OptionGreeksEngine::at(int i) const
+{
+    OptionGreeks g;
+    if (i < 0 || i >= m_strike.size()) return g;
+    g.instrumentToken = m_tokens[i];
+    g.strike = m_strike[i];
+    g.isCall = m_sign[i] > 0;
+    g.price = m_price[i];
+    g.iv = m_iv[i];
+    g.delta = m_delta[i];
+    g.gamma = m_gamma[i];
+    g.vega = m_vega[i];
+    g.theta = m_theta[i];
+    g.valid = qIsFinite(g.iv);
+    return g;
+}
+
+OptionGreeks OptionGreeksEngine::greeks(const QString &instrumentToken) const
+{
+    return at(m_indexOfToken.value(instrumentToken, -1));
+}
+
+QVector<OptionGreeks> OptionGreeksEngine::chain() const
+{
+    QVector<OptionGreeks> out;
+    out.reserve(m_strike.size());
+    for (int i = 0; i < m_strike.size(); ++i) out.append(at(i));
+    return out;
+}
@@ -0,0 +1,104 @@
+#ifndef OPTIONGREEKSENGINE_H
+#define OPTIONGREEKSENGINE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+#include <QDateTime>
+
+#include "Data/DataStructures/instrumentdata.h"
+
+// Greeks for one option contract (vega per 1.00 vol point, theta per calendar day).
+struct OptionGreeks {
+    QString instrumentToken;
+    double strike = 0.0;
+    bool isCall = true;
+    double price = 0.0;
+    double iv = 0.0;
+    double delta = 0.0;
+    double gamma = 0.0;
+    double vega = 0.0;
+    double theta = 0.0;
+    bool valid = false;
+};
+
+// Full-chain Black-76 IV/Greeks for one underlying + expiry.
+//
+// Contracts are kept in structure-of-arrays form (strike, sign, price, iv, Greeks) so each
+// refresh runs Black76::solveChain over contiguous arrays. The previous refresh's IVs are
+// the next refresh's starting point, so a per-tick update normally needs one or two solver
+// iterations per strike.
+//
+// Forward: the synthetic forward from put-call parity around the money when both legs are
+// quoted, otherwise the current-month future (DataManager::currentMonthFutureToken).
+class OptionGreeksEngine
+{
+public:
+    enum class ForwardSource { None, Synthetic, Future };
+
+    OptionGreeksEngine() = default;
+
+    // Loads all CE/PE contracts for underlying/expiry from DataManager.
+    bool loadChain(const QString &underlying, const QDate &expiry);
+    void setChain(const QString &underlying, const QDate &expiry, const QVector<InstrumentData> &options);
+
+    QString underlying() const { return m_underlying; }
+    QDate expiry() const { return m_expiry; }
+    QString futureToken() const { return m_futureToken; }
+    int size() const { return m_strike.size(); }
+
+    // Price inputs (LTP or mid). Unknown tokens are ignored.
+    void setOptionPrice(const QString &instrumentToken, double price);
+    void setFuturePrice(double price) { m_futurePrice = price; }
+
+    void setRiskFreeRate(double r) { m_rate = r; }
+    double riskFreeRate() const { return m_rate; }
+
+    // Recomputes IV and Greeks for every contract. Returns the number of contracts solved.
+    int refresh(const QDateTime &now = QDateTime::currentDateTime());
+
+    double forward() const { return m_forward; }
+    ForwardSource forwardSource() const { return m_forwardSource; }
+    double timeToExpiry() const { return m_timeToExpiry; } // years, as of the last refresh
+
+    OptionGreeks at(int index) const;
+    OptionGreeks greeks(const QString &instrumentToken) const;
+    QVector<OptionGreeks> chain() const;
+
+    // Contiguous views for consumers that want the raw columns (e.g. surface builders).
+    const QVector<double> &strikes() const { return m_strike; }
+    const QVector<double> &signs() const { return m_sign; }
+    const QVector<double> &impliedVols() const { return m_iv; }
+
+private:
+    double syntheticForward() const;
+
+    QString m_underlying;
+    QDate m_expiry;
+    QString m_futureToken;
+    QDateTime m_expiryClose;
+
+    QVector<QString> m_tokens;
+    QHash<QString, int> m_indexOfToken;
+    QVector<double> m_strike;
+    QVector<double> m_sign;    // +1 call, -1 put
+    QVector<double> m_price;
+    QVector<double> m_iv;      // also the warm start for the next refresh
+    QVector<double> m_delta;
+    QVector<double> m_gamma;
+    QVector<double> m_vega;
+    QVector<double> m_theta;
+    QVector<quint8> m_scratch;
+    QVector<int> m_pairCall;   // per distinct strike (ascending): index of CE, or -1
+    QVector<int> m_pairPut;    // per distinct strike (ascending): index of PE, or -1
+    QVector<double> m_pairStrike;
+
+    double m_futurePrice = 0.0;
+    double m_rate = 0.065;
+    double m_forward = 0.0;
+    double m_timeToExpiry = 0.0;
+    ForwardSource m_forwardSource = ForwardSource::None;
+};
+
+#endif // OPTIONGREEKSENGINE_H
@@ -0,0 +1,176 @@
+#include "Data/priceladder.h"
+#include "Utils/ta_simple.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+std::atomic<quint64> s_ladderVersion{0};
+
+bool priceLess(const PriceLevel &l, double p) { return l.price < p; }
+bool priceGreater(double p, const PriceLevel &l) { return p < l.price; }
+}
+
+// ---------- PriceLadder ----------
+void PriceLadder::clear()
+{
+    m_levels.clear();
+    m_version = ++s_ladderVersion;
+}
+
+void PriceLadder::addLevel(double price, PriceLevel::Source source, const QString &label)
+{
+    if (!(price > 0.0) || !qIsFinite(price)) return;
+    PriceLevel l;
+    l.price = price;
+    l.source = source;
+    l.label = label;
+    m_levels.append(l);
+}
+
+void PriceLadder::finalize()
+{
+    std::stable_sort(m_levels.begin(), m_levels.end(),
+                     [](const PriceLevel &a, const PriceLevel &b) { return a.price < b.price; });
+    m_version = ++s_ladderVersion;
+}
+
+PriceLadder PriceLadder::fromAnalytics(const InstrumentAnalytics &a, const CandleData &prevDay)
+{
+    using S = PriceLevel::Source;
+    PriceLadder ladder;
+
+    const double H = prevDay.high, L = prevDay.low, C = prevDay.close;
+    if (H > 0.0 && L > 0.0 && C > 0.0 && H >= L) {
+        const TA::Pivots cl = TA::pivotsClassic(H, L, C);
+        ladder.addLevel(cl.P,  S::Pivot, "P");
+        ladder.addLevel(cl.R1, S::Pivot, "R1");
+        ladder.addLevel(cl.R2, S::Pivot, "R2");
+        ladder.addLevel(cl.R3, S::Pivot, "R3");
+        ladder.addLevel(cl.S1, S::Pivot, "S1");
+        ladder.addLevel(cl.S2, S::Pivot, "S2");
+        ladder.addLevel(cl.S3, S::Pivot, "S3");
+
+        const TA::Pivots fib = TA::pivotsFibonacci(H, L, C);
+        ladder.addLevel(fib.R1, S::Fibonacci, "FIB R1");
+        ladder.addLevel(fib.R2, S::Fibonacci, "FIB R2");
+        ladder.addLevel(fib.R3, S::Fibonacci, "FIB R3");
+        ladder.addLevel(fib.S1, S::Fibonacci, "FIB S1");
+        ladder.addLevel(fib.S2, S::Fibonacci, "FIB S2");
+        ladder.addLevel(fib.S3, S::Fibonacci, "FIB S3");
+
+        const TA::Pivots cam = TA::pivotsCamarilla(H, L, C);
+        ladder.addLevel(cam.R3, S::Camarilla, "CAM H3");
+        ladder.addLevel(cam.R4, S::Camarilla, "CAM H4");
+        ladder.addLevel(cam.S3, S::Camarilla, "CAM L3");
+        ladder.addLevel(cam.S4, S::Camarilla, "CAM L4");
+    }
+
+    if (a.swing_7D_Calculated) {
+        ladder.addLevel(a.high_7D, S::Swing, "7D HIGH");
+        ladder.addLevel(a.low_7D,  S::Swing, "7D LOW");
+    }
+    if (a.swing_21D_Calculated) {
+        ladder.addLevel(a.high_21D, S::Swing, "21D HIGH");
+        ladder.addLevel(a.low_21D,  S::Swing, "21D LOW");
+    }
+    if (a.rangeBands_PC_Calculated) {
+        ladder.addLevel(a.rangeUpperBand_PC, S::RangeBand, "RANGE U");
+        ladder.addLevel(a.rangeLowerBand_PC, S::RangeBand, "RANGE L");
+    }
+    if (a.prevDayVWAP_Stats_Calculated) {
+        ladder.addLevel(a.prevDayVWAP_High,  S::PrevDayVwap, "PDVWAP H");
+        ladder.addLevel(a.prevDayVWAP_Low,   S::PrevDayVwap, "PDVWAP L");
+        ladder.addLevel(a.prevDayVWAP_Close, S::PrevDayVwap, "PDVWAP C");
+    }
+
+    ladder.finalize();
+    return ladder;
+}
+
+int PriceLadder::upperIndex(double price) const
+{
+    return int(std::upper_bound(m_levels.cbegin(), m_levels.cend(), price, priceGreater) - m_levels.cbegin());
+}
+
+bool PriceLadder::nearestAbove(double price, PriceLevel *out) const
+{
+    const int i = upperIndex(price);
+    if (i >= m_levels.size()) return false;
+    if (out) *out = m_levels[i];
+    return true;
+}
+
+bool PriceLadder::nearestBelow(double price, PriceLevel *out) const
+{
+    const int i = upperIndex(price) - 1;
+    if (i < 0) return false;
+    if (out) *out = m_levels[i];
+    return true;
+}
+
+// ---------- LevelCrossDetector ----------
+void LevelCrossDetector::reset()
+{
+    m_hasLast = false;
+    m_lastPrice = 0.0;
+    m_touchedIndex = -1;
+}
+
+QVector<PriceLevelEvent> LevelCrossDetector::update(const PriceLadder &ladder, double price,
+                                                    const QDateTime &timestamp)
+{
+    QVector<PriceLevelEvent> events;
+    if (!(price > 0.0) || !qIsFinite(price)) return events;
+
+    if (ladder.version() != m_ladderVersion) {
+        m_ladderVersion = ladder.version();
+        m_touchedIndex = -1; // indices refer to the old ladder
+    }
+    const QVector<PriceLevel> &levels = ladder.levels();
+
+    auto push = [&](PriceLevelEvent::Type type, int index) {
+        PriceLevelEvent e;
+        e.type = type;
+        e.level = levels[index];
+        e.price = price;
+        e.timestamp = timestamp;
+        events.append(e);
+    };
+
+    int lastCrossed = -1;
+    if (m_hasLast && price != m_lastPrice) {
+        if (price > m_lastPrice) {
+            // levels in (last, price], ascending
+            const int from = ladder.upperIndex(m_lastPrice);
+            const int to = ladder.upperIndex(price);
+            for (int i = from; i < to; ++i) { push(PriceLevelEvent::Type::CrossUp, i); lastCrossed = i; }
+        } else {
+            // levels in [price, last), descending
+            const int from = int(std::lower_bound(levels.cbegin(), levels.cend(), m_lastPrice, priceLess) - levels.cbegin()) - 1;
+            const int to = int(std::lower_bound(levels.cbegin(), levels.cend(), price, priceLess) - levels.cbegin());
+            for (int i = from; i >= to; --i) { push(PriceLevelEvent::Type::CrossDown, i); lastCrossed = i; }
+        }
+    }
+    m_lastPrice = price;
+    m_hasLast = true;
+
+    // Touch: the closest level within tolerance, once per visit to its zone.
+    int nearest = -1;
+    const int above = ladder.upperIndex(price);
+    double best = m_tolerance;
+    if (above < levels.size() && levels[above].price - price <= best) {
+        nearest = above;
+        best = levels[above].price - price;
+    }
+    if (above - 1 >= 0 && price - levels[above - 1].price <= best) nearest = above - 1;
+
+    if (lastCrossed >= 0) {
+        m_touchedIndex = lastCrossed; // a cross already reported this level
+    } else if (nearest != m_touchedIndex) {
+        if (nearest >= 0) push(PriceLevelEvent::Type::Touch, nearest);
+        m_touchedIndex = nearest;
+    }
+    return events;
+}
@@ -0,0 +1,82 @@
+#ifndef PRICELADDER_H
+#define PRICELADDER_H
+
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+
+#include "Data/DataStructures/candle.h"
+#include "Data/DataStructures/instrumentanalytics.h"
+
+// One key price level (pivot, swing, band, ...).
+struct PriceLevel {
+    enum class Source { Pivot, Fibonacci, Camarilla, Swing, RangeBand, PrevDayVwap, Custom };
+
+    double price = 0.0;
+    Source source = Source::Custom;
+    QString label; // e.g. "R1", "FIB S2", "CAM H4", "7D HIGH", "PDVWAP C"
+};
+
+struct PriceLevelEvent {
+    enum class Type { CrossUp, CrossDown, Touch };
+
+    Type type = Type::Touch;
+    PriceLevel level;
+    double price = 0.0;   // the price that triggered the event
+    QDateTime timestamp;
+};
+
+// Sorted ladder of an instrument's key levels. Built once per analytics update; lookups are
+// binary searches (O(log n)).
+class PriceLadder
+{
+public:
+    void clear();
+    void addLevel(double price, PriceLevel::Source source, const QString &label);
+    void finalize(); // sorts; call after the last addLevel()
+
+    // Classic/Fibonacci/Camarilla pivots from prevDay plus the swing, range-band and
+    // previous-day VWAP levels already held in InstrumentAnalytics.
+    static PriceLadder fromAnalytics(const InstrumentAnalytics &a, const CandleData &prevDay);
+
+    const QVector<PriceLevel> &levels() const { return m_levels; }
+    int size() const { return m_levels.size(); }
+    bool isEmpty() const { return m_levels.isEmpty(); }
+    quint64 version() const { return m_version; }
+
+    // First level strictly above / at-or-below price. Return false when there is none.
+    bool nearestAbove(double price, PriceLevel *out = nullptr) const;
+    bool nearestBelow(double price, PriceLevel *out = nullptr) const;
+    // Index of the first level with level.price > price (size() if none).
+    int upperIndex(double price) const;
+
+private:
+    QVector<PriceLevel> m_levels; // ascending price
+    quint64 m_version = 0;
+};
+
+// Streaming cross/touch detection against a PriceLadder. Each update is O(log n + events).
+//  - CrossUp:   previous price < level <= price
+//  - CrossDown: previous price > level >= price
+//  - Touch:     price within touchTolerance of a level it did not cross; fires once per visit
+class LevelCrossDetector
+{
+public:
+    explicit LevelCrossDetector(double touchTolerance = 0.0) : m_tolerance(touchTolerance) {}
+
+    void setTouchTolerance(double tolerance) { m_tolerance = tolerance; }
+    double touchTolerance() const { return m_tolerance; }
+    void reset();
+
+    QVector<PriceLevelEvent> update(const PriceLadder &ladder, double price,
+                                    const QDateTime &timestamp = QDateTime::currentDateTime());
+
+private:
+    double m_tolerance;
+    double m_lastPrice = 0.0;
+    bool m_hasLast = false;
+    quint64 m_ladderVersion = 0;
+    int m_touchedIndex = -1; // level currently inside the touch zone
+};
+
+#endif // PRICELADDER_H
@@ -0,0 +1,305 @@
+#include "Data/volatilitysurface.h"
+#include "Data/optiongreeksengine.h"
+
+#include <QtMath>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace {
+const double kMinVariance = 1e-8;
+const double kIvEpsilon = 1e-7;         // smaller IV moves are not treated as a change
+const double kRecenterDistance = 0.10;  // re-expand the fit when ln(F) drifts this far
+const int kRebuildEvery = 1024;         // refresh running sums to shed rounding drift
+
+inline qint64 strikeKey(double strike) { return qRound64(strike * 100.0); }
+
+// Solves the 3x3 system m * out = rhs by Cramer's rule. Returns false when singular.
+bool solve3(const double m[3][3], const double rhs[3], double out[3])
+{
+    auto det3 = [](const double a[3][3]) {
+        return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+             - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    };
+    const double d = det3(m);
+    const double scale = qAbs(m[0][0] * m[1][1] * m[2][2]);
+    if (!(qAbs(d) > 1e-12 * scale) || !qIsFinite(d)) return false;
+    for (int col = 0; col < 3; ++col) {
+        double t[3][3];
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c) t[r][c] = (c == col) ? rhs[r] : m[r][c];
+        out[col] = det3(t) / d;
+    }
+    return true;
+}
+}
+
+// ---------- SmileSlice ----------
+double SmileSlice::variance(double logStrike) const
+{
+    if (points == 0) return std::numeric_limits<double>::quiet_NaN();
+    const double x = qBound(xMin, logStrike - center, xMax);
+    return qMax(kMinVariance, a + b * x + c * x * x);
+}
+
+double SmileSlice::totalVariance(double logMoneyness) const
+{
+    return variance(logMoneyness + qLn(forward)) * timeToExpiry;
+}
+
+double SmileSlice::impliedVol(double strike) const
+{
+    if (!(strike > 0.0)) return std::numeric_limits<double>::quiet_NaN();
+    return qSqrt(variance(qLn(strike)));
+}
+
+// ---------- VolSurfaceSnapshot ----------
+const SmileSlice *VolSurfaceSnapshot::slice(const QDate &expiry) const
+{
+    for (const auto &s : slices)
+        if (s.expiry == expiry) return &s;
+    return nullptr;
+}
+
+double VolSurfaceSnapshot::impliedVol(const QDate &expiry, double strike) const
+{
+    const SmileSlice *s = slice(expiry);
+    return s ? s->impliedVol(strike) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double VolSurfaceSnapshot::totalVariance(double timeToExpiry, double logMoneyness) const
+{
+    if (slices.isEmpty() || !(timeToExpiry > 0.0)) return std::numeric_limits<double>::quiet_NaN();
+
+    const SmileSlice &first = slices.first();
+    if (timeToExpiry <= first.timeToExpiry)
+        return first.totalVariance(logMoneyness) * timeToExpiry / first.timeToExpiry;
+    const SmileSlice &last = slices.last();
+    if (timeToExpiry >= last.timeToExpiry)
+        return last.totalVariance(logMoneyness) * timeToExpiry / last.timeToExpiry;
+
+    int hi = 1;
+    while (slices[hi].timeToExpiry < timeToExpiry) ++hi;
+    const SmileSlice &s0 = slices[hi - 1];
+    const SmileSlice &s1 = slices[hi];
+    const double w0 = s0.totalVariance(logMoneyness);
+    // Total variance must not fall with maturity; clamp so interpolation stays calendar-consistent.
+    const double w1 = qMax(w0, s1.totalVariance(logMoneyness));
+    const double t = (timeToExpiry - s0.timeToExpiry) / (s1.timeToExpiry - s0.timeToExpiry);
+    return w0 + (w1 - w0) * t;
+}
+
+double VolSurfaceSnapshot::impliedVol(double timeToExpiry, double logMoneyness) const
+{
+    const double w = totalVariance(timeToExpiry, logMoneyness);
+    return qIsFinite(w) ? qSqrt(w / timeToExpiry) : w;
+}
+
+// ---------- VolatilitySurface: writer ----------
+VolatilitySurface::VolatilitySurface(const QString &underlying)
+    : m_underlying(underlying)
+{
+    auto *empty = new VolSurfaceSnapshot;
+    empty->underlying = underlying;
+    m_current.store(empty, std::memory_order_release);
+}
+
+VolatilitySurface::~VolatilitySurface()
+{
+    qDeleteAll(m_retired);
+    delete m_current.load(std::memory_order_acquire);
+}
+
+void VolatilitySurface::setExpiry(const QDate &expiry, double forward, double timeToExpiry)
+{
+    if (!(forward > 0.0) || !(timeToExpiry > 0.0)) return;
+    auto it = m_slices.find(expiry);
+    if (it == m_slices.end()) {
+        it = m_slices.insert(expiry, Slice());
+        m_structureChanged = true;
+    }
+    Slice &s = it.value();
+    if (s.forward == forward && s.timeToExpiry == timeToExpiry) return;
+    s.forward = forward;
+    s.timeToExpiry = timeToExpiry;
+    s.dirty = true;
+
+    const double lnF = qLn(forward);
+    if (!s.hasCenter || qAbs(lnF - s.center) > kRecenterDistance) {
+        s.center = lnF;
+        s.hasCenter = true;
+        rebuildSums(s);
+    }
+}
+
+void VolatilitySurface::updatePoint(const QDate &expiry, double strike, double iv, double weight)
+{
+    auto it = m_slices.find(expiry);
+    if (it == m_slices.end() || !(strike > 0.0)) return;
+    Slice &s = it.value();
+    const qint64 key = strikeKey(strike);
+    auto pit = s.points.find(key);
+
+    if (!(iv > 0.0) || !qIsFinite(iv) || !(weight > 0.0)) {
+        if (pit == s.points.end()) return;
+        accumulate(s, pit.value(), -1.0);
+        s.points.erase(pit);
+        s.dirty = true;
+        return;
+    }
+
+    Point p;
+    p.x = qLn(strike);
+    p.y = iv * iv;
+    p.w = weight;
+    if (pit != s.points.end()) {
+        const Point &old = pit.value();
+        if (qAbs(qSqrt(old.y) - iv) < kIvEpsilon && qAbs(old.w - weight) <= 1e-9 * weight) return;
+        accumulate(s, old, -1.0);
+        pit.value() = p;
+    } else {
+        s.points.insert(key, p);
+    }
+    accumulate(s, p, 1.0);
+    s.dirty = true;
+    if (++s.updatesSinceRebuild >= kRebuildEvery) rebuildSums(s);
+}
+
+void VolatilitySurface::removeExpiry(const QDate &expiry)
+{
+    if (m_slices.remove(expiry) > 0) m_structureChanged = true;
+}
+
+void VolatilitySurface::updateFromChain(const OptionGreeksEngine &engine)
+{
+    const double forward = engine.forward();
+    if (!(forward > 0.0)) return;
+    setExpiry(engine.expiry(), forward, engine.timeToExpiry());
+    for (int i = 0; i < engine.size(); ++i) {
+        const OptionGreeks g = engine.at(i);
+        if (g.isCall != (g.strike >= forward)) continue; // in-the-money leg: skip
+        updatePoint(engine.expiry(), g.strike, g.valid ? g.iv : 0.0, qMax(g.vega, 1e-6));
+    }
+}
+
+void VolatilitySurface::accumulate(Slice &s, const Point &p, double sign)
+{
+    const double x = p.x - s.center;
+    const double w = sign * p.w;
+    double xp = 1.0;
+    for (int k = 0; k < 5; ++k) {
+        s.sx[k] += w * xp;
+        if (k < 3) s.sy[k] += w * p.y * xp;
+        xp *= x;
+    }
+}
+
+void VolatilitySurface::rebuildSums(Slice &s)
+{
+    for (double &v : s.sx) v = 0.0;
+    for (double &v : s.sy) v = 0.0;
+    for (auto it = s.points.cbegin(); it != s.points.cend(); ++it) accumulate(s, it.value(), 1.0);
+    s.updatesSinceRebuild = 0;
+}
+
+// Weighted least squares of variance on x. Falls back to a line, then a constant, when there
+// are too few points or the quadratic is degenerate.
+void VolatilitySurface::fit(const QDate &expiry, Slice &s)
+{
+    SmileSlice &f = s.fitted;
+    f.expiry = expiry;
+    f.timeToExpiry = s.timeToExpiry;
+    f.forward = s.forward;
+    f.center = s.center;
+    f.points = s.points.size();
+    f.a = f.b = f.c = 0.0;
+    s.dirty = false;
+    if (f.points == 0 || !(s.sx[0] > 0.0)) { f.points = 0; return; }
+
+    f.xMin = std::numeric_limits<double>::max();
+    f.xMax = -std::numeric_limits<double>::max();
+    for (auto it = s.points.cbegin(); it != s.points.cend(); ++it) {
+        const double x = it.value().x - s.center;
+        f.xMin = qMin(f.xMin, x);
+        f.xMax = qMax(f.xMax, x);
+    }
+
+    if (f.points >= 3) {
+        const double m[3][3] = { { s.sx[0], s.sx[1], s.sx[2] },
+                                 { s.sx[1], s.sx[2], s.sx[3] },
+                                 { s.sx[2], s.sx[3], s.sx[4] } };
+        double out[3];
+        if (solve3(m, s.sy, out)) { f.a = out[0]; f.b = out[1]; f.c = out[2]; return; }
+    }
+    const double det = s.sx[0] * s.sx[2] - s.sx[1] * s.sx[1];
+    if (f.points >= 2 && qAbs(det) > 1e-12 * s.sx[0] * s.sx[2]) {
+        f.b = (s.sx[0] * s.sy[1] - s.sx[1] * s.sy[0]) / det;
+        f.a = (s.sy[0] - f.b * s.sx[1]) / s.sx[0];
+        return;
+    }
+    f.a = s.sy[0] / s.sx[0];
+}
+
+bool VolatilitySurface::commit(const QDateTime &asOf)
+{
+    bool changed = m_structureChanged;
+    for (auto it = m_slices.begin(); it != m_slices.end(); ++it) {
+        if (!it.value().dirty) continue;
+        fit(it.key(), it.value());
+        changed = true;
+    }
+    if (!changed) return false;
+    m_structureChanged = false;
+
+    auto *snap = new VolSurfaceSnapshot;
+    snap->underlying = m_underlying;
+    snap->version = ++m_version;
+    snap->asOf = asOf;
+    for (auto it = m_slices.cbegin(); it != m_slices.cend(); ++it) {
+        const SmileSlice &f = it.value().fitted;
+        if (f.points > 0 && f.timeToExpiry > 0.0) snap->slices.append(f);
+    }
+    std::sort(snap->slices.begin(), snap->slices.end(), [](const SmileSlice &a, const SmileSlice &b) {
+        return a.timeToExpiry < b.timeToExpiry;
+    });
+    m_retired.append(m_current.exchange(snap, std::memory_order_seq_cst));
+    reclaim();
+    return true;
+}
+
+// Frees replaced snapshots nobody can reach any more. The exchange in commit() precedes this
+// check, so a reader that enters snapshot() after seeing m_entering == 0 here can only load a
+// newer snapshot; one that entered before has pinned by the time it leaves.
+void VolatilitySurface::reclaim()
+{
+    if (m_entering.load(std::memory_order_seq_cst) != 0) return; // retry on the next commit
+    for (int i = m_retired.size() - 1; i >= 0; --i) {
+        const VolSurfaceSnapshot *old = m_retired.at(i);
+        if (old->m_pins.load(std::memory_order_acquire) != 0) continue;
+        delete old;
+        m_retired.removeAt(i);
+    }
+}
+
+// ---------- VolatilitySurface: reader ----------
+VolSurfaceRef VolatilitySurface::snapshot() const
+{
+    m_entering.fetch_add(1, std::memory_order_seq_cst);
+    const VolSurfaceSnapshot *snap = m_current.load(std::memory_order_seq_cst);
+    snap->m_pins.fetch_add(1, std::memory_order_relaxed);
+    m_entering.fetch_sub(1, std::memory_order_release);
+    return VolSurfaceRef(snap);
+}
+
+// ---------- VolSurfaceRef ----------
+VolSurfaceRef &VolSurfaceRef::operator=(const VolSurfaceRef &other)
+{
+    if (m_snap != other.m_snap) {
+        other.pin();
+        unpin();
+        m_snap = other.m_snap;
+    }
+    return *this;
+}
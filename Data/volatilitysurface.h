@@ -0,0 +1,144 @@
+#ifndef VOLATILITYSURFACE_H
+#define VOLATILITYSURFACE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDate>
+#include <QDateTime>
+
+#include <atomic>
+
+class OptionGreeksEngine;
+
+// Fitted smile for one expiry: variance sigma^2(x) = a + b*x + c*x^2 with x = ln(K) - center.
+// Outside [xMin, xMax] (the quoted strikes) the variance is held flat.
+struct SmileSlice {
+    QDate expiry;
+    double timeToExpiry = 0.0; // years
+    double forward = 0.0;
+    double center = 0.0;       // ln(K) reference the fit is expanded around
+    double a = 0.0, b = 0.0, c = 0.0;
+    double xMin = 0.0, xMax = 0.0;
+    int points = 0;
+
+    double variance(double logStrike) const;
+    double totalVariance(double logMoneyness) const; // w(k), k = ln(K / forward)
+    double impliedVol(double strike) const;
+};
+
+// Immutable, published view of the surface. Readers pin it through a VolSurfaceRef, so a refit
+// never changes a snapshot someone is reading; a new one is swapped in by VolatilitySurface::commit().
+class VolSurfaceSnapshot
+{
+public:
+    VolSurfaceSnapshot() = default;
+    VolSurfaceSnapshot(const VolSurfaceSnapshot &) = delete;
+    VolSurfaceSnapshot &operator=(const VolSurfaceSnapshot &) = delete;
+
+    QString underlying;
+    quint64 version = 0;
+    QDateTime asOf;
+    QVector<SmileSlice> slices; // ascending timeToExpiry
+
+    bool isEmpty() const { return slices.isEmpty(); }
+    const SmileSlice *slice(const QDate &expiry) const;
+
+    // IV at a listed expiry, read straight off that expiry's smile.
+    double impliedVol(const QDate &expiry, double strike) const;
+    // IV at any time/moneyness: linear in total variance between the bracketing expiries at the
+    // same log-moneyness k = ln(K/F); flat vol before the first expiry, flat variance rate after the last.
+    double impliedVol(double timeToExpiry, double logMoneyness) const;
+    double totalVariance(double timeToExpiry, double logMoneyness) const;
+
+private:
+    friend class VolatilitySurface;
+    friend class VolSurfaceRef;
+    mutable std::atomic<int> m_pins{0}; // live VolSurfaceRefs; the writer frees it only at zero
+};
+
+// Pinned, read-only handle to a published snapshot (copyable; unpins on destruction).
+class VolSurfaceRef
+{
+public:
+    VolSurfaceRef() = default;
+    VolSurfaceRef(const VolSurfaceRef &other) : m_snap(other.m_snap) { pin(); }
+    VolSurfaceRef &operator=(const VolSurfaceRef &other);
+    ~VolSurfaceRef() { unpin(); }
+
+    const VolSurfaceSnapshot *get() const { return m_snap; }
+    const VolSurfaceSnapshot *operator->() const { return m_snap; }
+    const VolSurfaceSnapshot &operator*() const { return *m_snap; }
+    explicit operator bool() const { return m_snap != nullptr; }
+
+private:
+    friend class VolatilitySurface;
+    explicit VolSurfaceRef(const VolSurfaceSnapshot *alreadyPinned) : m_snap(alreadyPinned) {}
+    void pin() const { if (m_snap) m_snap->m_pins.fetch_add(1, std::memory_order_relaxed); }
+    void unpin() const { if (m_snap) m_snap->m_pins.fetch_sub(1, std::memory_order_release); }
+    const VolSurfaceSnapshot *m_snap = nullptr;
+};
+
+// Incremental strike x expiry volatility surface for one underlying.
+//
+// Each expiry keeps running weighted least-squares sums for its smile fit. A quote change
+// removes the point's old contribution and adds the new one, so updates cost O(1) and only
+// dirty expiries are refitted (a 3x3 solve) on commit(). Single writer; any number of readers
+// through snapshot(), which is lock-free: the current snapshot is a plain atomic pointer, readers
+// pin it with a counter, and commit() frees a replaced snapshot only once no reader is in the
+// middle of snapshot() and nobody holds it pinned. Readers must not outlive the surface.
+class VolatilitySurface
+{
+public:
+    explicit VolatilitySurface(const QString &underlying = QString());
+    ~VolatilitySurface();
+    VolatilitySurface(const VolatilitySurface &) = delete;
+    VolatilitySurface &operator=(const VolatilitySurface &) = delete;
+
+    QString underlying() const { return m_underlying; }
+
+    // Writer side.
+    void setExpiry(const QDate &expiry, double forward, double timeToExpiry);
+    // iv <= 0 / NaN removes the point. weight is typically vega, so wings count less.
+    void updatePoint(const QDate &expiry, double strike, double iv, double weight = 1.0);
+    void removeExpiry(const QDate &expiry);
+    // Pulls the out-of-the-money side of a solved chain (calls at/above F, puts below).
+    void updateFromChain(const OptionGreeksEngine &engine);
+    // Refits dirty expiries and publishes a new snapshot. Returns false when nothing changed.
+    bool commit(const QDateTime &asOf = QDateTime::currentDateTime());
+
+    // Reader side (any thread).
+    VolSurfaceRef snapshot() const;
+
+private:
+    struct Point { double x = 0.0, y = 0.0, w = 0.0; };
+    struct Slice {
+        double forward = 0.0;
+        double timeToExpiry = 0.0;
+        double center = 0.0;
+        bool hasCenter = false;
+        QHash<qint64, Point> points; // key: strike in paise
+        // Weighted sums over points: w * x^p for p = 0..4, w * y * x^p for p = 0..2
+        double sx[5] = {0, 0, 0, 0, 0};
+        double sy[3] = {0, 0, 0};
+        int updatesSinceRebuild = 0;
+        bool dirty = false;
+        SmileSlice fitted;
+    };
+
+    static void accumulate(Slice &s, const Point &p, double sign);
+    static void rebuildSums(Slice &s);
+    static void fit(const QDate &expiry, Slice &s);
+    void reclaim();
+
+    QString m_underlying;
+    QMap<QDate, Slice> m_slices;
+    bool m_structureChanged = false;
+    quint64 m_version = 0;
+    std::atomic<const VolSurfaceSnapshot*> m_current{nullptr};
+    mutable std::atomic<int> m_entering{0};          // readers between loading and pinning m_current
+    QVector<const VolSurfaceSnapshot*> m_retired;    // replaced, not yet freed (writer only)
+};
+
+#endif // VOLATILITYSURFACE_H
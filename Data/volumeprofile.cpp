@@ -0,0 +1,175 @@
+#include "Data/volumeprofile.h"
+
+#include <QtMath>
+
+VolumeProfile::VolumeProfile(double tickSize, int ticksPerBin, int tpoMinutes)
+    : m_tickSize(tickSize > 0.0 ? tickSize : 0.05)
+    , m_binSize(m_tickSize * qMax(1, ticksPerBin))
+    , m_tpoPeriodMs(qint64(qMax(1, tpoMinutes)) * 60000)
+{
+}
+
+void VolumeProfile::setSession(const QDate &session, const QDateTime &sessionStart)
+{
+    m_session = session;
+    m_sessionStartMs = sessionStart.isValid() ? sessionStart.toMSecsSinceEpoch() : 0;
+}
+
+// ---------- bins ----------
+qint64 VolumeProfile::binIndex(double price) const
+{
+    // Small epsilon so prices sitting exactly on a tick boundary don't fall into the bin below.
+    return qint64(qFloor(price / m_binSize + 1e-9));
+}
+
+int VolumeProfile::slot(qint64 bin)
+{
+    if (m_volume.isEmpty()) {
+        m_origin = bin;
+        m_volume.append(0.0);
+        m_tpo.append(0);
+        m_lastPeriod.append(-1);
+        return 0;
+    }
+    if (bin < m_origin) {
+        const int grow = int(m_origin - bin);
+        m_volume.insert(0, grow, 0.0);
+        m_tpo.insert(0, grow, 0);
+        m_lastPeriod.insert(0, grow, -1);
+        m_origin = bin;
+        if (m_poc >= 0) m_poc += grow;
+    }
+    const int i = int(bin - m_origin);
+    if (i >= m_volume.size()) {
+        const int grow = i + 1 - m_volume.size();
+        m_volume.insert(m_volume.size(), grow, 0.0);
+        m_tpo.insert(m_tpo.size(), grow, 0);
+        m_lastPeriod.insert(m_lastPeriod.size(), grow, -1);
+    }
+    return i;
+}
+
+void VolumeProfile::addToBin(int i, double volume)
+{
+    m_volume[i] += volume;
+    m_total += volume;
+    if (volume > 0.0 && (m_poc < 0 || m_volume[i] > m_volume[m_poc])) m_poc = i;
+}
+
+void VolumeProfile::markTpo(int i, int period)
+{
+    if (period < 0 || m_lastPeriod[i] == period) return;
+    m_lastPeriod[i] = period;
+    ++m_tpo[i];
+}
+
+int VolumeProfile::tpoPeriod(const QDateTime &ts) const
+{
+    if (!ts.isValid() || m_sessionStartMs == 0) return -1;
+    const qint64 dt = ts.toMSecsSinceEpoch() - m_sessionStartMs;
+    return dt < 0 ? 0 : int(dt / m_tpoPeriodMs);
+}
+
+void VolumeProfile::recomputePoc()
+{
+    m_poc = -1;
+    for (int i = 0; i < m_volume.size(); ++i)
+        if (m_volume[i] > 0.0 && (m_poc < 0 || m_volume[i] > m_volume[m_poc])) m_poc = i;
+}
+
+// ---------- updates ----------
+void VolumeProfile::addTrade(double price, double volume, const QDateTime &ts)
+{
+    if (!(price > 0.0) || !(volume > 0.0)) return;
+    const int i = slot(binIndex(price));
+    addToBin(i, volume);
+    markTpo(i, tpoPeriod(ts));
+}
+
+void VolumeProfile::spreadBar(const CandleData &bar, double sign)
+{
+    if (!(bar.low > 0.0) || bar.high < bar.low) return;
+    const qint64 lo = binIndex(bar.low);
+    const qint64 hi = binIndex(bar.high);
+    const double perBin = sign * double(bar.volume) / double(hi - lo + 1);
+    const int period = sign > 0 ? tpoPeriod(bar.timestamp) : -1;
+
+    const int first = slot(lo);     // growing at the low end first keeps `first` valid
+    const int last = slot(hi);
+    for (int i = first; i <= last; ++i) {
+        if (perBin != 0.0) addToBin(i, perBin);
+        markTpo(i, period);
+    }
+}
+
+void VolumeProfile::addBar(const CandleData &bar)
+{
+    spreadBar(bar, 1.0);
+}
+
+void VolumeProfile::removeBar(const CandleData &bar)
+{
+    if (m_volume.isEmpty()) return;
+    spreadBar(bar, -1.0);
+    recomputePoc();
+}
+
+bool VolumeProfile::merge(const VolumeProfile &other)
+{
+    if (other.isEmpty()) return true;
+    if (!qFuzzyCompare(other.m_binSize, m_binSize)) return false;
+
+    slot(other.m_origin);
+    slot(other.m_origin + other.m_volume.size() - 1);
+    const int offset = int(other.m_origin - m_origin);
+    for (int k = 0; k < other.m_volume.size(); ++k) {
+        m_volume[offset + k] += other.m_volume[k];
+        m_tpo[offset + k] += other.m_tpo[k];
+    }
+    m_total += other.m_total;
+    recomputePoc();
+    return true;
+}
+
+// ---------- reads ----------
+double VolumeProfile::pocPrice() const
+{
+    return m_poc >= 0 ? binPrice(m_poc) + 0.5 * m_binSize : 0.0;
+}
+
+double VolumeProfile::tpoPocPrice() const
+{
+    int best = -1;
+    for (int i = 0; i < m_tpo.size(); ++i)
+        if (m_tpo[i] > 0 && (best < 0 || m_tpo[i] > m_tpo[best])) best = i;
+    return best >= 0 ? binPrice(best) + 0.5 * m_binSize : 0.0;
+}
+
+// Standard expansion: from the POC, add whichever side's next two bins hold more volume until
+// the requested fraction of total volume is covered.
+ValueArea VolumeProfile::valueArea(double fraction) const
+{
+    ValueArea va;
+    va.totalVolume = m_total;
+    if (m_poc < 0 || !(m_total > 0.0)) return va;
+
+    const double target = m_total * qBound(0.0, fraction, 1.0);
+    const int n = m_volume.size();
+    int lo = m_poc, hi = m_poc;
+    double inArea = m_volume[m_poc];
+    while (inArea < target && (lo > 0 || hi < n - 1)) {
+        const double up = (hi + 1 < n ? m_volume[hi + 1] : 0.0) + (hi + 2 < n ? m_volume[hi + 2] : 0.0);
+        const double down = (lo - 1 >= 0 ? m_volume[lo - 1] : 0.0) + (lo - 2 >= 0 ? m_volume[lo - 2] : 0.0);
+        if ((up >= down && hi < n - 1) || lo == 0) {
+            for (int s = 0; s < 2 && hi < n - 1; ++s) inArea += m_volume[++hi];
+        } else {
+            for (int s = 0; s < 2 && lo > 0; ++s) inArea += m_volume[--lo];
+        }
+    }
+    va.poc = pocPrice();
+    va.val = binPrice(lo);
+    va.vah = binPrice(hi) + m_binSize;
+    va.volumeInArea = inArea;
+    va.valid = true;
+    return va;
+}
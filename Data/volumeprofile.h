@@ -0,0 +1,83 @@
+#ifndef VOLUMEPROFILE_H
+#define VOLUMEPROFILE_H
+
+#include <QVector>
+#include <QDate>
+#include <QDateTime>
+
+#include "Data/DataStructures/candle.h"
+
+// Point of control and value area of a profile (prices are bin mid-points).
+struct ValueArea {
+    double poc = 0.0;
+    double vah = 0.0;
+    double val = 0.0;
+    double volumeInArea = 0.0;
+    double totalVolume = 0.0;
+    bool valid = false;
+};
+
+// Volume-at-price histogram plus TPO (time-price opportunity) counts for one session, or a
+// composite of several sessions after merge().
+//
+// Bins are whole multiples of the instrument's tick size (binSize = tickSize * ticksPerBin) and
+// are stored contiguously, growing at either end as price explores, so updates never rebuild.
+// The volume POC is maintained on every add; the value area is expanded from the POC on demand.
+class VolumeProfile
+{
+public:
+    explicit VolumeProfile(double tickSize = 0.05, int ticksPerBin = 1,
+                           int tpoMinutes = 30);
+
+    // Session this profile belongs to; TPO periods count from sessionStart.
+    void setSession(const QDate &session, const QDateTime &sessionStart);
+    QDate session() const { return m_session; }
+
+    double binSize() const { return m_binSize; }
+    bool isEmpty() const { return m_volume.isEmpty(); }
+
+    // A trade/tick: all volume at one price.
+    void addTrade(double price, double volume, const QDateTime &ts);
+    // A bar: volume spread evenly over the bins between low and high, one TPO for each.
+    void addBar(const CandleData &bar);
+    // Backs out a bar's volume (e.g. a still-forming candle about to be re-sent). TPO marks stay.
+    void removeBar(const CandleData &bar);
+
+    // Adds another profile's volume and TPO counts (same bin size). Used for composites.
+    bool merge(const VolumeProfile &other);
+
+    double totalVolume() const { return m_total; }
+    double pocPrice() const;
+    double tpoPocPrice() const; // price with the most TPOs
+    ValueArea valueArea(double fraction = 0.70) const;
+
+    // Histogram export: one entry per bin, ascending price.
+    int binCount() const { return m_volume.size(); }
+    double binPrice(int i) const { return (m_origin + i) * m_binSize; }
+    double binVolume(int i) const { return m_volume.value(i); }
+    int binTpo(int i) const { return m_tpo.value(i); }
+
+private:
+    qint64 binIndex(double price) const;
+    int slot(qint64 bin);               // grows storage; returns vector index
+    void addToBin(int i, double volume);
+    void markTpo(int i, int period);
+    int tpoPeriod(const QDateTime &ts) const;
+    void spreadBar(const CandleData &bar, double sign);
+    void recomputePoc();
+
+    double m_tickSize;
+    double m_binSize;
+    qint64 m_tpoPeriodMs;
+    QDate m_session;
+    qint64 m_sessionStartMs = 0;
+
+    qint64 m_origin = 0;                // bin number of index 0
+    QVector<double> m_volume;
+    QVector<int> m_tpo;
+    QVector<int> m_lastPeriod;          // last TPO period counted per bin (-1 none)
+    double m_total = 0.0;
+    int m_poc = -1;
+};
+
+#endif // VOLUMEPROFILE_H
@@ -0,0 +1,134 @@
+#include "Data/vwapengine.h"
+#include "Utils/marketcalendar.h"
+
+#include <QtMath>
+
+// ---------- VwapStats ----------
+double VwapStats::stdDev() const
+{
+    if (!(sumV > 0.0)) return 0.0;
+    const double mean = sumPV / sumV;
+    const double var = sumP2V / sumV - mean * mean;
+    return var > 0.0 ? qSqrt(var) : 0.0;
+}
+
+void VwapStats::add(const QDateTime &ts, double price, double volume)
+{
+    if (samples == 0) start = ts;
+    last = ts;
+    sumPV += price * volume;
+    sumP2V += price * price * volume;
+    sumV += volume;
+    ++samples;
+
+    const double v = vwap();
+    if (samples == 1) {
+        high = low = v;
+    } else {
+        high = qMax(high, v);
+        low = qMin(low, v);
+    }
+    close = v;
+}
+
+// ---------- VwapEngine ----------
+VwapEngine::VwapEngine(int sessionsToKeep)
+    : m_sessionsToKeep(qMax(1, sessionsToKeep))
+{
+}
+
+void VwapEngine::reset()
+{
+    m_current = VwapStats();
+    m_currentBeforeLast = VwapStats();
+    m_sessionEndMs = 0;
+    m_lastMs = 0;
+    m_lastTs = QDateTime();
+    m_lastWasBar = false;
+    m_completed.clear();
+    for (auto it = m_anchors.begin(); it != m_anchors.end(); ++it) {
+        it.value().stats = VwapStats();
+        it.value().beforeLast = VwapStats();
+    }
+}
+
+bool VwapEngine::addBar(const CandleData &bar)
+{
+    if (bar.high < bar.low || bar.low < 0 || bar.close < 0) return false;
+    return add(bar.timestamp, (bar.high + bar.low + bar.close) / 3.0, double(bar.volume), true);
+}
+
+bool VwapEngine::addTrade(const QDateTime &ts, double price, qlonglong volume)
+{
+    return add(ts, price, double(volume), false);
+}
+
+bool VwapEngine::add(const QDateTime &ts, double price, double volume, bool isBar)
+{
+    if (!ts.isValid() || !qIsFinite(price) || !(volume > 0.0)) return false;
+    const qint64 ms = ts.toMSecsSinceEpoch();
+
+    bool replace = false;
+    if (m_lastTs.isValid()) {
+        if (ms < m_lastMs) return false;
+        replace = isBar && m_lastWasBar && ms == m_lastMs;
+    }
+
+    if (replace) {
+        m_current = m_currentBeforeLast;
+        for (auto it = m_anchors.begin(); it != m_anchors.end(); ++it)
+            it.value().stats = it.value().beforeLast;
+    } else if (ms >= m_sessionEndMs) {
+        rollSession(ts);
+    }
+
+    if (isBar) {
+        m_currentBeforeLast = m_current;
+        for (auto it = m_anchors.begin(); it != m_anchors.end(); ++it)
+            it.value().beforeLast = it.value().stats;
+    }
+
+    m_current.add(ts, price, volume);
+    for (auto it = m_anchors.begin(); it != m_anchors.end(); ++it) {
+        Anchor &a = it.value();
+        if (ms < a.fromMs) continue;
+        if (a.stats.samples == 0) a.stats.session = m_current.session;
+        a.stats.add(ts, price, volume);
+    }
+
+    m_lastMs = ms;
+    m_lastTs = ts;
+    m_lastWasBar = isBar;
+    return true;
+}
+
+void VwapEngine::rollSession(const QDateTime &ts)
+{
+    if (m_current.isValid()) {
+        m_completed.insert(m_current.session, m_current);
+        while (m_completed.size() > m_sessionsToKeep) m_completed.erase(m_completed.begin());
+    }
+    const MarketCalendar *cal = MarketCalendar::instance();
+    m_current = VwapStats();
+    m_current.session = cal->tradingDateFor(ts);
+    m_currentBeforeLast = m_current;
+    m_sessionEndMs = cal->sessionEndMsecs(m_current.session);
+}
+
+VwapStats VwapEngine::session(const QDate &tradingDate) const
+{
+    if (m_current.session == tradingDate) return m_current;
+    return m_completed.value(tradingDate);
+}
+
+void VwapEngine::setAnchor(const QString &name, const QDateTime &from)
+{
+    Anchor a;
+    a.fromMs = from.isValid() ? from.toMSecsSinceEpoch() : 0;
+    m_anchors.insert(name, a);
+}
+
+VwapStats VwapEngine::anchor(const QString &name) const
+{
+    return m_anchors.value(name).stats;
+}
@@ -0,0 +1,94 @@
+#ifndef VWAPENGINE_H
+#define VWAPENGINE_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QDate>
+#include <QDateTime>
+#include <QStringList>
+
+#include "Data/DataStructures/candle.h"
+
+// Running volume-weighted sums for one VWAP (a trading session or an anchor).
+// Variance is the volume-weighted variance of price around the VWAP, so the bands are
+// vwap +/- k * stdDev. high/low/close track the VWAP line itself, not price.
+struct VwapStats {
+    QDate session;          // trading date (session VWAPs); anchors: date of the first bar
+    QDateTime start;        // first bar/trade included
+    QDateTime last;         // most recent bar/trade included
+    double sumPV = 0.0;     // sum(price * volume)
+    double sumP2V = 0.0;    // sum(price^2 * volume)
+    double sumV = 0.0;
+    double high = 0.0;      // highest VWAP reached
+    double low = 0.0;       // lowest VWAP reached
+    double close = 0.0;     // latest VWAP
+    int samples = 0;
+
+    bool isValid() const { return sumV > 0.0; }
+    double vwap() const { return sumV > 0.0 ? sumPV / sumV : 0.0; }
+    double stdDev() const;
+    double upperBand(double k) const { return vwap() + k * stdDev(); }
+    double lowerBand(double k) const { return vwap() - k * stdDev(); }
+
+    void add(const QDateTime &ts, double price, double volume);
+};
+
+// Streaming session VWAP for one instrument, plus any number of anchored VWAPs.
+//
+// Bars/trades must arrive in time order. Each one is O(1) for the session and O(anchors)
+// overall: the session rolls when the timestamp passes MarketCalendar's session end for the
+// current trading date (one integer compare), and completed sessions are kept for lookup
+// (e.g. previous-day VWAP H/L/C). Re-sending the latest bar (a still-forming candle)
+// replaces its earlier contribution.
+class VwapEngine
+{
+public:
+    explicit VwapEngine(int sessionsToKeep = 10);
+
+    void reset();
+
+    // Uses the typical price (H+L+C)/3. Returns false for out-of-order or unusable bars.
+    bool addBar(const CandleData &bar);
+    // Individual trades/ticks: price and the volume traded since the previous call.
+    bool addTrade(const QDateTime &ts, double price, qlonglong volume);
+
+    QDateTime lastTimestamp() const { return m_lastTs; }
+
+    // Sessions
+    const VwapStats &current() const { return m_current; }
+    VwapStats session(const QDate &tradingDate) const; // current or a completed session
+    QList<QDate> sessionDates() const { return m_completed.keys(); }
+
+    // Anchored VWAPs: accumulate from the first bar at or after `from`. An anchor set in the
+    // past only sees bars fed after it is created (replay history to backfill it).
+    void setAnchor(const QString &name, const QDateTime &from);
+    // Anchors at the next bar/trade, for event-driven anchors (order fill, breakout, ...).
+    void anchorAtNext(const QString &name) { setAnchor(name, m_lastTs.addMSecs(1)); }
+    void removeAnchor(const QString &name) { m_anchors.remove(name); }
+    bool hasAnchor(const QString &name) const { return m_anchors.contains(name); }
+    VwapStats anchor(const QString &name) const;
+    QStringList anchorNames() const { return m_anchors.keys(); }
+
+private:
+    struct Anchor {
+        qint64 fromMs = 0;
+        VwapStats stats;
+        VwapStats beforeLast; // state before the latest bar, for in-place revisions
+    };
+
+    bool add(const QDateTime &ts, double price, double volume, bool replaceLast);
+    void rollSession(const QDateTime &ts);
+
+    int m_sessionsToKeep;
+    VwapStats m_current;
+    VwapStats m_currentBeforeLast;
+    qint64 m_sessionEndMs = 0;
+    qint64 m_lastMs = 0;
+    QDateTime m_lastTs;
+    bool m_lastWasBar = false;
+    QMap<QDate, VwapStats> m_completed;
+    QMap<QString, Anchor> m_anchors;
+};
+
+#endif // VWAPENGINE_H
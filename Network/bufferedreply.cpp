@@ -0,0 +1,59 @@
+#include "Network/bufferedreply.h"
+
+#include <cstring>
+
+ReplySnapshot ReplySnapshot::capture(QNetworkReply *reply)
+{
+    ReplySnapshot s;
+    s.request = reply->request();
+    s.operation = reply->operation();
+    s.error = reply->error();
+    s.errorString = reply->errorString();
+    s.httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    s.httpReason = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray();
+    s.headers = reply->rawHeaderPairs();
+    s.body = reply->readAll();
+    return s;
+}
+
+ReplySnapshot ReplySnapshot::cancelled(const QNetworkRequest &request)
+{
+    ReplySnapshot s;
+    s.request = request;
+    s.error = QNetworkReply::OperationCanceledError;
+    s.errorString = QStringLiteral("Operation canceled");
+    return s;
+}
+
+BufferedReply::BufferedReply(const ReplySnapshot &snapshot, QObject *parent)
+    : QNetworkReply(parent), m_body(snapshot.body)
+{
+    setRequest(snapshot.request);
+    setUrl(snapshot.request.url());
+    setOperation(snapshot.operation);
+    if (snapshot.httpStatus) {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, snapshot.httpStatus);
+        setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, snapshot.httpReason);
+    }
+    for (const RawHeaderPair &h : snapshot.headers)
+        setRawHeader(h.first, h.second);
+    if (snapshot.error != NoError)
+        setError(snapshot.error, snapshot.errorString);
+
+    open(QIODevice::ReadOnly);
+    setFinished(true);
+}
+
+qint64 BufferedReply::bytesAvailable() const
+{
+    return (m_body.size() - m_offset) + QNetworkReply::bytesAvailable();
+}
+
+qint64 BufferedReply::readData(char *data, qint64 maxSize)
+{
+    const qint64 n = qMin(maxSize, qint64(m_body.size()) - m_offset);
+    if (n <= 0) return -1;     // end of body
+    std::memcpy(data, m_body.constData() + m_offset, size_t(n));
+    m_offset += n;
+    return n;
+}
@@ -0,0 +1,56 @@
+#ifndef BUFFEREDREPLY_H
+#define BUFFEREDREPLY_H
+
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QByteArray>
+#include <QList>
+
+/**
+ * @brief Everything a reply handler reads from a finished QNetworkReply, captured once.
+ *
+ * The body is an implicitly shared QByteArray, so any number of BufferedReply copies of one
+ * snapshot read the same bytes without copying them.
+ */
+struct ReplySnapshot
+{
+    QNetworkRequest request;
+    QNetworkAccessManager::Operation operation = QNetworkAccessManager::GetOperation;
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+    QString errorString;
+    int httpStatus = 0;
+    QByteArray httpReason;
+    QList<QNetworkReply::RawHeaderPair> headers;
+    QByteArray body;
+
+    /** @brief Reads the whole body of a finished reply (the reply itself is left drained). */
+    static ReplySnapshot capture(QNetworkReply *reply);
+    /** @brief Result of a request cancelled before it produced a reply of its own. */
+    static ReplySnapshot cancelled(const QNetworkRequest &request);
+};
+
+/**
+ * @brief Read-only, already finished QNetworkReply that replays a ReplySnapshot.
+ *
+ * HttpManager hands these out for coalesced and cached GETs so every receiver gets its own reply
+ * object (to read and deleteLater()) exactly as if it had been sent alone.
+ */
+class BufferedReply : public QNetworkReply
+{
+    Q_OBJECT
+public:
+    explicit BufferedReply(const ReplySnapshot &snapshot, QObject *parent = nullptr);
+
+    void abort() override {}
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+private:
+    QByteArray m_body;
+    qint64 m_offset = 0;
+};
+
+#endif // BUFFEREDREPLY_H
@@ -1,10 +1,37 @@
 #include "Network/httpmanager.h"
-#include "Network/kiteconnectapi.h" // Include for RequestType enum
+#include "Utils/logger.h"
+#include "Utils/latencymonitor.h"
+#include "Utils/tracer.h"
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QUrlQuery>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <QSslConfiguration>
+#include <QThread>
 #include <QDebug>
-#include <QVariant> // For storing RequestType property
+#include <utility>
+
+// Round-trip histogram per request type (send to finished), created once per type.
+static LatencyHistogram *roundTripStage(RequestType type) {
+    static const char *const names[] = {
+        "http.invalid", "http.instruments", "http.historical", "http.session", "http.profile",
+        "http.margins", "http.order", "http.quote", "http.holdings", "http.positions"
+    };
+    const int n = int(sizeof(names) / sizeof(names[0]));
+    static LatencyHistogram *stages[n] = {};
+    const int i = (int(type) >= 0 && int(type) < n) ? int(type) : 0;
+    if (!stages[i]) stages[i] = LatencyMonitor::instance()->stage(names[i]);
+    return stages[i];
+}
+
+// Time spent waiting for the limiter (enqueue to send)
+static LatencyHistogram *queueWaitStage() {
+    static LatencyHistogram *stage = LatencyMonitor::instance()->stage("http.queueWait");
+    return stage;
+}
+
+static const qint64 kNanosPerSecond = 1000000000LL;
 
 HttpManager::HttpManager(QObject *parent) : QObject(parent) {
     // Initialize the network manager
@@ -12,50 +39,614 @@ HttpManager::HttpManager(QObject *parent) : QObject(parent) {
 
     // Setup any global network configurations if necessary (e.g., proxy, SSL)
     // Example: m_networkManager->setStrictTransportSecurityEnabled(true);
+
+    // Timers first: setClassLimit() below pumps, and pump() (re)arms m_pumpTimer
+    m_pumpTimer = new QTimer(this);
+    m_pumpTimer->setSingleShot(true);
+    m_pumpTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_pumpTimer, &QTimer::timeout, this, &HttpManager::pump);
+
+    // Checks twice per keep-alive interval, so an idle origin is pinged within 1.5 intervals
+    m_keepAliveTimer = new QTimer(this);
+    connect(m_keepAliveTimer, &QTimer::timeout, this, &HttpManager::keepAlive);
+    m_keepAliveTimer->start(m_keepAliveMs / 2);
+
+    // Kite Connect limits: orders 10/s, quotes 1/s, historical 3/s, everything else 10/s
+    setClassLimit(EndpointClass::Orders, 10.0);
+    setClassLimit(EndpointClass::Quotes, 1.0);
+    setClassLimit(EndpointClass::Account, 10.0);
+    setClassLimit(EndpointClass::Historical, 3.0);
+
+    // Orders: short timeout, one retry only when the order provably never reached Kite
+    m_policies[int(EndpointClass::Orders)] = Policy{ 7000, 2, 200, 1000, 5, 5000 };
+    // Quotes are polled again anyway; retrying stale snapshots hard is pointless
+    m_policies[int(EndpointClass::Quotes)] = Policy{ 3000, 2, 250, 1000, 5, 5000 };
+    // Instruments CSV is several MB; the timeout is per stall, not per transfer
+    m_policies[int(EndpointClass::Account)] = Policy{ 20000, 3, 500, 8000, 5, 10000 };
+    m_policies[int(EndpointClass::Historical)] = Policy{ 10000, 4, 1000, 15000, 5, 15000 };
 }
 
 HttpManager::~HttpManager() {
     // m_networkManager is deleted automatically by Qt's parent-child relationship
 }
 
-void HttpManager::sendGetRequest(const QNetworkRequest &request, RequestType requestType) {
-    qDebug() << "HttpManager::sendGetRequest: url, requestType =" << request.url() << ", " << static_cast<int>(requestType);
-    QNetworkReply *reply = m_networkManager->get(request);
+// Runs f on the thread HttpManager lives on: directly if already there, else queued
+template <typename F>
+void HttpManager::runOnOwnThread(F &&f) {
+    if (QThread::currentThread() == thread())
+        f();
+    else
+        QMetaObject::invokeMethod(this, std::forward<F>(f), Qt::QueuedConnection);
+}
 
-    if (reply) {
-        // Store the requestType as a custom property on the reply object for later retrieval
-        reply->setProperty("requestType", QVariant::fromValue(requestType));
+HttpManager::EndpointClass HttpManager::endpointClassOf(RequestType type) {
+    switch (type) {
+    case RequestType::OrderRequest:          return EndpointClass::Orders;
+    case RequestType::QuoteRequest:          return EndpointClass::Quotes;
+    case RequestType::HistoricalDataRequest: return EndpointClass::Historical;
+    default:                                 return EndpointClass::Account;
+    }
+}
 
-        // Connect the finished signal to our internal slot
-        connect(reply, &QNetworkReply::finished, this, &HttpManager::onReplyFinished);
+void HttpManager::setClassLimit(EndpointClass cls, double requestsPerSecond, double burst) {
+    runOnOwnThread([this, cls, requestsPerSecond, burst]() {
+        Bucket &b = m_buckets[int(cls)];
+        b.nominalRate = qMax(0.01, requestsPerSecond);
+        b.rate = b.nominalRate;
+        b.burst = qMax(1.0, burst);
+        b.tokens = qMin(b.tokens, b.burst);
+        pump();
+    });
+}
 
-        // Optional: Connect other signals like errorOccurred or sslErrors if needed
-        // connect(reply, &QNetworkReply::errorOccurred, this, &HttpManager::handleNetworkError);
-    } else {
-        qWarning() << "HttpManager: Failed to create GET reply object for URL:" << request.url();
-        // Consider emitting an immediate error signal if creation fails
+void HttpManager::setMaxConnections(int connections) {
+    runOnOwnThread([this, connections]() {
+        m_maxConnections = qMax(1, connections);
+        pump();
+    });
+}
+
+void HttpManager::setCacheTtl(EndpointClass cls, int ttlMs) {
+    runOnOwnThread([this, cls, ttlMs]() {
+        m_cacheTtlMs[int(cls)] = qMax(0, ttlMs);
+        if (ttlMs <= 0) dropCached(cls);
+    });
+}
+
+void HttpManager::clearCache() {
+    runOnOwnThread([this]() { m_cache.clear(); });
+}
+
+void HttpManager::setPolicy(EndpointClass cls, const Policy &policy) {
+    runOnOwnThread([this, cls, policy]() { m_policies[int(cls)] = policy; });
+}
+
+QString HttpManager::endpointClassName(EndpointClass cls) {
+    static const char *const names[] = { "orders", "quotes", "account", "historical" };
+    return QString::fromLatin1(names[qBound(0, int(cls), int(EndpointClass::Count) - 1)]);
+}
+
+void HttpManager::applyConfig(const QJsonObject &config) {
+    if (QThread::currentThread() != thread()) {
+        runOnOwnThread([this, config]() { applyConfig(config); });
+        return;
+    }
+    const QJsonObject ttl = config.value("cache_ttl_ms").toObject();
+    for (int c = 0; c < int(EndpointClass::Count); ++c) {
+        const QString name = endpointClassName(EndpointClass(c));
+        if (ttl.contains(name)) setCacheTtl(EndpointClass(c), ttl.value(name).toInt());
     }
+
+    const QJsonObject policies = config.value("policies").toObject();
+    for (int c = 0; c < int(EndpointClass::Count); ++c) {
+        const QJsonObject o = policies.value(endpointClassName(EndpointClass(c))).toObject();
+        if (o.isEmpty()) continue;
+        Policy &p = m_policies[c];
+        p.timeoutMs = qMax(0, o.value("timeout_ms").toInt(p.timeoutMs));
+        p.maxAttempts = qMax(1, o.value("max_attempts").toInt(p.maxAttempts));
+        p.backoffMs = qMax(0, o.value("backoff_ms").toInt(p.backoffMs));
+        p.maxBackoffMs = qMax(p.backoffMs, o.value("max_backoff_ms").toInt(p.maxBackoffMs));
+        p.breakerFailures = qMax(0, o.value("breaker_failures").toInt(p.breakerFailures));
+        p.breakerOpenMs = qMax(100, o.value("breaker_open_ms").toInt(p.breakerOpenMs));
+    }
+
+    m_warmConnections = qBound(1, config.value("warm_connections").toInt(m_warmConnections), m_maxConnections);
+    if (config.contains("keepalive_ms")) setKeepAliveInterval(config.value("keepalive_ms").toInt());
 }
 
-void HttpManager::sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestType requestType) {
-    qDebug() << "HttpManager::sendPostRequest: url, requestType =" << request.url() << ", " << static_cast<int>(requestType);
-    QNetworkReply *reply = m_networkManager->post(request, data);
+int HttpManager::countQueued() const {
+    int n = 0;
+    for (const FairQueue &q : m_queues) n += q.size;
+    return n;
+}
 
-    if (reply) {
-        // Store the requestType as a custom property
-        reply->setProperty("requestType", QVariant::fromValue(requestType));
+// ---------- token buckets ----------
 
-        // Connect the finished signal
-        connect(reply, &QNetworkReply::finished, this, &HttpManager::onReplyFinished);
+void HttpManager::Bucket::refill(qint64 nowNs) {
+    if (lastNs == 0) {
+        tokens = burst;
+    } else if (nowNs > lastNs) {
+        tokens = qMin(burst, tokens + rate * double(nowNs - lastNs) / kNanosPerSecond);
+    }
+    lastNs = nowNs;
+}
+
+qint64 HttpManager::Bucket::readyAtNs(qint64 nowNs) const {
+    qint64 at = nowNs;
+    if (tokens < 1.0)
+        at += qint64((1.0 - tokens) / rate * kNanosPerSecond) + 1;
+    return qMax(at, pausedUntilNs);
+}
 
-        // Optional: Connect other signals
+// ---------- queueing ----------
+
+quint64 HttpManager::sendGetRequest(const QNetworkRequest &request, RequestContext context) {
+    const quint64 id = m_nextRequestId.fetch_add(1, std::memory_order_relaxed);
+    if (!context.enqueuedNs) context.enqueuedNs = LatencyMonitor::nowNanos();
+    context.requestId = id;
+    Pending pending;
+    pending.request = request;
+    pending.context = std::move(context);
+    runOnOwnThread([this, pending]() mutable { enqueue(std::move(pending)); });
+    return id;
+}
+
+quint64 HttpManager::sendGetRequest(const QNetworkRequest &request, RequestType requestType) {
+    RequestContext context;
+    context.type = requestType;
+    context.priority = defaultPriorityFor(requestType);
+    return sendGetRequest(request, std::move(context));
+}
+
+quint64 HttpManager::sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestContext context) {
+    const quint64 id = m_nextRequestId.fetch_add(1, std::memory_order_relaxed);
+    if (!context.enqueuedNs) context.enqueuedNs = LatencyMonitor::nowNanos();
+    context.requestId = id;
+    Pending pending;
+    pending.post = true;
+    pending.request = request;
+    pending.body = data;
+    pending.context = std::move(context);
+    runOnOwnThread([this, pending]() mutable { enqueue(std::move(pending)); });
+    return id;
+}
+
+quint64 HttpManager::sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestType requestType) {
+    RequestContext context;
+    context.type = requestType;
+    context.priority = defaultPriorityFor(requestType);
+    return sendPostRequest(request, data, std::move(context));
+}
+
+// Network thread: answers from the cache, joins an identical GET or queues the request
+void HttpManager::enqueue(Pending &&pending) {
+    RequestContext &context = pending.context;
+    const quint64 id = context.requestId;
+
+    if (!pending.post) {
+        const QByteArray key = coalesceKey(pending.request);
+        auto hit = m_cache.find(key);
+        if (hit != m_cache.end()) {
+            if (hit->expiresNs > LatencyMonitor::nowNanos()) {
+                // Answered from the cache; delivered from the event loop like a network reply
+                ++m_cacheHits;
+                deliverLater(hit->snapshot, context);
+                return;
+            }
+            m_cache.erase(hit);
+        }
+        auto waiting = m_waiters.find(key);
+        if (waiting != m_waiters.end()) {
+            // The same GET is already queued or in flight: share its reply
+            ++m_coalesced;
+            waiting->followers.append(std::move(context));
+            return;
+        }
+    }
+
+    // Shed load while the class's circuit is open (queued requests keep waiting for the probe)
+    const EndpointClass cls = endpointClassOf(context.type);
+    const Breaker &breaker = m_breakers[int(cls)];
+    if (breaker.open && LatencyMonitor::nowNanos() < breaker.openUntilNs) {
+        ReplySnapshot shed;
+        shed.request = pending.request;
+        shed.operation = pending.post ? QNetworkAccessManager::PostOperation : QNetworkAccessManager::GetOperation;
+        shed.error = QNetworkReply::ServiceUnavailableError;
+        shed.errorString = QString("Circuit open: %1 requests are failing, not sent").arg(endpointClassName(cls));
+        deliverLater(shed, context);
+        return;
+    }
+
+    if (!pending.post)
+        m_waiters.insert(coalesceKey(pending.request), Waiters{ id, pending.request, {} });
+    pushQueued(std::move(pending));
+    pump();
+}
+
+// Puts a request behind its priority and caller (new requests and retries alike)
+void HttpManager::pushQueued(Pending &&pending) {
+    const RequestContext &context = pending.context;
+    const int p = qBound(0, int(context.priority), 3);
+    FairQueue &q = m_queues[p];
+    auto fifo = q.byCaller.find(context.caller);
+    if (fifo == q.byCaller.end()) {
+        q.rotation.append(context.caller);
+        fifo = q.byCaller.insert(context.caller, QQueue<Pending>());
+    }
+    fifo->enqueue(std::move(pending));
+    ++q.size;
+}
+
+// In-flight ceiling for a priority: the last slots are kept free for more urgent requests
+int HttpManager::slotLimit(RequestPriority priority) const {
+    static const int reserve[] = { 0, 1, 1, 2 };
+    return qMax(1, m_maxConnections - reserve[qBound(0, int(priority), 3)]);
+}
+
+void HttpManager::pump() {
+    const qint64 now = LatencyMonitor::nowNanos();
+    qint64 wakeAt = 0;  // earliest time a token-blocked request becomes sendable
+
+    for (bool sent = true; sent; ) {
+        sent = false;
+        for (int p = 0; p < 4 && !sent; ++p) {
+            FairQueue &q = m_queues[p];
+            if (q.size == 0) continue;
+            // Limits shrink with priority, so nothing below this one can go either
+            if (m_inFlight.size() >= slotLimit(RequestPriority(p))) break;
+
+            // Round-robin over callers; skip those whose class has no token yet or is shed
+            for (int i = 0; i < q.rotation.size(); ++i) {
+                const QString caller = q.rotation.at(i);
+                auto fifo = q.byCaller.find(caller);
+                const EndpointClass cls = endpointClassOf(fifo->head().context.type);
+                Breaker &breaker = m_breakers[int(cls)];
+                if (breaker.open) {
+                    if (now < breaker.openUntilNs) {
+                        if (!wakeAt || breaker.openUntilNs < wakeAt) wakeAt = breaker.openUntilNs;
+                        continue;
+                    }
+                    if (breaker.probeId) continue;   // half-open: one probe at a time
+                }
+                Bucket &b = m_buckets[int(cls)];
+                b.refill(now);
+                if (b.tokens < 1.0 || now < b.pausedUntilNs) {
+                    const qint64 at = b.readyAtNs(now);
+                    if (!wakeAt || at < wakeAt) wakeAt = at;
+                    continue;
+                }
+                b.tokens -= 1.0;
+                Pending pending = fifo->dequeue();
+                q.rotation.removeAt(i);
+                if (fifo->isEmpty()) q.byCaller.erase(fifo);
+                else q.rotation.append(caller);
+                --q.size;
+
+                if (breaker.open) breaker.probeId = pending.context.requestId;
+                dispatch(std::move(pending));
+                sent = true;
+                break;
+            }
+        }
+    }
+
+    const int queued = countQueued();
+    m_queuedGauge.store(queued, std::memory_order_relaxed);
+    m_inFlightGauge.store(int(m_inFlight.size()), std::memory_order_relaxed);
+    TRACE_COUNTER("http.queued", queued);
+    if (wakeAt) {
+        const qint64 ms = (wakeAt - now + 999999) / 1000000;
+        m_pumpTimer->start(int(qBound<qint64>(0, ms, 60000)));
     } else {
-        qWarning() << "HttpManager: Failed to create POST reply object for URL:" << request.url();
+        // Anything still queued is waiting for a connection slot; onReplyFinished pumps again
+        m_pumpTimer->stop();
+    }
+}
+
+// Hands a request to the network and keeps it with the reply until it finishes
+void HttpManager::dispatch(Pending &&pending) {
+    TRACE_ZONE("http", "HttpManager::dispatch");
+    RequestContext &context = pending.context;
+    LOG_DEBUG("HttpManager::dispatch: #{} {} type {} attempt {}", context.requestId, pending.request.url().path(),
+              context.type, context.attempt);
+    // A stalled transfer is aborted so it gives its connection slot back
+    pending.request.setTransferTimeout(m_policies[int(endpointClassOf(context.type))].timeoutMs);
+    pending.request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    QNetworkReply *reply = pending.post ? m_networkManager->post(pending.request, pending.body)
+                                        : m_networkManager->get(pending.request);
+    if (!reply) {
+        qWarning() << "HttpManager: Failed to create reply object for URL:" << pending.request.url();
+        for (Breaker &breaker : m_breakers)
+            if (breaker.probeId == context.requestId) breaker.probeId = 0;
+        // Fail the caller and everyone who joined it, and free the key for the next identical GET
+        ReplySnapshot failed;
+        failed.request = pending.request;
+        failed.operation = pending.post ? QNetworkAccessManager::PostOperation : QNetworkAccessManager::GetOperation;
+        failed.error = QNetworkReply::UnknownNetworkError;
+        failed.errorString = QString("Could not create a network reply for %1").arg(pending.request.url().path());
+        QList<RequestContext> followers;
+        if (!pending.post) {
+            auto w = m_waiters.find(coalesceKey(pending.request));
+            if (w != m_waiters.end() && w->leaderId == context.requestId) {
+                followers = std::move(w->followers);
+                m_waiters.erase(w);
+            }
+        }
+        deliverLater(failed, context);
+        for (const RequestContext &follower : std::as_const(followers))
+            deliverLater(failed, follower);
+        return;
+    }
+
+    context.sentNs = LatencyMonitor::nowNanos();
+    if (context.attempt == 1)
+        queueWaitStage()->record(context.sentNs - context.enqueuedNs);
+    if (Tracer::enabled() && !context.traceFlow) {
+        // Flow arrow from here to whoever finally consumes the response (retries included)
+        context.traceFlow = Tracer::newFlowId();
+        TRACE_FLOW_BEGIN("http", "request", context.traceFlow);
+    }
+    auto warm = m_warmOrigins.find(originKey(pending.request.url()));
+    if (warm != m_warmOrigins.end()) warm->lastActivityNs = context.sentNs;
+    m_inFlight.insert(reply, std::move(pending));
+
+    // Connect the finished signal to our internal slot
+    connect(reply, &QNetworkReply::finished, this, &HttpManager::onReplyFinished);
+    // Only emitted when no pooled connection was free and a new socket had to be opened
+    connect(reply, &QNetworkReply::socketStartedConnecting, this, [this, reply]() {
+        auto it = m_inFlight.find(reply);
+        if (it != m_inFlight.end()) it->freshConnection = true;
+    });
+}
+
+void HttpManager::cancel(quint64 requestId) {
+    runOnOwnThread([this, requestId]() {
+        if (!cancelNow(requestId))
+            LOG_DEBUG("HttpManager::cancel: #{} is not queued or in flight", requestId);
+    });
+}
+
+bool HttpManager::cancelNow(quint64 requestId) {
+    // Waiting on someone else's identical GET: only this caller drops out
+    for (auto w = m_waiters.begin(); w != m_waiters.end(); ++w) {
+        for (int i = 0; i < w->followers.size(); ++i) {
+            if (w->followers.at(i).requestId != requestId) continue;
+            deliver(ReplySnapshot::cancelled(w->request), w->followers.takeAt(i));
+            return true;
+        }
+    }
+    // Sent it for others too: the first follower takes the request over
+    if (handOverLeadership(requestId))
+        return true;
+
+    for (auto it = m_inFlight.constBegin(); it != m_inFlight.constEnd(); ++it) {
+        if (it.value().context.requestId == requestId) {
+            m_cancelling.insert(requestId);  // not a timeout: never retried
+            it.key()->abort(); // emits finished() -> onReplyFinished
+            return true;
+        }
+    }
+    // Backing off before a retry
+    for (auto it = m_retrying.begin(); it != m_retrying.end(); ++it) {
+        if (it.value().context.requestId != requestId) continue;
+        Pending pending = std::move(it.value());
+        m_retrying.erase(it);
+        if (!pending.post) m_waiters.remove(coalesceKey(pending.request));
+        deliver(ReplySnapshot::cancelled(pending.request), std::move(pending.context));
+        return true;
+    }
+    // Still queued: it never reaches the network, the caller gets its usual cancelled reply
+    for (FairQueue &q : m_queues) {
+        for (auto fifo = q.byCaller.begin(); fifo != q.byCaller.end(); ++fifo) {
+            for (int i = 0; i < fifo->size(); ++i) {
+                if (fifo->at(i).context.requestId != requestId) continue;
+                Pending pending = fifo->takeAt(i);
+                --q.size;
+                if (fifo->isEmpty()) {
+                    q.rotation.removeOne(fifo.key());
+                    q.byCaller.erase(fifo);
+                }
+                if (!pending.post) m_waiters.remove(coalesceKey(pending.request));
+                deliver(ReplySnapshot::cancelled(pending.request), std::move(pending.context));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Cancelling the caller whose GET others joined: the request keeps going under the first
+// follower's context and only the original caller is answered with a cancellation
+bool HttpManager::handOverLeadership(quint64 requestId) {
+    for (auto w = m_waiters.begin(); w != m_waiters.end(); ++w) {
+        if (w->leaderId != requestId || w->followers.isEmpty()) continue;
+
+        RequestContext *owner = nullptr;
+        for (auto it = m_inFlight.begin(); it != m_inFlight.end() && !owner; ++it)
+            if (it.value().context.requestId == requestId) owner = &it.value().context;
+        for (auto it = m_retrying.begin(); it != m_retrying.end() && !owner; ++it)
+            if (it.value().context.requestId == requestId) owner = &it.value().context;
+        for (int p = 0; p < 4 && !owner; ++p) {
+            for (auto fifo = m_queues[p].byCaller.begin(); fifo != m_queues[p].byCaller.end() && !owner; ++fifo)
+                for (Pending &pending : *fifo)
+                    if (pending.context.requestId == requestId) { owner = &pending.context; break; }
+        }
+        if (!owner) return false;
+
+        RequestContext next = w->followers.takeFirst();
+        next.sentNs = owner->sentNs;
+        next.traceFlow = owner->traceFlow;
+        next.attempt = owner->attempt;
+        w->leaderId = next.requestId;
+        for (Breaker &breaker : m_breakers)
+            if (breaker.probeId == requestId) breaker.probeId = next.requestId;
+        RequestContext previous = std::exchange(*owner, std::move(next));
+        previous.traceFlow = 0;
+        deliver(ReplySnapshot::cancelled(w->request), std::move(previous));
+        return true;
+    }
+    return false;
+}
+
+// ---------- coalescing and cache ----------
+
+// Identical GETs: same encoded URL sent with the same credentials
+QByteArray HttpManager::coalesceKey(const QNetworkRequest &request) {
+    QByteArray key = request.url().toEncoded();
+    key += '\n';
+    key += request.rawHeader("Authorization");
+    return key;
+}
+
+// Same, from the event loop: for answers not tied to a reply (cache hits, shed or unsendable requests)
+void HttpManager::deliverLater(const ReplySnapshot &snapshot, const RequestContext &context) {
+    QMetaObject::invokeMethod(this, [this, snapshot, context]() { deliver(snapshot, context); },
+                              Qt::QueuedConnection);
+}
+
+// Hands one receiver its own reply object over a shared snapshot
+void HttpManager::deliver(const ReplySnapshot &snapshot, RequestContext context) {
+    if (!context.sentNs) context.sentNs = LatencyMonitor::nowNanos();
+    TRACE_FLOW_STEP("http", "request", context.traceFlow);
+    TraceFlowScope flowScope(context.traceFlow);
+    emit requestFinished(new BufferedReply(snapshot, this), context);
+}
+
+void HttpManager::storeInCache(const QByteArray &key, const ReplySnapshot &snapshot, EndpointClass cls) {
+    const qint64 now = LatencyMonitor::nowNanos();
+    for (auto it = m_cache.begin(); it != m_cache.end(); ) {
+        if (it->expiresNs <= now) it = m_cache.erase(it);
+        else ++it;
+    }
+    m_cache.insert(key, CacheEntry{ snapshot, cls, now + qint64(m_cacheTtlMs[int(cls)]) * 1000000 });
+}
+
+void HttpManager::dropCached(EndpointClass cls) {
+    for (auto it = m_cache.begin(); it != m_cache.end(); ) {
+        if (it->cls == cls) it = m_cache.erase(it);
+        else ++it;
+    }
+}
+
+// ---------- failure policy ----------
+
+// Whether a failed reply is sent again. GETs are idempotent and retried on anything transient;
+// POSTs only when Kite cannot have acted on them.
+bool HttpManager::shouldRetry(const Pending &pending, QNetworkReply *reply, bool timedOut) {
+    const EndpointClass cls = endpointClassOf(pending.context.type);
+    const Policy &policy = m_policies[int(cls)];
+    if (pending.context.attempt >= policy.maxAttempts || m_breakers[int(cls)].open)
+        return false;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool neverProcessed = false;    // safe to repeat even for orders
+    bool transient = false;         // safe to repeat for GETs only
+    if (status == 429) {
+        neverProcessed = true;
+    } else if (timedOut || status == 500 || status == 502 || status == 503 || status == 504) {
+        transient = true;
+    } else if (status == 0) {
+        switch (reply->error()) {
+        case QNetworkReply::ConnectionRefusedError:
+        case QNetworkReply::HostNotFoundError:
+        case QNetworkReply::SslHandshakeFailedError:
+        case QNetworkReply::ProxyConnectionRefusedError:
+        case QNetworkReply::ProxyNotFoundError:
+            neverProcessed = true;
+            break;
+        case QNetworkReply::OperationCanceledError:
+            break;                  // cancelled by the caller
+        default:
+            transient = reply->error() != QNetworkReply::NoError;
+            break;
+        }
     }
+    if (!neverProcessed && !(transient && !pending.post))
+        return false;
+
+    // Retries spend a per-class budget that successes refill, so mass failures cannot fan out
+    double &budget = m_retryBudget[int(cls)];
+    if (budget < 1.0) {
+        LOG_WARN("HttpManager: retry budget for {} exhausted, not retrying #{}", endpointClassName(cls),
+                 pending.context.requestId);
+        return false;
+    }
+    budget -= 1.0;
+    return true;
+}
+
+// Re-queues a failed request after exponential backoff with jitter (half fixed, half random)
+void HttpManager::scheduleRetry(Pending &&pending) {
+    const Policy &policy = m_policies[int(endpointClassOf(pending.context.type))];
+    const int exponent = qMin(pending.context.attempt - 1, 16);
+    const int cap = int(qMin<qint64>(policy.maxBackoffMs, qint64(policy.backoffMs) << exponent));
+    const int delayMs = cap / 2 + int(QRandomGenerator::global()->bounded(cap / 2 + 1));
+
+    LOG_INFO("HttpManager: retrying #{} ({}) in {} ms, attempt {} of {}", pending.context.requestId,
+             pending.request.url().path(), delayMs, pending.context.attempt + 1, policy.maxAttempts);
+    ++m_retries;
+    ++pending.context.attempt;
+    const quint64 ticket = m_nextRetryTicket++;
+    m_retrying.insert(ticket, std::move(pending));
+    QTimer::singleShot(delayMs, this, [this, ticket]() {
+        auto it = m_retrying.find(ticket);
+        if (it == m_retrying.end()) return;     // cancelled while backing off
+        Pending retry = std::move(it.value());
+        m_retrying.erase(it);
+        pushQueued(std::move(retry));
+        pump();
+    });
+}
+
+// Circuit breaker bookkeeping. healthy: the server answered (any 2xx-4xx other than 429).
+void HttpManager::recordOutcome(EndpointClass cls, quint64 requestId, bool healthy) {
+    Breaker &b = m_breakers[int(cls)];
+    const Policy &policy = m_policies[int(cls)];
+    const qint64 now = LatencyMonitor::nowNanos();
+    if (healthy) m_retryBudget[int(cls)] = qMin(10.0, m_retryBudget[int(cls)] + 0.2);
+
+    if (b.open) {
+        if (requestId != b.probeId) return;     // stragglers sent before the circuit opened
+        b.probeId = 0;
+        if (healthy) {
+            LOG_INFO("HttpManager: {} circuit closed", endpointClassName(cls));
+            b = Breaker();
+            m_circuitOpen[int(cls)].store(false, std::memory_order_relaxed);
+        } else {
+            b.openMs = qMin(60000, b.openMs * 2);
+            b.openUntilNs = now + qint64(b.openMs) * 1000000;
+            LOG_WARN("HttpManager: {} probe failed, circuit open for {} ms", endpointClassName(cls), b.openMs);
+        }
+        return;
+    }
+    if (healthy) {
+        b.consecutiveFailures = 0;
+    } else if (policy.breakerFailures > 0 && ++b.consecutiveFailures >= policy.breakerFailures) {
+        b.open = true;
+        m_circuitOpen[int(cls)].store(true, std::memory_order_relaxed);
+        b.openMs = policy.breakerOpenMs;
+        b.openUntilNs = now + qint64(b.openMs) * 1000000;
+        LOG_WARN("HttpManager: {} consecutive {} failures, circuit open for {} ms", b.consecutiveFailures,
+                 endpointClassName(cls), b.openMs);
+    }
+}
+
+// Multiplicative decrease on 429: halve the class's rate, drop its tokens and pause it
+void HttpManager::onRateLimited(EndpointClass cls, QNetworkReply *reply) {
+    Bucket &b = m_buckets[int(cls)];
+    const qint64 now = LatencyMonitor::nowNanos();
+    const int retryAfter = reply->rawHeader("Retry-After").trimmed().toInt();
+    b.rate = qMax(b.nominalRate * 0.1, b.rate * 0.5);
+    b.tokens = 0.0;
+    b.lastNs = now;
+    b.pausedUntilNs = now + qMax(1, retryAfter) * kNanosPerSecond;
+    LOG_WARN("HttpManager: 429 from {}; class {} slowed to {:.2f}/s for at least {}s",
+             reply->url().path(), int(cls), b.rate, qMax(1, retryAfter));
 }
 
 // Slot connected to QNetworkReply::finished()
 void HttpManager::onReplyFinished() {
+    TRACE_ZONE("http", "HttpManager::onReplyFinished");
     // Get the reply object that emitted the signal
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) {
@@ -63,15 +654,194 @@ void HttpManager::onReplyFinished() {
         return;
     }
 
-    // Retrieve the requestType stored earlier as a property
-    RequestType type = reply->property("requestType").value<RequestType>();
+    auto it = m_inFlight.find(reply);
+    if (it == m_inFlight.end()) {
+        qWarning() << "HttpManager::onReplyFinished: Reply is not in flight:" << reply->url();
+        reply->deleteLater();
+        return;
+    }
+    Pending pending = std::move(it.value());
+    m_inFlight.erase(it);
+    const RequestContext &context = pending.context;
+    const EndpointClass cls = endpointClassOf(context.type);
+
+    roundTripStage(context.type)->record(LatencyMonitor::nowNanos() - context.sentNs);
+    recordConnectionUse(pending, reply);
+
+    // Feed the reply's outcome back into its class's rate (additive increase on success)
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    Bucket &bucket = m_buckets[int(cls)];
+    if (status == 429) {
+        onRateLimited(cls, reply);
+    } else if (status >= 200 && status < 300 && bucket.rate < bucket.nominalRate) {
+        bucket.rate = qMin(bucket.nominalRate, bucket.rate + bucket.nominalRate * 0.05);
+    }
+
+    // A transfer timeout also surfaces as OperationCanceledError; cancel() marks its own aborts
+    const bool cancelled = m_cancelling.remove(context.requestId);
+    const bool timedOut = !cancelled && reply->error() == QNetworkReply::OperationCanceledError;
+    if (cancelled) {
+        Breaker &breaker = m_breakers[int(cls)];
+        if (breaker.probeId == context.requestId) breaker.probeId = 0;
+    } else if (status != 429) {
+        recordOutcome(cls, context.requestId, status >= 200 && status < 500);
+    }
 
-    qDebug() << "HttpManager::onReplyFinished: Emitting requestFinished signal with requestType =" << static_cast<int>(type);
+    if (!cancelled && shouldRetry(pending, reply, timedOut)) {
+        reply->deleteLater();
+        scheduleRetry(std::move(pending));
+        pump();
+        return;
+    }
+    LOG_TRACE("HttpManager::onReplyFinished: #{} type {}", context.requestId, context.type);
+
+    // Collect the callers that joined this GET and decide whether to cache it
+    QList<RequestContext> followers;
+    QByteArray key;
+    if (reply->operation() == QNetworkAccessManager::GetOperation) {
+        key = coalesceKey(reply->request());
+        auto w = m_waiters.find(key);
+        if (w != m_waiters.end() && w->leaderId == context.requestId) {
+            followers = std::move(w->followers);
+            m_waiters.erase(w);
+        }
+    }
+    const bool ok = reply->error() == QNetworkReply::NoError && status >= 200 && status < 300;
+    const bool cacheable = ok && !key.isEmpty() && m_cacheTtlMs[int(cls)] > 0;
+    if (ok && cls == EndpointClass::Orders)
+        dropCached(EndpointClass::Account);    // an order moves margins and positions
+
+    if (followers.isEmpty() && !cacheable && !timedOut) {
+        // Receivers run synchronously inside this scope and can pick the flow up via currentFlow()
+        TRACE_FLOW_STEP("http", "request", context.traceFlow);
+        TraceFlowScope flowScope(context.traceFlow);
+
+        // Emit the main signal for the API handler (e.g., KiteConnectAPI) to process
+        emit requestFinished(reply, context);
+
+        // IMPORTANT: Do NOT deleteLater() the reply here.
+        // The ownership is transferred to the receiver of the requestFinished signal,
+        // which is responsible for deleting it after processing.
+    } else {
+        // Shared or cached: read the body once, every receiver gets its own BufferedReply
+        ReplySnapshot snapshot = ReplySnapshot::capture(reply);
+        reply->deleteLater();
+        if (timedOut) {
+            snapshot.error = QNetworkReply::TimeoutError;
+            snapshot.errorString = QString("No data for %1 ms (attempt %2)")
+                                       .arg(m_policies[int(cls)].timeoutMs).arg(context.attempt);
+        }
+        if (cacheable) storeInCache(key, snapshot, cls);
+        deliver(snapshot, context);
+        for (const RequestContext &follower : std::as_const(followers))
+            deliver(snapshot, follower);
+    }
+
+    // A connection slot just freed up
+    pump();
+}
 
-    // Emit the main signal for the API handler (e.g., KiteConnectAPI) to process
-    emit requestFinished(reply, type);
+// ---------- connection warm-up ----------
+
+QString HttpManager::originKey(const QUrl &url) {
+    return url.scheme() + "://" + url.host() + ":" + QString::number(url.port(url.scheme() == "https" ? 443 : 80));
+}
+
+void HttpManager::warmUp(const QUrl &origin, int connections) {
+    runOnOwnThread([this, origin, connections]() {
+        WarmOrigin &warm = m_warmOrigins[originKey(origin)];
+        warm.origin = origin;
+        warm.connections = qBound(1, connections < 0 ? m_warmConnections : connections, m_maxConnections);
+        warm.lastActivityNs = LatencyMonitor::nowNanos();
+        LOG_INFO("HttpManager: warming {} connection(s) to {}", warm.connections, origin.host());
+        preconnect(warm);
+    });
+}
+
+void HttpManager::setKeepAliveInterval(int ms) {
+    runOnOwnThread([this, ms]() {
+        m_keepAliveMs = qMax(0, ms);
+        if (m_keepAliveMs > 0) m_keepAliveTimer->start(qMax(500, m_keepAliveMs / 2));
+        else m_keepAliveTimer->stop();
+    });
+}
+
+HttpManager::ConnectionStats HttpManager::connectionStats() const {
+    ConnectionStats stats;
+    stats.replies = m_replies.load(std::memory_order_relaxed);
+    stats.fresh = m_freshConnections.load(std::memory_order_relaxed);
+    stats.http2 = m_http2Replies.load(std::memory_order_relaxed);
+    stats.coldOrders = m_coldOrders.load(std::memory_order_relaxed);
+    stats.keepAlives = m_keepAlives.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Opens (or confirms) the pool: DNS, TCP and TLS happen now instead of on the next request.
+// Each call asks for one connection; QNetworkAccessManager skips those already open and idle.
+void HttpManager::preconnect(const WarmOrigin &warm) {
+    const QString host = warm.origin.host();
+    if (warm.origin.scheme() == "http") {
+        // Plain HTTP (a local stand-in server): TCP only
+        for (int i = 0; i < warm.connections; ++i)
+            m_networkManager->connectToHost(host, quint16(warm.origin.port(80)));
+        return;
+    }
+    QSslConfiguration ssl = QSslConfiguration::defaultConfiguration();
+    ssl.setAllowedNextProtocols({ QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1 });
+    const quint16 port = quint16(warm.origin.port(443));
+    for (int i = 0; i < warm.connections; ++i)
+        m_networkManager->connectToHostEncrypted(host, port, ssl, QString());
+}
+
+// Reuse accounting per finished network reply; a cold connect refills the origin's pool
+void HttpManager::recordConnectionUse(const Pending &pending, QNetworkReply *reply) {
+    m_replies.fetch_add(1, std::memory_order_relaxed);
+    if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool())
+        m_http2Replies.fetch_add(1, std::memory_order_relaxed);
+
+    const bool transportError = reply->error() != QNetworkReply::NoError &&
+                                reply->error() < QNetworkReply::ContentAccessDenied;
+    if (!pending.freshConnection && !transportError) return;
+    if (pending.freshConnection) {
+        m_freshConnections.fetch_add(1, std::memory_order_relaxed);
+        if (endpointClassOf(pending.context.type) == EndpointClass::Orders) {
+            m_coldOrders.fetch_add(1, std::memory_order_relaxed);
+            LOG_WARN("HttpManager: order #{} opened a new connection to {}", pending.context.requestId,
+                     pending.request.url().host());
+        }
+    }
+    auto warm = m_warmOrigins.constFind(originKey(pending.request.url()));
+    if (warm != m_warmOrigins.constEnd()) preconnect(*warm);
+}
+
+void HttpManager::keepAlive() {
+    const qint64 now = LatencyMonitor::nowNanos();
+    const qint64 idleNs = qint64(m_keepAliveMs) * 1000000;
+    for (WarmOrigin &warm : m_warmOrigins) {
+        if (now - warm.lastActivityNs < idleNs) continue;
+        // One HEAD per warm connection: concurrent requests spread over the pool, and a HEAD
+        // to the API root needs no session and costs no rate-limit token
+        QNetworkRequest request(warm.origin);
+        request.setTransferTimeout(5000);
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+        for (int i = 0; i < warm.connections; ++i) {
+            QNetworkReply *reply = m_networkManager->head(request);
+            if (!reply) continue;
+            connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+            m_keepAlives.fetch_add(1, std::memory_order_relaxed);
+        }
+        warm.lastActivityNs = now;
+        LOG_TRACE("HttpManager: keep-alive to {}", warm.origin.host());
+    }
 
-    // IMPORTANT: Do NOT deleteLater() the reply here.
-    // The ownership is transferred to the receiver of the requestFinished signal,
-    // which is responsible for deleting it after processing.
+    // Reuse report, once a minute while there is traffic
+    if (now - m_lastStatsReportNs < 60 * kNanosPerSecond) return;
+    m_lastStatsReportNs = now;
+    const ConnectionStats stats = connectionStats();
+    TRACE_COUNTER("http.reusePct", int(stats.reuseRate() * 100.0));
+    if (stats.replies == m_lastReportedReplies) return;
+    m_lastReportedReplies = stats.replies;
+    LOG_INFO("HttpManager: connection reuse {:.2f}% ({} of {} replies), HTTP/2 {}, cold orders {}, keep-alives {}",
+             stats.reuseRate() * 100.0, stats.replies - stats.fresh, stats.replies, stats.http2,
+             stats.coldOrders, stats.keepAlives);
 }
@@ -6,20 +6,87 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QUrl>
+#include <QHash>
+#include <QQueue>
+#include <QStringList>
+#include <QSet>
+#include <QJsonObject>
+#include <atomic>
 
-// Include header where RequestType is defined (kiteconnectapi.h)
-#include "Network/kiteconnectapi.h" // Adjust path as needed
+#include "Network/requestcontext.h"
+#include "Network/bufferedreply.h"
+
+class QTimer;
 
 /**
  * @brief Manages network requests (GET/POST) for the application.
  *
  * Handles sending requests via QNetworkAccessManager and reports results
- * back via signals, associating a RequestType with each reply.
+ * back via signals. Each in-flight reply is stored with the RequestContext it was sent with,
+ * which is handed back unchanged (plus send timestamp and request ID) when it finishes.
+ *
+ * Every request passes through one rate limiter shared by all callers:
+ * - a token bucket per endpoint class, set to Kite's documented limits (orders 10/s,
+ *   quotes 1/s, other endpoints 10/s, historical 3/s), so each class runs at its ceiling;
+ * - strict priority between requests (RequestContext::priority: Critical > High > Normal >
+ *   Low), with the last connection slots reserved for higher priorities so a backlog of
+ *   historical fetches can never hold up an order;
+ * - round-robin between callers (RequestContext::caller) within a priority;
+ * - on HTTP 429 the class's rate is halved and paused (Retry-After honoured), then grows back
+ *   by 5% of nominal per successful reply.
+ *
+ * Identical GETs (same URL and Authorization) share one network request: a GET issued while an
+ * identical one is queued or in flight waits for it and gets its own BufferedReply copy of the
+ * result. Successful GETs are also kept for a short per-class TTL (setCacheTtl()), so bursts
+ * of re-requests are answered without touching the network or the rate limits.
+ *
+ * Failures are handled per class by a Policy:
+ * - a transfer timeout (no bytes for timeoutMs) aborts stalled replies so they free their slot;
+ * - retryable failures are re-queued after exponential backoff with jitter. GETs are retried on
+ *   timeouts, 5xx and transport errors; POSTs (orders) only when the request provably never
+ *   reached Kite (connection refused, host lookup, TLS handshake, 429). Retries draw from a
+ *   per-class budget refilled by successes, so a wave of failures cannot become a retry storm;
+ * - after breakerFailures consecutive server/transport failures the class's circuit opens: new
+ *   requests fail immediately and queued ones wait, until a single probe succeeds.
+ *
+ * Connections to warmUp() origins are opened ahead of time (DNS, TCP and TLS with HTTP/2
+ * offered via ALPN) and kept warm: when an origin has been idle for the keep-alive interval a
+ * HEAD per warm connection is sent so neither side drops the pool, and the pool is topped up
+ * whenever a request had to open a connection of its own. connectionStats() reports how many
+ * replies reused a pooled connection; an order that still paid for a cold connect is logged.
+ *
+ * Threading: KiteConnectAPI moves HttpManager (and its QNetworkAccessManager) onto a dedicated
+ * network thread. send*(), cancel() and the setters may be called from any thread; work is
+ * forwarded to the network thread, where requestFinished() is emitted. The counters are atomic
+ * snapshots.
  */
 class HttpManager : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @brief Rate-limit classes, each with its own Kite limit.
+     */
+    enum class EndpointClass : quint8 {
+        Orders = 0,     ///< Order placement/modification/cancellation
+        Quotes,         ///< /quote, /quote/ohlc, /quote/ltp
+        Account,        ///< Everything else (session, user, portfolio, instruments)
+        Historical,     ///< /instruments/historical
+        Count
+    };
+
+    /**
+     * @brief Timeout, retry and circuit-breaker settings of one endpoint class.
+     */
+    struct Policy {
+        int timeoutMs = 10000;      ///< Abort when no bytes arrive for this long (0 = never).
+        int maxAttempts = 3;        ///< Total sends, including the first.
+        int backoffMs = 500;        ///< Delay before the first retry; doubles per attempt.
+        int maxBackoffMs = 8000;
+        int breakerFailures = 5;    ///< Consecutive failures that open the circuit (0 = no breaker).
+        int breakerOpenMs = 10000;  ///< First open period; doubles while probes fail (max 60 s).
+    };
+
     /**
      * @brief Constructor.
      * @param parent Optional parent QObject.
@@ -32,37 +99,255 @@ public:
     ~HttpManager();
 
     /**
-     * @brief Sends an asynchronous GET request.
+     * @brief Queues an asynchronous GET request; it is sent when the limiter allows.
      * @param request The QNetworkRequest object containing URL, headers, etc.
-     * @param requestType The type of request being sent (for context tracking).
+     * @param context What the request is for; returned with the reply.
+     * @return The assigned request ID.
      */
-    void sendGetRequest(const QNetworkRequest &request, RequestType requestType);
+    quint64 sendGetRequest(const QNetworkRequest &request, RequestContext context);
+    /** @brief Convenience overload for requests that need no context beyond their type. */
+    quint64 sendGetRequest(const QNetworkRequest &request, RequestType requestType);
 
     /**
-     * @brief Sends an asynchronous POST request.
+     * @brief Queues an asynchronous POST request; it is sent when the limiter allows.
      * @param request The QNetworkRequest object containing URL, headers, etc.
      * @param data The data payload to be sent with the POST request.
-     * @param requestType The type of request being sent (for context tracking).
+     * @param context What the request is for; returned with the reply.
+     * @return The assigned request ID.
+     */
+    quint64 sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestContext context);
+    /** @brief Convenience overload for requests that need no context beyond their type. */
+    quint64 sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestType requestType);
+
+    /**
+     * @brief Aborts a queued or in-flight request. Its reply still finishes
+     * (OperationCanceledError) and is reported through requestFinished() with its context;
+     * that reply is the only confirmation. An ID that already finished is ignored.
+     */
+    void cancel(quint64 requestId);
+
+    /** @brief Number of requests sent and not yet finished. */
+    int inFlightCount() const { return m_inFlightGauge.load(std::memory_order_relaxed); }
+    /** @brief Number of requests waiting for the limiter. */
+    int queuedCount() const { return m_queuedGauge.load(std::memory_order_relaxed); }
+
+    /** @brief Limiter class of a request type. */
+    static EndpointClass endpointClassOf(RequestType type);
+
+    /**
+     * @brief Overrides a class's limit.
+     * @param requestsPerSecond Sustained rate (the nominal rate 429 back-off recovers to).
+     * @param burst Requests that may go out back-to-back after an idle period (>= 1).
+     */
+    void setClassLimit(EndpointClass cls, double requestsPerSecond, double burst = 1.0);
+
+    /**
+     * @brief Concurrent requests allowed (QNetworkAccessManager opens 6 per host).
+     */
+    void setMaxConnections(int connections);
+
+    /**
+     * @brief How long a successful GET of this class is reused (0 disables caching for it).
+     * Defaults: orders 0, quotes 200 ms, account 2 s, historical 30 s.
+     */
+    void setCacheTtl(EndpointClass cls, int ttlMs);
+    /** @brief Drops every cached response. */
+    void clearCache();
+
+    /** @brief Requests answered from the cache / by joining an identical in-flight GET. */
+    quint64 cacheHits() const { return m_cacheHits.load(std::memory_order_relaxed); }
+    quint64 coalescedCount() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Applies the "http" object of config.json, e.g.
+     * @code
+     * { "cache_ttl_ms": { "quotes": 200, "account": 2000, "historical": 30000 },
+     *   "policies": { "historical": { "timeout_ms": 10000, "max_attempts": 4, "backoff_ms": 1000,
+     *                                 "max_backoff_ms": 15000, "breaker_failures": 5,
+     *                                 "breaker_open_ms": 15000 } },
+     *   "warm_connections": 2, "keepalive_ms": 30000 }
+     * @endcode
+     * Keys are endpointClassName()s; missing keys keep their current value.
      */
-    void sendPostRequest(const QNetworkRequest &request, const QByteArray &data, RequestType requestType);
+    void applyConfig(const QJsonObject &config);
+    /** @brief Replaces a class's timeout/retry/breaker policy. */
+    void setPolicy(EndpointClass cls, const Policy &policy);
+    /** @brief Current policy (read it on the network thread). */
+    const Policy &policy(EndpointClass cls) const { return m_policies[int(cls)]; }
+
+    /** @brief True while requests of this class are being shed. */
+    bool isCircuitOpen(EndpointClass cls) const { return m_circuitOpen[int(cls)].load(std::memory_order_relaxed); }
+    /** @brief Requests re-sent after a retryable failure. */
+    quint64 retryCount() const { return m_retries.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Connection reuse counters (see connectionStats()).
+     */
+    struct ConnectionStats {
+        quint64 replies = 0;        ///< Finished network replies (cache hits and joins excluded).
+        quint64 fresh = 0;          ///< Replies that had to open a new connection.
+        quint64 http2 = 0;          ///< Replies carried over HTTP/2.
+        quint64 coldOrders = 0;     ///< Order requests among the fresh ones.
+        quint64 keepAlives = 0;     ///< Keep-alive HEADs sent.
+        double reuseRate() const { return replies ? double(replies - fresh) / double(replies) : 1.0; }
+    };
+
+    /**
+     * @brief Pre-connects to @p origin's host and keeps its connections warm from now on.
+     * Call at startup and again after login; connections already open are reused.
+     * @param connections Warm connections to hold (-1: the configured default, 2). With HTTP/2
+     * one multiplexed connection serves them all.
+     */
+    void warmUp(const QUrl &origin, int connections = -1);
+    /** @brief Idle time after which warm origins get a keep-alive HEAD (0 disables them). */
+    void setKeepAliveInterval(int ms);
+    /** @brief Snapshot of the connection reuse counters. */
+    ConnectionStats connectionStats() const;
+
+    /** @brief "orders", "quotes", "account" or "historical". */
+    static QString endpointClassName(EndpointClass cls);
 
 signals:
     /**
      * @brief Emitted when any network request finishes (successfully or with error).
      * @param reply Pointer to the completed QNetworkReply object. The receiver is responsible for calling deleteLater().
-     * @param type The RequestType associated with this reply.
+     * @param context The context the request was sent with (request ID and send time filled in).
      */
-    void requestFinished(QNetworkReply *reply, RequestType type);
+    void requestFinished(QNetworkReply *reply, const RequestContext &context);
 
 private slots:
     /**
      * @brief Slot connected to the finished() signal of QNetworkReply.
-     * Retrieves the RequestType property and emits the requestFinished signal.
+     * Takes the reply's context out of the in-flight table and emits requestFinished.
      */
     void onReplyFinished();
 
+    /**
+     * @brief Sends every queued request the limiter currently allows, then arms the timer
+     * for the next token.
+     */
+    void pump();
+
+    /**
+     * @brief Keep-alive tick: pings idle warm origins and logs the reuse rate once a minute.
+     */
+    void keepAlive();
+
 private:
+    struct Pending {
+        bool post = false;
+        QNetworkRequest request;
+        QByteArray body;
+        RequestContext context;
+        bool freshConnection = false;   // the reply opened a new connection instead of reusing one
+    };
+
+    struct Bucket {
+        double nominalRate = 10.0;  // requests per second
+        double rate = 10.0;         // current rate (reduced after 429s)
+        double burst = 1.0;
+        double tokens = 1.0;
+        qint64 lastNs = 0;
+        qint64 pausedUntilNs = 0;
+
+        void refill(qint64 nowNs);
+        qint64 readyAtNs(qint64 nowNs) const;   // when one token is available
+    };
+
+    // Requests of one priority, one FIFO per caller, served round-robin.
+    struct FairQueue {
+        QHash<QString, QQueue<Pending>> byCaller;
+        QStringList rotation;   // callers with queued requests, next to serve first
+        int size = 0;
+    };
+
+    struct Breaker {
+        int consecutiveFailures = 0;
+        bool open = false;
+        qint64 openUntilNs = 0;     // half-open (one probe allowed) from then on
+        int openMs = 0;
+        quint64 probeId = 0;        // request sent as the half-open probe, 0 if none
+    };
+
+    // Callers waiting on one network GET: the one that sent it and those that joined it
+    struct Waiters {
+        quint64 leaderId = 0;
+        QNetworkRequest request;
+        QList<RequestContext> followers;
+    };
+
+    struct CacheEntry {
+        ReplySnapshot snapshot;
+        EndpointClass cls = EndpointClass::Account;
+        qint64 expiresNs = 0;
+    };
+
+    template <typename F> void runOnOwnThread(F &&f);
+    bool cancelNow(quint64 requestId);
+    int countQueued() const;
+    void enqueue(Pending &&pending);
+    void pushQueued(Pending &&pending);
+    void dispatch(Pending &&pending);
+    int slotLimit(RequestPriority priority) const;
+    void onRateLimited(EndpointClass cls, QNetworkReply *reply);
+
+    static QByteArray coalesceKey(const QNetworkRequest &request);
+    void deliver(const ReplySnapshot &snapshot, RequestContext context);
+    void storeInCache(const QByteArray &key, const ReplySnapshot &snapshot, EndpointClass cls);
+    void dropCached(EndpointClass cls);
+    bool handOverLeadership(quint64 requestId);
+    void deliverLater(const ReplySnapshot &snapshot, const RequestContext &context);
+
+    bool shouldRetry(const Pending &pending, QNetworkReply *reply, bool timedOut);
+    void scheduleRetry(Pending &&pending);
+    void recordOutcome(EndpointClass cls, quint64 requestId, bool healthy);
+
+    struct WarmOrigin {
+        QUrl origin;                // scheme://host:port
+        int connections = 2;
+        qint64 lastActivityNs = 0;  // last request or keep-alive sent to it
+    };
+    static QString originKey(const QUrl &url);
+    void preconnect(const WarmOrigin &warm);
+    void recordConnectionUse(const Pending &pending, QNetworkReply *reply);
+
     QNetworkAccessManager *m_networkManager; // Manages network access.
+    QHash<QNetworkReply*, Pending> m_inFlight; // Every unfinished reply and what it was sent from.
+    std::atomic<quint64> m_nextRequestId{1};   // assigned on the calling thread
+
+    Bucket m_buckets[int(EndpointClass::Count)];
+    FairQueue m_queues[4];      // indexed by RequestPriority
+    int m_maxConnections = 6;
+    QTimer *m_pumpTimer = nullptr;
+
+    QHash<QByteArray, Waiters> m_waiters;   // coalesceKey -> GET queued or in flight
+    QHash<QByteArray, CacheEntry> m_cache;  // coalesceKey -> recent successful GET
+    int m_cacheTtlMs[int(EndpointClass::Count)] = { 0, 200, 2000, 30000 };
+    std::atomic<quint64> m_cacheHits{0};
+    std::atomic<quint64> m_coalesced{0};
+
+    Policy m_policies[int(EndpointClass::Count)];
+    Breaker m_breakers[int(EndpointClass::Count)];
+    double m_retryBudget[int(EndpointClass::Count)] = { 10, 10, 10, 10 };
+    QHash<quint64, Pending> m_retrying;     // retry ticket -> backing off before its next attempt
+    quint64 m_nextRetryTicket = 1;
+    QSet<quint64> m_cancelling;             // in-flight requests aborted by cancel()
+    std::atomic<quint64> m_retries{0};
+    std::atomic<bool> m_circuitOpen[int(EndpointClass::Count)] = {};
+    std::atomic<int> m_inFlightGauge{0};
+    std::atomic<int> m_queuedGauge{0};
+
+    QHash<QString, WarmOrigin> m_warmOrigins;   // originKey -> origin kept warm
+    int m_warmConnections = 2;
+    int m_keepAliveMs = 30000;
+    QTimer *m_keepAliveTimer = nullptr;
+    qint64 m_lastStatsReportNs = 0;
+    quint64 m_lastReportedReplies = 0;
+    std::atomic<quint64> m_replies{0};
+    std::atomic<quint64> m_freshConnections{0};
+    std::atomic<quint64> m_http2Replies{0};
+    std::atomic<quint64> m_coldOrders{0};
+    std::atomic<quint64> m_keepAlives{0};
 };
 
 #endif // HTTPMANAGER_H
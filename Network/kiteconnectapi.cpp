@@ -3,6 +3,9 @@
 #include "Utils/configurationmanager.h"
 #include "Data/datamanager.h" // *** ADDED *** Include DataManager to check instrument segment
 #include "Data/DataStructures/InstrumentData.h" // *** ADDED *** Include InstrumentData definition
+#include "Utils/logger.h"
+#include "Utils/latencymonitor.h"
+#include "Utils/tracer.h"
 
 #include <QNetworkRequest>
 #include <QUrl>
@@ -18,6 +21,9 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QMetaType> // For qRegisterMetaType
+#include <QPromise>
+#include <QThread>
+#include <memory>
 
 // Register RequestType enum with the meta-object system for QVariant property storage
 int requestTypeMetaTypeId = qRegisterMetaType<RequestType>("RequestType");
@@ -25,7 +31,7 @@ int requestTypeMetaTypeId = qRegisterMetaType<RequestType>("RequestType");
 
 // Constructor: Initializes members, fetches API secret.
 KiteConnectAPI::KiteConnectAPI(const QString& apiKey, QObject *parent)
-    : QObject(parent), m_apiKey(apiKey)
+    : QObject(parent), m_apiKey(apiKey), m_requests(m_baseUrl, m_apiVersion)
 {
     // Fetch API Secret from ConfigurationManager Singleton
     ConfigurationManager* config = ConfigurationManager::instance();
@@ -38,16 +44,42 @@ KiteConnectAPI::KiteConnectAPI(const QString& apiKey, QObject *parent)
         // Consider setting an internal error state
     }
 
-    // Create the HTTP manager instance
-    m_httpManager = new HttpManager(this);
+    // API root override (a local stand-in such as Tools/KiteStub): QPX_API_BASE_URL wins over
+    // "http": { "base_url" } in config.json. Login then goes through the same host.
+    QString baseUrl = qEnvironmentVariable("QPX_API_BASE_URL");
+    if (baseUrl.isEmpty() && config) baseUrl = config->getHttpConfig().value("base_url").toString();
+    while (baseUrl.endsWith('/')) baseUrl.chop(1);
+    if (!baseUrl.isEmpty()) {
+        qWarning() << "KiteConnectAPI: Using API base URL" << baseUrl << "instead of" << m_baseUrl;
+        m_requests.setBaseUrl(baseUrl);
+        m_loginUrl = baseUrl + "/connect/login";
+    }
 
-    // Connect the HttpManager's signal to our central reply handler slot
-    connect(m_httpManager, &HttpManager::requestFinished, this, &KiteConnectAPI::onNetworkReply);
+    // Create the HTTP manager and hand it to the network thread. It has no parent (objects with
+    // a parent cannot change thread) and is deleted on its own thread when the loop ends.
+    m_ioThread = new QThread(this);
+    m_ioThread->setObjectName("net-io");
+    m_httpManager = new HttpManager();
+    if (config) m_httpManager->applyConfig(config->getHttpConfig());
+    m_httpManager->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_httpManager, &QObject::deleteLater);
+    connect(m_ioThread, &QThread::started, [] { Tracer::instance()->setThreadName("net-io"); });
+
+    // Replies are handled where they arrive: decoding runs on the network thread, only typed
+    // results are posted back to this thread
+    connect(m_httpManager, &HttpManager::requestFinished, m_httpManager,
+            [this](QNetworkReply* reply, const RequestContext& context) { onNetworkReply(reply, context); },
+            Qt::DirectConnection);
+    m_ioThread->start();
+
+    // DNS, TCP and TLS to the API host now, so the first real request finds a warm connection
+    m_httpManager->warmUp(QUrl(m_requests.baseUrl()));
 }
 
-// Destructor
+// Destructor: stop the network thread; HttpManager is deleted as its event loop winds down
 KiteConnectAPI::~KiteConnectAPI() {
-    // m_httpManager is deleted by Qt's parent-child mechanism
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 // Accessor for the access token
@@ -55,6 +87,11 @@ QString KiteConnectAPI::getAccessToken() const {
     return m_accessToken;
 }
 
+// Aborts an in-flight request; its failure is reported through the usual signal
+void KiteConnectAPI::cancelRequest(quint64 requestId) {
+    m_httpManager->cancel(requestId);
+}
+
 // Accessor for the API key
 QString KiteConnectAPI::getApiKey() const {
     return m_apiKey;
@@ -92,10 +129,9 @@ void KiteConnectAPI::generateSession(const QString& requestToken) {
     qDebug() << "generateSession: Calculated Checksum =" << checksum;
 
 
-    QUrl url(m_baseUrl + "/session/token");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setRawHeader("X-Kite-Version", m_apiVersion.toUtf8()); // Set API version header
+    // Drop any previous session so the token request goes out without Authorization
+    m_requests.setSession(m_apiKey, QString());
+    QNetworkRequest request = m_requests.formRequest(KiteRequestBuilder::Endpoint::SessionToken);
 
     // Prepare POST data
     QUrlQuery params;
@@ -107,363 +143,442 @@ void KiteConnectAPI::generateSession(const QString& requestToken) {
     qDebug() << "generateSession: Payload =" << QString(postData); // Log payload
 
     // Send POST request via HttpManager
-    m_httpManager->sendPostRequest(request, postData, RequestType::SessionRequest);
+    RequestContext context;
+    context.type = RequestType::SessionRequest;
+    sendAsync(request, std::move(context), &KiteConnectAPI::decodeSessionResponse,
+              &KiteConnectAPI::publishSession, &postData);
+}
+
+// Fire-and-forget variants: results arrive through the broadcast signals only
+void KiteConnectAPI::fetchAllInstruments() { fetchAllInstrumentsAsync(); }
+void KiteConnectAPI::fetchUserProfile() { fetchUserProfileAsync(); }
+void KiteConnectAPI::fetchUserMargins() { fetchUserMarginsAsync(); }
+
+void KiteConnectAPI::fetchHistoricalData(const QString& instrumentToken, const QString& interval, const QString& from, const QString& to) {
+    fetchHistoricalDataAsync(instrumentToken, interval, from, to);
 }
 
 // Fetches the full instrument list (CSV format)
-void KiteConnectAPI::fetchAllInstruments() {
+QFuture<ApiResult<QVector<InstrumentData>>> KiteConnectAPI::fetchAllInstrumentsAsync() {
     if (m_accessToken.isEmpty()) {
         qWarning() << "KiteConnectAPI::fetchAllInstruments: Access token not available.";
         emit instrumentsFetchFailed("Access token not available.");
-        return;
+        return failedFuture<QVector<InstrumentData>>("Access token not available.");
     }
     qDebug() << "KiteConnectAPI::fetchAllInstruments() called!";
-    QUrl url(m_baseUrl + "/instruments");
-    // Use helper to add Authorization and Version headers
-    QNetworkRequest request = createBaseRequest(url);
-    m_httpManager->sendGetRequest(request, RequestType::InstrumentsRequest);
+    RequestContext context;
+    context.type = RequestType::InstrumentsRequest;
+    return sendAsync(m_requests.request(KiteRequestBuilder::Endpoint::Instruments), std::move(context),
+                     &KiteConnectAPI::decodeInstrumentsResponse, &KiteConnectAPI::publishInstruments);
 }
 
-// Fetches historical candle data
-// *** MODIFIED: fetchHistoricalData now conditionally adds 'continuous' parameter ***
-void KiteConnectAPI::fetchHistoricalData(const QString& instrumentToken, const QString& interval, const QString& from, const QString& to) {
+// Fetches historical candle data. Hot path: no logging, no per-call header or URL-prefix work.
+QFuture<ApiResult<QVector<CandleData>>> KiteConnectAPI::fetchHistoricalDataAsync(const QString& instrumentToken, const QString& interval,
+                                                                                 const QString& from, const QString& to) {
     if (m_accessToken.isEmpty()) {
         qWarning() << "KiteConnectAPI::fetchHistoricalData: Access token not available for token" << instrumentToken;
         emit historicalDataFailed("Access token not available.", instrumentToken + "_" + interval);
-        return;
+        return failedFuture<QVector<CandleData>>("Access token not available.");
     }
-    qDebug() << "KiteConnectAPI::fetchHistoricalData called for Token:" << instrumentToken << "Interval:" << interval;
 
-    // Construct URL with path parameters
-    QUrl url(QString("%1/instruments/historical/%2/%3").arg(m_baseUrl).arg(instrumentToken).arg(interval));
-
-    // Add mandatory query parameters
-    QUrlQuery query;
-    query.addQueryItem("from", from);
-    query.addQueryItem("to", to);
-    // query.addQueryItem("oi", "0"); // Add if OI data is needed
-
-    // --- Conditionally add continuous parameter ---
-    bool addContinuous = false;
-    DataManager* dm = DataManager::instance(); // Get DataManager instance
-    if (dm) {
-        // Ensure DataManager::getInstrument is public and works
-        InstrumentData instrument = dm->getInstrument(instrumentToken);
-        // Add continuous=1 ONLY for "day" interval AND NFO-FUT/NFO-OPT segments
-        if (interval.compare("day", Qt::CaseInsensitive) == 0 &&
-            (instrument.segment == "NFO-FUT" || instrument.segment == "NFO-OPT"))
-        {
-            addContinuous = true;
-            qDebug() << " -> Adding 'continuous=1' for daily NFO request.";
-        } else {
-            qDebug() << " -> Not adding 'continuous=1' (Interval:" << interval << "Segment:" << instrument.segment << ")";
-        }
-    } else {
-        qWarning() << "DataManager instance is null, cannot determine segment for continuous flag.";
-    }
-
-    if (addContinuous) {
-        query.addQueryItem("continuous", "1");
-    }
-    // --- End conditional logic ---
-
-    url.setQuery(query); // Set the final query on the URL
-    qDebug() << "  Final URL for historical request:" << url.toString(); // Log final URL
-
-    // Create request with standard headers (using helper is fine here)
-    QNetworkRequest request = createBaseRequest(url);
-    // The createBaseRequest helper adds Authorization and X-Kite-Version
-    // Its internal logging should confirm this.
-
-    // Send the request
-    m_httpManager->sendGetRequest(request, RequestType::HistoricalDataRequest);
+    // Derivatives ask for continuous=1 on daily candles (flag precomputed in the instrument table)
+    const bool continuous = interval.compare(QLatin1String("day"), Qt::CaseInsensitive) == 0 &&
+                            DataManager::instance()->isContinuousHistory(instrumentToken);
+
+    RequestContext context;
+    context.type = RequestType::HistoricalDataRequest;
+    context.priority = RequestPriority::Low;
+    context.caller = instrumentToken;   // backfill of many instruments is served round-robin
+    context.instrumentToken = instrumentToken;
+    context.interval = interval;
+    context.rangeFrom = from;
+    context.rangeTo = to;
+    return sendAsync(m_requests.historical(instrumentToken, interval, from, to, continuous), std::move(context),
+                     &KiteConnectAPI::decodeHistoricalDataResponse, &KiteConnectAPI::publishHistoricalData);
 }
 
 // Fetches user profile details
-void KiteConnectAPI::fetchUserProfile() {
+QFuture<ApiResult<QJsonObject>> KiteConnectAPI::fetchUserProfileAsync() {
     if (m_accessToken.isEmpty()) {
         qWarning() << "KiteConnectAPI::fetchUserProfile: Access token not available.";
         emit userProfileFailed("Access token not available.");
-        return;
+        return failedFuture<QJsonObject>("Access token not available.");
     }
     qDebug() << "KiteConnectAPI: Requesting User Profile...";
-    QUrl url(m_baseUrl + "/user/profile");
-    QNetworkRequest request = createBaseRequest(url);
-    m_httpManager->sendGetRequest(request, RequestType::ProfileRequest);
+    RequestContext context;
+    context.type = RequestType::ProfileRequest;
+    return sendAsync(m_requests.request(KiteRequestBuilder::Endpoint::UserProfile), std::move(context),
+                     &KiteConnectAPI::decodeUserProfileResponse, &KiteConnectAPI::publishUserProfile);
 }
 
 // Fetches user margin details
-void KiteConnectAPI::fetchUserMargins() {
+QFuture<ApiResult<QJsonObject>> KiteConnectAPI::fetchUserMarginsAsync() {
     if (m_accessToken.isEmpty()) {
         qWarning() << "KiteConnectAPI::fetchUserMargins: Access token not available.";
         emit userMarginsFailed("Access token not available.");
-        return;
+        return failedFuture<QJsonObject>("Access token not available.");
     }
     qDebug() << "KiteConnectAPI: Requesting User Margins...";
-    QUrl url(m_baseUrl + "/user/margins"); // Correct endpoint
-    QNetworkRequest request = createBaseRequest(url);
-    m_httpManager->sendGetRequest(request, RequestType::MarginsRequest);
+    RequestContext context;
+    context.type = RequestType::MarginsRequest;
+    return sendAsync(m_requests.request(KiteRequestBuilder::Endpoint::UserMargins), std::move(context),
+                     &KiteConnectAPI::decodeUserMarginsResponse, &KiteConnectAPI::publishUserMargins);
 }
 
+int KiteConnectAPI::maxInstrumentsPerQuoteCall(QuoteData::Mode mode) {
+    return mode == QuoteData::Full ? 500 : 1000;
+}
 
-// --- Internal Helper Methods ---
-
-// Creates a QNetworkRequest and adds standard headers (Version, Authorization if available)
-QNetworkRequest KiteConnectAPI::createBaseRequest(const QUrl& url) {
-    QNetworkRequest request(url);
-    qDebug() << "--- createBaseRequest for URL:" << url.toString() << "---"; // Log URL entry
-
-    // Set Kite API version header
-    request.setRawHeader("X-Kite-Version", m_apiVersion.toUtf8());
-    qDebug() << "  Adding Header - X-Kite-Version:" << m_apiVersion;
-
-    // Add Authorization header if access token exists
-    if (!m_accessToken.isEmpty()) {
-        QString authHeaderValue = QString("token %1:%2").arg(m_apiKey).arg(m_accessToken);
-        request.setRawHeader("Authorization", authHeaderValue.toUtf8());
-        // Log Authorization header carefully, masking sensitive parts
-        qDebug() << "  Adding Header - Authorization: token"
-                 << m_apiKey.left(4) << "...:" << m_accessToken.left(4) << "...";
-    } else {
-        // This is normal for the initial /session/token request, warn otherwise
-        if (url.path() != "/session/token") {
-            qWarning() << "  createBaseRequest: Access Token IS EMPTY when creating request!";
-        } else {
-            qDebug() << "  createBaseRequest: Access Token is empty (expected for session request).";
-        }
+// Fetches quotes in as few calls as the per-call instrument limit allows
+QFuture<ApiResult<QVector<QuoteData>>> KiteConnectAPI::fetchQuotesAsync(QuoteData::Mode mode, const QStringList& instruments,
+                                                                        const QString& caller) {
+    using Result = ApiResult<QVector<QuoteData>>;
+    if (m_accessToken.isEmpty()) {
+        emit quotesFailed("Access token not available.");
+        return failedFuture<QVector<QuoteData>>("Access token not available.");
     }
-
-    // --- ADDED: Log all final headers being sent ---
-    qDebug() << "  Final Request Headers:";
-    QList<QByteArray> headerList = request.rawHeaderList();
-    if (headerList.isEmpty()) {
-        qDebug() << "    (No headers set)";
-    } else {
-        for(const QByteArray &headerName : headerList) {
-            qDebug() << "    " << headerName << ":" << request.rawHeader(headerName);
+    if (instruments.isEmpty())
+        return readyFuture(Result::success({}));
+
+    const KiteRequestBuilder::Endpoint endpoint =
+        mode == QuoteData::Full ? KiteRequestBuilder::Endpoint::Quote :
+        mode == QuoteData::Ohlc ? KiteRequestBuilder::Endpoint::QuoteOhlc :
+                                  KiteRequestBuilder::Endpoint::QuoteLtp;
+    const int perCall = maxInstrumentsPerQuoteCall(mode);
+    const int batches = (int(instruments.size()) + perCall - 1) / perCall;
+
+    QList<QFuture<Result>> parts;
+    parts.reserve(batches);
+    for (int b = 0; b < batches; ++b) {
+        RequestContext context;
+        context.type = RequestType::QuoteRequest;
+        context.priority = RequestPriority::High;
+        context.caller = caller;
+        context.chunkIndex = b;
+        context.chunkCount = batches;
+        parts << sendAsync(m_requests.quote(endpoint, instruments, b * perCall, perCall), std::move(context),
+                           &KiteConnectAPI::decodeQuoteResponse, &KiteConnectAPI::publishQuotes);
+    }
+    if (batches == 1) return parts.first();
+
+    return QtFuture::whenAll(parts.begin(), parts.end()).then([](const QList<QFuture<Result>>& done) {
+        Result merged = Result::success({});
+        for (const QFuture<Result>& part : done) {
+            const Result r = part.result();
+            merged.value += r.value;
+            if (!r.ok && merged.ok) { merged.ok = false; merged.error = r.error; }
         }
+        return merged;
+    });
+}
+
+
+// --- Internal Helper Methods ---
+
+// Sends a request whose reply is decoded on the network thread; the typed result is posted back
+// here, where the publisher emits the broadcast signals (so signal-based observers such as
+// DataManager see the same results as awaiting callers) before the future resolves.
+template <typename T>
+QFuture<ApiResult<T>> KiteConnectAPI::sendAsync(const QNetworkRequest& request, RequestContext context,
+                                                Decoder<T> decode, Publisher<T> publish,
+                                                const QByteArray* postBody) {
+    auto promise = std::make_shared<QPromise<ApiResult<T>>>();
+    QFuture<ApiResult<T>> future = promise->future();
+    promise->start();
+
+    context.enqueuedNs = LatencyMonitor::nowNanos();
+    context.continuation = [this, promise, decode, publish](QNetworkReply* reply, const RequestContext& ctx) {
+        // Network thread
+        ApiResult<T> result = (reply->error() != QNetworkReply::NoError)
+                                  ? ApiResult<T>::failure(describeNetworkError(reply, ctx))
+                                  : decode(reply, ctx);
+        result.requestId = ctx.requestId;
+        RequestContext meta = ctx;
+        meta.continuation = nullptr;    // it owns this closure; do not copy it across
+        QMetaObject::invokeMethod(this, [this, promise, publish, result = std::move(result), meta]() {
+            // Owner thread
+            TraceFlowScope flow(meta.traceFlow);
+            (this->*publish)(result, meta);
+            promise->addResult(result);
+            promise->finish();
+        }, Qt::QueuedConnection);
+    };
+
+    const quint64 id = postBody ? m_httpManager->sendPostRequest(request, *postBody, std::move(context))
+                                : m_httpManager->sendGetRequest(request, std::move(context));
+    if (!id) {
+        promise->addResult(ApiResult<T>::failure("Failed to create network request."));
+        promise->finish();
     }
-    qDebug() << "--- End createBaseRequest ---";
-    // --- End Added logging ---
+    return future;
+}
 
-    return request;
+// Already-finished future (precondition failures, empty requests)
+template <typename T>
+QFuture<ApiResult<T>> KiteConnectAPI::readyFuture(ApiResult<T> result) {
+    QPromise<ApiResult<T>> promise;
+    promise.start();
+    promise.addResult(std::move(result));
+    promise.finish();
+    return promise.future();
 }
 
+template <typename T>
+QFuture<ApiResult<T>> KiteConnectAPI::failedFuture(const QString& error) {
+    return readyFuture(ApiResult<T>::failure(error));
+}
 
-// --- Response Handling Slot ---
+// --- Response Handling (network thread) ---
 
-// Central slot connected to HttpManager::requestFinished
-void KiteConnectAPI::onNetworkReply(QNetworkReply* reply, RequestType type) {
-    qDebug() << "KiteConnectAPI::onNetworkReply: Called! Request Type:" << static_cast<int>(type);
+// Direct receiver of HttpManager::requestFinished
+void KiteConnectAPI::onNetworkReply(QNetworkReply* reply, const RequestContext& context) {
+    TRACE_ZONE("api", "KiteConnectAPI::onNetworkReply");
+    TRACE_FLOW_STEP("http", "request", context.traceFlow);
+    LOG_TRACE("KiteConnectAPI::onNetworkReply: #{} type {}", context.requestId, context.type);
 
     if (!reply) {
         qCritical() << "KiteConnectAPI::onNetworkReply: Received null reply object!";
         return; // Cannot proceed
     }
 
-    // Check for Qt network errors first (e.g., connection refused, timeout)
-    if (reply->error() != QNetworkReply::NoError) {
-        handleNetworkReplyError(reply, type); // Handle and log the error
-        reply->deleteLater();                 // Clean up the reply object
-        return;
-    }
-
-    // Dispatch to the appropriate handler based on the request type
-    switch (type) {
-    case RequestType::SessionRequest:
-        handleSessionResponse(reply);
-        break;
-    case RequestType::InstrumentsRequest:
-        handleInstrumentsResponse(reply);
-        break;
-    case RequestType::HistoricalDataRequest:
-    {
-        // Extract context (token, interval) from the URL path
-        // Assumes URL format like /instruments/historical/TOKEN/INTERVAL
-        QStringList pathParts = reply->url().path().split('/');
-        QString token = (pathParts.size() > 3) ? pathParts[3] : "UNKNOWN_TOKEN";
-        QString interval = (pathParts.size() > 4) ? pathParts[4] : "UNKNOWN_INTERVAL";
-        handleHistoricalDataResponse(reply, token, interval);
-    }
-    break;
-    case RequestType::ProfileRequest:
-        handleUserProfileResponse(reply);
-        break;
-    case RequestType::MarginsRequest:
-        handleUserMarginsResponse(reply);
-        break;
-    // Add cases for other future request types (OrderRequest, etc.)
-    case RequestType::InvalidRequest:
-        qWarning() << "KiteConnectAPI::onNetworkReply: Received reply for InvalidRequest type.";
-        // Should generally not happen if type is set correctly
-        break;
-    default:
-        qWarning() << "KiteConnectAPI::onNetworkReply: Unhandled request type:" << static_cast<int>(type) << "for URL:" << reply->url().toString();
-        // Handle unexpected types if necessary
-        break;
-    }
+    // Every request is sent through sendAsync, which installs the decode-and-post continuation
+    if (context.continuation)
+        context.continuation(reply, context);
+    else
+        qWarning() << "KiteConnectAPI::onNetworkReply: No handler for request type" << static_cast<int>(context.type)
+                   << "URL:" << reply->url().toString();
 
     // IMPORTANT: Delete the reply object now that processing is finished
     reply->deleteLater();
 }
 
 
-// --- Specific Response Handlers ---
+// --- Decoders (network thread) ---
 
-// Handles the JSON response for session generation
-void KiteConnectAPI::handleSessionResponse(QNetworkReply* reply) {
+// Parses a {"status": ..., "data": {...}} reply; on failure returns Kite's message or @p parseError
+static ApiResult<QJsonObject> decodeDataObject(QNetworkReply* reply, const char* where,
+                                               const QString& parseError, const QString& apiError) {
     QByteArray responseData = reply->readAll();
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
-
     if (jsonDoc.isNull() || !jsonDoc.isObject()) {
-        qWarning() << "KiteConnectAPI::handleSessionResponse: Failed to parse JSON response:" << responseData;
-        emit sessionGenerationFailed("Failed to parse session JSON response.");
-        return;
+        qWarning() << where << ": Failed to parse JSON response:" << responseData;
+        return ApiResult<QJsonObject>::failure(parseError);
     }
-
     QJsonObject jsonObject = jsonDoc.object();
     // Check the 'status' field in the JSON response
-    if (jsonObject.value("status").toString() == "success") {
-        QJsonObject data = jsonObject.value("data").toObject();
-        // Extract and store access token and user ID
-        m_accessToken = data.value("access_token").toString();
-        m_userId = data.value("user_id").toString();
-        qDebug() << "Access Token Received (First 4 chars):" << m_accessToken.left(4);
-        qDebug() << "User ID:" << m_userId;
-
-        // Persist token details using ConfigurationManager
-        ConfigurationManager* config = ConfigurationManager::instance();
-        if (config) {
-            config->setAccessToken(m_accessToken);
-            config->setAccessTokenTimestamp(QDateTime::currentDateTime());
-            // config->saveConfiguration(); // Save if setters don't auto-save
-        } else {
-            qWarning() << "ConfigManager instance null, cannot persist access token.";
-        }
-        // Signal success
-        emit sessionGenerated(m_accessToken);
-    } else {
-        // Extract error message from JSON
-        QString error = jsonObject.value("message").toString("Unknown session generation error");
-        qWarning() << "KiteConnectAPI::handleSessionResponse: API error -" << error;
-        emit sessionGenerationFailed(error);
-    }
+    if (jsonObject.value("status").toString() == "success")
+        return ApiResult<QJsonObject>::success(jsonObject.value("data").toObject());
+    QString error = jsonObject.value("message").toString(apiError);
+    qWarning() << where << ": API error -" << error;
+    return ApiResult<QJsonObject>::failure(error);
+}
+
+// Decodes the JSON response for session generation
+ApiResult<QJsonObject> KiteConnectAPI::decodeSessionResponse(QNetworkReply* reply, const RequestContext&) {
+    return decodeDataObject(reply, "KiteConnectAPI::decodeSessionResponse",
+                            "Failed to parse session JSON response.", "Unknown session generation error");
 }
 
-// Handles the CSV response for instrument list fetching
-void KiteConnectAPI::handleInstrumentsResponse(QNetworkReply* reply) {
+// Archives the CSV response for instrument list fetching and parses it, so neither the file I/O
+// nor the multi-MB parse runs on the UI thread
+ApiResult<QVector<InstrumentData>> KiteConnectAPI::decodeInstrumentsResponse(QNetworkReply* reply, const RequestContext&) {
     QByteArray responseData = reply->readAll();
 
     // Basic check if data seems valid (CSV is text, usually not empty on success)
     if (responseData.isEmpty()) {
-        qWarning() << "KiteConnectAPI::handleInstrumentsResponse: Received empty instrument data.";
-        emit instrumentsFetchFailed("Received empty instrument data.");
-        return;
+        qWarning() << "KiteConnectAPI::decodeInstrumentsResponse: Received empty instrument data.";
+        return ApiResult<QVector<InstrumentData>>::failure("Received empty instrument data.");
     }
 
-    // Determine where to save the file (e.g., application data location)
+    // Keep a date-stamped copy in the application data location (DataManager::loadInstrumentsFromFile
+    // can reload it); a failed save is logged but does not fail the fetch
     QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(dirPath);
-    if (!dir.exists()) {
-        if (!dir.mkpath(".")) {
-            qWarning() << "Failed to create application data directory:" << dirPath;
-            emit instrumentsFetchFailed("Failed to create data directory.");
-            return;
-        }
-    }
-    // Create a date-stamped filename
-    QString dateStr = QDateTime::currentDateTime().toString("yyyyMMdd");
-    QString filePath = dir.filePath(QString("instruments_%1.csv").arg(dateStr));
-
-    // Write the received data to the file
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) { // Overwrite if exists
-        file.write(responseData);
-        file.close();
-        qInfo() << "KiteConnectAPI: Instruments data saved successfully to:" << filePath;
-        // Signal success with the path to the saved file
-        emit instrumentsFetched(filePath);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qWarning() << "Failed to create application data directory:" << dirPath;
     } else {
-        qWarning() << "KiteConnectAPI: Failed to open file for writing instruments:" << filePath << file.errorString();
-        emit instrumentsFetchFailed("Failed to save instruments file: " + file.errorString());
+        QString dateStr = QDateTime::currentDateTime().toString("yyyyMMdd");
+        QString filePath = dir.filePath(QString("instruments_%1.csv").arg(dateStr));
+
+        QFile file(filePath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) { // Overwrite if exists
+            file.write(responseData);
+            file.close();
+            qInfo() << "KiteConnectAPI: Instruments data saved successfully to:" << filePath;
+        } else {
+            qWarning() << "KiteConnectAPI: Failed to open file for writing instruments:" << filePath << file.errorString();
+        }
     }
+
+    return ApiResult<QVector<InstrumentData>>::success(DataManager::parseInstrumentsCsv(responseData));
 }
 
-// Handles the JSON response for historical data
-void KiteConnectAPI::handleHistoricalDataResponse(QNetworkReply* reply, const QString& instrumentToken, const QString& interval) {
+// Decodes the JSON response for historical data straight into candles
+ApiResult<QVector<CandleData>> KiteConnectAPI::decodeHistoricalDataResponse(QNetworkReply* reply, const RequestContext& context) {
+    const QString& instrumentToken = context.instrumentToken;
     QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    QJsonDocument jsonDoc;
+    {
+        LATENCY_SCOPE("json.historical");
+        jsonDoc = QJsonDocument::fromJson(responseData);
+    }
 
     if (jsonDoc.isNull() || !jsonDoc.isObject()) {
-        qWarning() << "KiteConnectAPI::handleHistoricalDataResponse: Failed to parse JSON response for token" << instrumentToken << responseData;
-        emit historicalDataFailed("Failed to parse historical JSON response", instrumentToken + "_" + interval);
-        return;
+        qWarning() << "KiteConnectAPI::decodeHistoricalDataResponse: Failed to parse JSON response for token" << instrumentToken << responseData;
+        return ApiResult<QVector<CandleData>>::failure("Failed to parse historical JSON response");
     }
 
     QJsonObject jsonObject = jsonDoc.object();
-    if (jsonObject.value("status").toString() == "success") {
-        QJsonObject data = jsonObject.value("data").toObject();
-        QJsonArray candles = data.value("candles").toArray(); // The actual candle data array
-        qDebug() << "KiteConnectAPI: Historical data received successfully for" << instrumentToken << interval << "- Candles count:" << candles.size();
-        // Emit the raw candle array for DataManager to process
-        emit historicalDataReceived(instrumentToken, interval, candles);
-    } else {
+    if (jsonObject.value("status").toString() != "success") {
         QString error = jsonObject.value("message").toString("Unknown historical data error");
-        qWarning() << "KiteConnectAPI::handleHistoricalDataResponse: API error for" << instrumentToken << "-" << error;
-        emit historicalDataFailed(error, instrumentToken + "_" + interval);
+        qWarning() << "KiteConnectAPI::decodeHistoricalDataResponse: API error for" << instrumentToken << "-" << error;
+        return ApiResult<QVector<CandleData>>::failure(error);
     }
-}
 
-// Handles the JSON response for user profile fetching
-void KiteConnectAPI::handleUserProfileResponse(QNetworkReply* reply) {
-    QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData); // Use :: scope resolution
-    if (jsonDoc.isNull() || !jsonDoc.isObject()) {
-        qWarning() << "KiteConnectAPI::handleUserProfileResponse: Failed to parse JSON response:" << responseData;
-        emit userProfileFailed("Failed to parse profile JSON response.");
-        return;
+    // Each candle is [timestamp, open, high, low, close, volume]; malformed rows are skipped
+    const QJsonArray candles = jsonObject.value("data").toObject().value("candles").toArray();
+    QVector<CandleData> vec;
+    vec.reserve(candles.size());
+    {
+        LATENCY_SCOPE("decode.candles");
+        for (const QJsonValue &v : candles) {
+            if (!v.isArray()) continue;
+            const QJsonArray c = v.toArray();
+            if (c.size() < 6) continue; // ts,o,h,l,c,v
+
+            CandleData d;
+            d.timestamp = QDateTime::fromString(c[0].toString(), Qt::ISODateWithMs);
+            if (!d.timestamp.isValid())
+                d.timestamp = QDateTime::fromString(c[0].toString(), Qt::ISODate);
+            if (!d.timestamp.isValid()) continue;
+
+            if (!c[1].isDouble() || !c[2].isDouble() || !c[3].isDouble() || !c[4].isDouble())
+                continue;
+
+            d.open  = c[1].toDouble();
+            d.high  = c[2].toDouble();
+            d.low   = c[3].toDouble();
+            d.close = c[4].toDouble();
+
+            bool volOk = false;
+            d.volume = c[5].toVariant().toLongLong(&volOk);
+            if (!volOk) continue;
+
+            vec.append(d);
+        }
     }
-    QJsonObject jsonObject = jsonDoc.object();
-    if (jsonObject.value("status").toString() == "success") {
-        QJsonObject data = jsonObject.value("data").toObject();
-        m_userId = data.value("user_id").toString(); // Store user ID locally if needed elsewhere
-        qDebug() << "KiteConnectAPI: User Profile received successfully. UserID:" << m_userId;
-        // Emit the profile data object
-        emit userProfileReceived(data);
-    } else {
-        QString error = jsonObject.value("message").toString("Unknown profile error");
-        qWarning() << "KiteConnectAPI::handleUserProfileResponse: API error -" << error;
-        emit userProfileFailed(error);
+    LOG_DEBUG("KiteConnectAPI: historical {} {} -> {} candles", instrumentToken, context.interval, vec.size());
+    return ApiResult<QVector<CandleData>>::success(std::move(vec));
+}
+
+// Decodes the JSON response for user profile fetching
+ApiResult<QJsonObject> KiteConnectAPI::decodeUserProfileResponse(QNetworkReply* reply, const RequestContext&) {
+    return decodeDataObject(reply, "KiteConnectAPI::decodeUserProfileResponse",
+                            "Failed to parse profile JSON response.", "Unknown profile error");
+}
+
+// Decodes the JSON response for user margin fetching
+ApiResult<QJsonObject> KiteConnectAPI::decodeUserMarginsResponse(QNetworkReply* reply, const RequestContext&) {
+    return decodeDataObject(reply, "KiteConnectAPI::decodeUserMarginsResponse",
+                            "Failed to parse margins JSON response.", "Unknown margins error");
+}
+
+
+// "yyyy-MM-dd HH:mm:ss" in exchange time (IST, UTC+5:30) -> ms since epoch; 0 if malformed.
+// Hand-rolled: quote batches carry two timestamps per instrument and QDateTime parsing dominates.
+static qint64 parseExchangeTimestampMs(const QString& text) {
+    if (text.size() != 19) return 0;
+    const QChar* p = text.constData();
+    auto num = [p](int at, int len) {
+        int v = 0;
+        for (int i = at; i < at + len; ++i) {
+            const int d = p[i].unicode() - '0';
+            if (d < 0 || d > 9) return -1;
+            v = v * 10 + d;
+        }
+        return v;
+    };
+    const int y = num(0, 4), mo = num(5, 2), d = num(8, 2), h = num(11, 2), mi = num(14, 2), sec = num(17, 2);
+    const QDate date(y, mo, d);
+    if (!date.isValid() || h < 0 || mi < 0 || sec < 0) return 0;
+    const qint64 days = date.toJulianDay() - 2440588; // days since 1970-01-01
+    return ((days * 86400) + h * 3600 + mi * 60 + sec - 19800) * 1000;
+}
+
+static void parseDepthSide(const QJsonArray& levels, QuoteDepthLevel (&out)[5]) {
+    const int n = qMin(5, int(levels.size()));
+    for (int i = 0; i < n; ++i) {
+        const QJsonObject level = levels.at(i).toObject();
+        out[i].price = level.value("price").toDouble();
+        out[i].quantity = level.value("quantity").toInt();
+        out[i].orders = level.value("orders").toInt();
     }
 }
 
-// Handles the JSON response for user margin fetching
-void KiteConnectAPI::handleUserMarginsResponse(QNetworkReply* reply) {
+// Decodes the JSON response for one quote batch (/quote, /quote/ohlc or /quote/ltp)
+ApiResult<QVector<QuoteData>> KiteConnectAPI::decodeQuoteResponse(QNetworkReply* reply, const RequestContext& context) {
     QByteArray responseData = reply->readAll();
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData); // Use :: scope resolution
-    if (jsonDoc.isNull() || !jsonDoc.isObject()) {
-        qWarning() << "KiteConnectAPI::handleUserMarginsResponse: Failed to parse JSON response:" << responseData;
-        emit userMarginsFailed("Failed to parse margins JSON response.");
-        return;
+    QJsonDocument jsonDoc;
+    {
+        LATENCY_SCOPE("json.quote");
+        jsonDoc = QJsonDocument::fromJson(responseData);
     }
-    QJsonObject jsonObject = jsonDoc.object();
-    if (jsonObject.value("status").toString() == "success") {
-        QJsonObject data = jsonObject.value("data").toObject(); // Contains equity/commodity nodes
-        qDebug() << "KiteConnectAPI: User Margins received successfully.";
-        // Emit the margin data object
-        emit userMarginsReceived(data);
-    } else {
-        QString error = jsonObject.value("message").toString("Unknown margins error");
-        qWarning() << "KiteConnectAPI::handleUserMarginsResponse: API error -" << error;
-        emit userMarginsFailed(error);
+    const QJsonObject jsonObject = jsonDoc.object();
+    if (jsonDoc.isNull() || !jsonDoc.isObject() || jsonObject.value("status").toString() != "success") {
+        const QString error = jsonObject.value("message").toString("Failed to parse quote JSON response");
+        qWarning() << "KiteConnectAPI::decodeQuoteResponse: batch" << context.chunkIndex + 1 << "of" << context.chunkCount << "-" << error;
+        return ApiResult<QVector<QuoteData>>::failure(error);
+    }
+
+    const QJsonObject data = jsonObject.value("data").toObject();
+    QVector<QuoteData> quotes;
+    quotes.reserve(data.size());
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        const QJsonObject o = it.value().toObject();
+        QuoteData q;
+        q.instrumentToken = quint32(o.value("instrument_token").toDouble());
+        q.lastPrice = o.value("last_price").toDouble();
+
+        const QJsonValue ohlcValue = o.value("ohlc");
+        if (ohlcValue.isObject()) {
+            const QJsonObject ohlc = ohlcValue.toObject();
+            q.mode = QuoteData::Ohlc;
+            q.open = ohlc.value("open").toDouble();
+            q.high = ohlc.value("high").toDouble();
+            q.low = ohlc.value("low").toDouble();
+            q.close = ohlc.value("close").toDouble();
+        }
+        const QJsonValue depthValue = o.value("depth");
+        if (depthValue.isObject()) {
+            const QJsonObject depth = depthValue.toObject();
+            q.mode = QuoteData::Full;
+            q.timestampMs = parseExchangeTimestampMs(o.value("timestamp").toString());
+            q.lastTradeTimeMs = parseExchangeTimestampMs(o.value("last_trade_time").toString());
+            q.netChange = o.value("net_change").toDouble();
+            q.averagePrice = o.value("average_price").toDouble();
+            q.lowerCircuit = o.value("lower_circuit_limit").toDouble();
+            q.upperCircuit = o.value("upper_circuit_limit").toDouble();
+            q.lastQuantity = qint64(o.value("last_quantity").toDouble());
+            q.volume = qint64(o.value("volume").toDouble());
+            q.buyQuantity = qint64(o.value("buy_quantity").toDouble());
+            q.sellQuantity = qint64(o.value("sell_quantity").toDouble());
+            q.oi = qint64(o.value("oi").toDouble());
+            q.oiDayHigh = qint64(o.value("oi_day_high").toDouble());
+            q.oiDayLow = qint64(o.value("oi_day_low").toDouble());
+            parseDepthSide(depth.value("buy").toArray(), q.buy);
+            parseDepthSide(depth.value("sell").toArray(), q.sell);
+        }
+        quotes.append(q);
     }
-}
 
+    return ApiResult<QVector<QuoteData>>::success(std::move(quotes));
+}
 
 // --- Error Handler ---
 
-// Handles network-level errors reported by QNetworkReply
-void KiteConnectAPI::handleNetworkReplyError(QNetworkReply* reply, RequestType type) {
+// Logs a network-level error reported by QNetworkReply; the publisher emits the failure signal
+QString KiteConnectAPI::describeNetworkError(QNetworkReply* reply, const RequestContext& context) {
+    const RequestType type = context.type;
     QString err = reply->errorString(); // Qt's description of the error
     QNetworkReply::NetworkError code = reply->error(); // The Qt network error code
     QUrl url = reply->url(); // The URL that failed
@@ -473,38 +588,80 @@ void KiteConnectAPI::handleNetworkReplyError(QNetworkReply* reply, RequestType t
     QByteArray responseBody = reply->peek(512);
 
     // Log detailed error information
-    qCritical().noquote() << QString("Network Error: Type=%1, Code=%2, HTTP=%3, URL=%4, Error=%5, Response=%6")
+    qCritical().noquote() << QString("Network Error: Request=#%7, Type=%1, Code=%2, HTTP=%3, URL=%4, Error=%5, Response=%6, Attempts=%8")
                                  .arg(static_cast<int>(type))
                                  .arg(static_cast<int>(code))
                                  .arg(httpStatusCode)
                                  .arg(url.toString())
                                  .arg(err)
-                                 .arg(QString::fromUtf8(responseBody));
+                                 .arg(QString::fromUtf8(responseBody))
+                                 .arg(context.requestId)
+                                 .arg(context.attempt);
 
     // Create a combined error message for signals
-    QString finalDetailedError = QString("Network Error (%1): %2 (HTTP %3)")
-                                     .arg(static_cast<int>(code)) // Include Qt error code
-                                     .arg(err)
-                                     .arg(httpStatusCode); // Include HTTP status
-
-    // Emit the appropriate specific failure signal based on the request type
-    switch (type) {
-    case RequestType::SessionRequest: emit sessionGenerationFailed(finalDetailedError); break;
-    case RequestType::InstrumentsRequest: emit instrumentsFetchFailed(finalDetailedError); break;
-    case RequestType::HistoricalDataRequest:
-    {
-        QStringList pathParts = reply->url().path().split('/');
-        QString token = (pathParts.size() > 3) ? pathParts[3] : "Unknown";
-        QString interval = (pathParts.size() > 4) ? pathParts[4] : "Unknown";
-        emit historicalDataFailed(finalDetailedError, token + "_" + interval);
+    return QString("Network Error (%1): %2 (HTTP %3)")
+        .arg(static_cast<int>(code)) // Include Qt error code
+        .arg(err)
+        .arg(httpStatusCode); // Include HTTP status
+}
+
+
+// --- Publishers (owner thread) ---
+
+// Stores the new session, persists it and announces it
+void KiteConnectAPI::publishSession(const ApiResult<QJsonObject>& result, const RequestContext&) {
+    if (!result.ok) {
+        emit sessionGenerationFailed(result.error);
+        return;
     }
-    break;
-    case RequestType::ProfileRequest: emit userProfileFailed(finalDetailedError); break;
-    case RequestType::MarginsRequest: emit userMarginsFailed(finalDetailedError); break;
-    // Add cases for other request types as needed
-    default:
-        qWarning() << "Emitting generic API error for unhandled network error type:" << static_cast<int>(type);
-        emit apiErrorOccurred(finalDetailedError); // Emit a generic signal for unhandled types
-        break;
+    // Extract and store access token and user ID
+    m_accessToken = result.value.value("access_token").toString();
+    m_userId = result.value.value("user_id").toString();
+    m_requests.setSession(m_apiKey, m_accessToken);
+    // The login round trip (browser, then token exchange) may have let the pool go idle
+    m_httpManager->warmUp(QUrl(m_requests.baseUrl()));
+    qDebug() << "Access Token Received (First 4 chars):" << m_accessToken.left(4);
+    qDebug() << "User ID:" << m_userId;
+
+    // Persist token details using ConfigurationManager
+    ConfigurationManager* config = ConfigurationManager::instance();
+    if (config) {
+        config->setAccessToken(m_accessToken);
+        config->setAccessTokenTimestamp(QDateTime::currentDateTime());
+        // config->saveConfiguration(); // Save if setters don't auto-save
+    } else {
+        qWarning() << "ConfigManager instance null, cannot persist access token.";
+    }
+    // Signal success
+    emit sessionGenerated(m_accessToken);
+}
+
+void KiteConnectAPI::publishInstruments(const ApiResult<QVector<InstrumentData>>& result, const RequestContext&) {
+    if (result.ok) emit instrumentsFetched(result.value);
+    else emit instrumentsFetchFailed(result.error);
+}
+
+void KiteConnectAPI::publishHistoricalData(const ApiResult<QVector<CandleData>>& result, const RequestContext& context) {
+    if (result.ok) emit historicalDataReceived(context.instrumentToken, context.interval, result.value);
+    else emit historicalDataFailed(result.error, context.label());
+}
+
+void KiteConnectAPI::publishUserProfile(const ApiResult<QJsonObject>& result, const RequestContext&) {
+    if (!result.ok) {
+        emit userProfileFailed(result.error);
+        return;
     }
+    m_userId = result.value.value("user_id").toString(); // Store user ID locally if needed elsewhere
+    qDebug() << "KiteConnectAPI: User Profile received successfully. UserID:" << m_userId;
+    emit userProfileReceived(result.value);
+}
+
+void KiteConnectAPI::publishUserMargins(const ApiResult<QJsonObject>& result, const RequestContext&) {
+    if (result.ok) emit userMarginsReceived(result.value);
+    else emit userMarginsFailed(result.error);
+}
+
+void KiteConnectAPI::publishQuotes(const ApiResult<QVector<QuoteData>>& result, const RequestContext&) {
+    if (result.ok) emit quotesReceived(result.value);
+    else emit quotesFailed(result.error);
 }
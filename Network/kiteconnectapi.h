@@ -9,28 +9,35 @@
 #include <QUrl>
 #include <QQueue>
 #include <QMetaType> // Include for Q_DECLARE_METATYPE
+#include <QFuture>
+#include "Network/kiterequestbuilder.h"
+#include "Network/requestcontext.h"
+#include "Data/DataStructures/candle.h"
+#include "Data/DataStructures/quotedata.h"
+#include "Data/DataStructures/instrumentdata.h"
 
 // Forward declaration
 class HttpManager;
+class QThread;
 class ConfigurationManager;
 
 /**
- * @brief Defines the types of API requests managed by KiteConnectAPI.
+ * @brief Typed outcome of an awaitable API call.
+ *
+ * Failures are values, not exceptions: @c ok is false and @c error carries the same message the
+ * matching *Failed signal was emitted with.
  */
-enum class RequestType {
-    InvalidRequest = 0,         ///< Default or error type
-    InstrumentsRequest = 1,     ///< Fetching instrument list (CSV)
-    HistoricalDataRequest = 2,  ///< Fetching historical candles (JSON)
-    SessionRequest = 3,         ///< Generating session/access token (JSON)
-    ProfileRequest = 4,         ///< Fetching user profile (JSON)
-    MarginsRequest = 5,         ///< Fetching user margins (JSON)
-    OrderRequest = 6,           ///< Placeholder for Order related requests
-    QuoteRequest = 7,           ///< Placeholder for Quote requests
-    HoldingsRequest = 8,        ///< Placeholder for Holdings requests
-    PositionsRequest = 9        ///< Placeholder for Positions requests
+template <typename T>
+struct ApiResult {
+    bool ok = false;
+    T value{};
+    QString error;
+    quint64 requestId = 0;  ///< HttpManager request ID (0 if nothing was sent).
+
+    static ApiResult success(T v) { ApiResult r; r.ok = true; r.value = std::move(v); return r; }
+    static ApiResult failure(const QString& e) { ApiResult r; r.error = e; return r; }
 };
-// Make RequestType usable with QVariant for storing in QObject properties
-Q_DECLARE_METATYPE(RequestType)
+
 
 
 /**
@@ -38,6 +45,12 @@ Q_DECLARE_METATYPE(RequestType)
  *
  * Handles authentication, session management, data fetching (instruments, historical, profile, margins),
  * and potentially order management in the future. Uses HttpManager for network communication.
+ *
+ * HttpManager runs on a dedicated network thread ("net-io") with its own event loop. Replies are
+ * read and decoded there (JSON parsing, candle conversion, the instrument CSV write); only the
+ * typed result crosses back to this object's thread, where state is updated and signals are
+ * emitted. A slow UI therefore never delays a socket read, and a burst of replies never stalls
+ * the UI.
  */
 class KiteConnectAPI : public QObject
 {
@@ -92,6 +105,44 @@ public:
      */
     void fetchUserMargins();
 
+    // --- Awaitable API ---
+    // Each call returns a future resolved (on this object's thread) with the typed result, already
+    // decoded on the network thread, so
+    // callers can issue several requests at once and join on them (QtFuture::whenAll, .then).
+    // The broadcast signals are emitted as well; the fire-and-forget methods above are these
+    // calls with the future discarded.
+
+    /** @brief Downloads the instrument CSV; resolves with the NIFTY/BANKNIFTY derivative rows parsed from it. */
+    QFuture<ApiResult<QVector<InstrumentData>>> fetchAllInstrumentsAsync();
+    /** @brief Resolves with the parsed candles for one token/interval/range. */
+    QFuture<ApiResult<QVector<CandleData>>> fetchHistoricalDataAsync(const QString& instrumentToken, const QString& interval,
+                                                            const QString& from, const QString& to);
+    /** @brief Resolves with the "data" object of /user/profile. */
+    QFuture<ApiResult<QJsonObject>> fetchUserProfileAsync();
+    /** @brief Resolves with the "data" object of /user/margins. */
+    QFuture<ApiResult<QJsonObject>> fetchUserMarginsAsync();
+
+    /**
+     * @brief Quotes for any number of instruments (tokens or "EXCHANGE:TRADINGSYMBOL").
+     *
+     * The list is packed into as few calls as Kite allows (500 per /quote, 1000 per /quote/ohlc
+     * and /quote/ltp) and the calls are issued together; HttpManager paces them. Resolves once
+     * every batch has answered: @c ok only if all did, @c value holds whatever was parsed.
+     * quotesReceived() is emitted per batch as it arrives.
+     * @param caller Fair-queuing key: pollers sharing the quote limit are served round-robin.
+     */
+    QFuture<ApiResult<QVector<QuoteData>>> fetchQuotesAsync(QuoteData::Mode mode, const QStringList& instruments,
+                                                            const QString& caller = QString());
+    /** @brief Maximum instruments Kite accepts in one call of the given mode. */
+    static int maxInstrumentsPerQuoteCall(QuoteData::Mode mode);
+
+    /**
+     * @brief Aborts an in-flight request by the ID HttpManager assigned it. A cancelled request
+     * fails with OperationCanceledError through its usual signal; one that already finished is
+     * left alone.
+     */
+    void cancelRequest(quint64 requestId);
+
     // --- Accessors ---
 
     /**
@@ -123,10 +174,10 @@ signals:
     void sessionGenerationFailed(const QString& error);
 
     /**
-     * @brief Emitted after successfully downloading the instruments CSV file.
-     * @param filePath The path to the saved CSV file.
+     * @brief Emitted after successfully downloading and parsing the instruments CSV file.
+     * @param instruments The NIFTY/BANKNIFTY derivative rows (DataManager::parseInstrumentsCsv).
      */
-    void instrumentsFetched(const QString& filePath);
+    void instrumentsFetched(const QVector<InstrumentData>& instruments);
 
     /**
      * @brief Emitted if fetching or saving the instruments file fails.
@@ -138,9 +189,9 @@ signals:
      * @brief Emitted after successfully receiving historical candle data.
      * @param instrumentToken The token for which data was received.
      * @param interval The interval for which data was received.
-     * @param candles The array of candle data (JSON format from Kite).
+     * @param candles Parsed candles, in the order Kite returned them (malformed rows dropped).
      */
-    void historicalDataReceived(const QString& instrumentToken, const QString& interval, const QJsonArray& candles);
+    void historicalDataReceived(const QString& instrumentToken, const QString& interval, const QVector<CandleData>& candles);
 
     /**
      * @brief Emitted if fetching historical data fails.
@@ -173,6 +224,18 @@ signals:
      */
     void userMarginsFailed(const QString& error);
 
+    /**
+     * @brief Emitted for every quote batch that parsed successfully.
+     * @param quotes One entry per instrument in the batch (order not guaranteed).
+     */
+    void quotesReceived(const QVector<QuoteData>& quotes);
+
+    /**
+     * @brief Emitted if a quote batch fails.
+     * @param error Error message description.
+     */
+    void quotesFailed(const QString& error);
+
     /**
      * @brief Emitted for other generic API errors not covered by specific signals.
      * @param error Error message description.
@@ -186,49 +249,77 @@ signals:
     void requiresUserLoginRedirect(const QUrl& url);
 
 
-private slots:
+private:
     /**
-     * @brief Central slot connected to HttpManager::requestFinished.
-     * Handles dispatching the network reply to the appropriate handler based on RequestType.
+     * @brief Receiver of HttpManager::requestFinished, called directly on the network thread.
+     * Runs the context's continuation (decode, then post the result back here) and deletes the reply.
      * @param reply Pointer to the completed QNetworkReply.
-     * @param type The RequestType associated with the reply.
+     * @param context The context the request was sent with.
      */
-    void onNetworkReply(QNetworkReply* reply, RequestType type);
-
-private:
-    // --- Internal Helper Methods ---
+    void onNetworkReply(QNetworkReply* reply, const RequestContext& context);
+
+    // --- Decoders (network thread) ---
+    // Pure functions of the reply: they log, but touch no member state and emit nothing.
+
+    /** @brief Decodes a SessionRequest reply into its "data" object. */
+    static ApiResult<QJsonObject> decodeSessionResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Archives an InstrumentsRequest CSV and parses it; resolves with the derivative rows. */
+    static ApiResult<QVector<InstrumentData>> decodeInstrumentsResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Decodes a HistoricalDataRequest reply into candles. */
+    static ApiResult<QVector<CandleData>> decodeHistoricalDataResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Decodes a ProfileRequest reply into its "data" object. */
+    static ApiResult<QJsonObject> decodeUserProfileResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Decodes a MarginsRequest reply into its "data" object. */
+    static ApiResult<QJsonObject> decodeUserMarginsResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Decodes one QuoteRequest batch. */
+    static ApiResult<QVector<QuoteData>> decodeQuoteResponse(QNetworkReply* reply, const RequestContext& context);
+    /** @brief Logs a network error reported by QNetworkReply and returns the message for the failure signal. */
+    static QString describeNetworkError(QNetworkReply* reply, const RequestContext& context);
+
+    // --- Publishers (this object's thread) ---
+    // Apply a decoded result to member state and emit the matching success or failure signal.
+
+    void publishSession(const ApiResult<QJsonObject>& result, const RequestContext& context);
+    void publishInstruments(const ApiResult<QVector<InstrumentData>>& result, const RequestContext& context);
+    void publishHistoricalData(const ApiResult<QVector<CandleData>>& result, const RequestContext& context);
+    void publishUserProfile(const ApiResult<QJsonObject>& result, const RequestContext& context);
+    void publishUserMargins(const ApiResult<QJsonObject>& result, const RequestContext& context);
+    void publishQuotes(const ApiResult<QVector<QuoteData>>& result, const RequestContext& context);
+
+    template <typename T>
+    using Decoder = ApiResult<T> (*)(QNetworkReply*, const RequestContext&);
+    template <typename T>
+    using Publisher = void (KiteConnectAPI::*)(const ApiResult<T>&, const RequestContext&);
 
     /**
-     * @brief Creates a QNetworkRequest with standard headers (Auth, Version).
-     * @param url The target URL for the request.
-     * @return Configured QNetworkRequest object.
+     * @brief Sends a request (a POST when @p postBody is given) whose reply is decoded on the
+     * network thread by @p decode, then published here and used to resolve the returned future.
      */
-    QNetworkRequest createBaseRequest(const QUrl& url);
-
-    /** @brief Handles the response for a SessionRequest. */
-    void handleSessionResponse(QNetworkReply* reply);
-    /** @brief Handles the response for an InstrumentsRequest. */
-    void handleInstrumentsResponse(QNetworkReply* reply);
-    /** @brief Handles the response for a HistoricalDataRequest. */
-    void handleHistoricalDataResponse(QNetworkReply* reply, const QString& instrumentToken, const QString& interval);
-    /** @brief Handles the response for a ProfileRequest. */
-    void handleUserProfileResponse(QNetworkReply* reply);
-    /** @brief Handles the response for a MarginsRequest. */
-    void handleUserMarginsResponse(QNetworkReply* reply);
-    /** @brief Handles network errors reported by QNetworkReply. */
-    void handleNetworkReplyError(QNetworkReply* reply, RequestType type);
+    template <typename T>
+    QFuture<ApiResult<T>> sendAsync(const QNetworkRequest& request, RequestContext context,
+                                    Decoder<T> decode, Publisher<T> publish,
+                                    const QByteArray* postBody = nullptr);
+    /** @brief An already-finished future holding @p result. */
+    template <typename T>
+    static QFuture<ApiResult<T>> readyFuture(ApiResult<T> result);
+    /** @brief An already-finished future holding a failure. */
+    template <typename T>
+    static QFuture<ApiResult<T>> failedFuture(const QString& error);
 
     // --- Member Variables ---
-    HttpManager* m_httpManager;     // Handles actual HTTP communication.
+    QThread* m_ioThread;            // Network thread: HttpManager's event loop and reply decoding.
+    HttpManager* m_httpManager;     // Handles actual HTTP communication; lives on m_ioThread.
     QString m_apiKey;               // User's API key.
     QString m_apiSecret;            // User's API secret (fetched from config).
     QString m_accessToken;          // Session access token.
     QString m_userId;               // User's ID (from session/profile).
 
     // --- Constants ---
-    const QString m_baseUrl = "https://api.kite.trade";             ///< Base URL for API calls.
-    const QString m_loginUrl = "https://kite.zerodha.com/connect/login"; ///< URL for web login initiation.
+    const QString m_baseUrl = "https://api.kite.trade";             ///< Default base URL for API calls.
+    QString m_loginUrl = "https://kite.zerodha.com/connect/login";  ///< URL for web login initiation.
     const QString m_apiVersion = "3";                               ///< Kite Connect API version.
+
+    KiteRequestBuilder m_requests;  // Cached headers/URL prefixes; re-keyed when the session changes.
 };
 
 #endif // KITE_CONNECT_API_H
@@ -0,0 +1,147 @@
+#include "Network/kiterequestbuilder.h"
+
+#include <QUrl>
+
+namespace {
+// Path of each Endpoint, in enum order.
+const char* const kEndpointPaths[] = {
+    "/session/token",
+    "/instruments",
+    "/instruments/historical/",
+    "/user/profile",
+    "/user/margins",
+    "/quote",
+    "/quote/ohlc",
+    "/quote/ltp",
+    "/orders/",
+};
+static_assert(sizeof(kEndpointPaths) / sizeof(kEndpointPaths[0]) == int(KiteRequestBuilder::Endpoint::Count),
+              "kEndpointPaths must list every Endpoint");
+}
+
+KiteRequestBuilder::KiteRequestBuilder(const QString& baseUrl, const QString& apiVersion)
+    : m_versionHeader(apiVersion.toLatin1())
+{
+    m_url.reserve(256);
+    setBaseUrl(baseUrl);
+    rebuildTemplates();
+}
+
+void KiteRequestBuilder::setBaseUrl(const QString& baseUrl)
+{
+    m_baseUrl = baseUrl.toLatin1();
+    while (m_baseUrl.endsWith('/')) m_baseUrl.chop(1);
+    for (int i = 0; i < int(Endpoint::Count); ++i)
+        m_prefixes[i] = m_baseUrl + kEndpointPaths[i];
+}
+
+void KiteRequestBuilder::setSession(const QString& apiKey, const QString& accessToken)
+{
+    if (accessToken.isEmpty()) {
+        m_authHeader.clear();
+    } else {
+        m_authHeader = "token ";
+        m_authHeader += apiKey.toUtf8();
+        m_authHeader += ':';
+        m_authHeader += accessToken.toUtf8();
+    }
+    rebuildTemplates();
+}
+
+void KiteRequestBuilder::rebuildTemplates()
+{
+    m_getTemplate = QNetworkRequest();
+    m_getTemplate.setRawHeader("X-Kite-Version", m_versionHeader);
+    if (!m_authHeader.isEmpty())
+        m_getTemplate.setRawHeader("Authorization", m_authHeader);
+
+    m_formTemplate = m_getTemplate;
+    m_formTemplate.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+}
+
+// ---------- assembly ----------
+void KiteRequestBuilder::appendAscii(QByteArray& out, const QString& s)
+{
+    // Tokens, intervals, varieties and timestamps are plain ASCII: copy code units directly
+    // instead of going through a temporary toLatin1()/toUtf8() buffer.
+    const QChar* p = s.constData();
+    for (int i = 0, n = int(s.size()); i < n; ++i)
+        out.append(char(p[i].unicode()));
+}
+
+void KiteRequestBuilder::appendQueryValue(QByteArray& out, const QString& s)
+{
+    // Trading symbols can contain '&' (M&M) or other reserved characters
+    static const char hex[] = "0123456789ABCDEF";
+    const QByteArray utf8 = s.toUtf8();
+    for (const char ch : utf8) {
+        const uchar c = uchar(ch);
+        const bool plain = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                           c == '-' || c == '_' || c == '.' || c == '~' || c == ':';
+        if (plain) {
+            out.append(char(c));
+        } else {
+            out.append('%');
+            out.append(hex[c >> 4]);
+            out.append(hex[c & 0xF]);
+        }
+    }
+}
+
+void KiteRequestBuilder::startUrl(Endpoint endpoint, const QString& pathSuffix)
+{
+    m_url.resize(0);    // keeps capacity
+    m_url.append(m_prefixes[int(endpoint)]);
+    if (!pathSuffix.isEmpty()) {
+        if (!m_url.endsWith('/')) m_url.append('/');
+        appendAscii(m_url, pathSuffix);
+    }
+}
+
+QNetworkRequest KiteRequestBuilder::fromBuffer(const QNetworkRequest& tmpl) const
+{
+    QNetworkRequest request(tmpl);  // shares the template's header list until setUrl detaches it
+    request.setUrl(QUrl::fromEncoded(m_url));
+    return request;
+}
+
+QNetworkRequest KiteRequestBuilder::request(Endpoint endpoint, const QString& pathSuffix)
+{
+    startUrl(endpoint, pathSuffix);
+    return fromBuffer(m_getTemplate);
+}
+
+QNetworkRequest KiteRequestBuilder::formRequest(Endpoint endpoint, const QString& pathSuffix)
+{
+    startUrl(endpoint, pathSuffix);
+    return fromBuffer(m_formTemplate);
+}
+
+QNetworkRequest KiteRequestBuilder::historical(const QString& instrumentToken, const QString& interval,
+                                               const QString& from, const QString& to, bool continuous)
+{
+    m_url.resize(0);
+    m_url.append(m_prefixes[int(Endpoint::Historical)]);
+    appendAscii(m_url, instrumentToken);
+    m_url.append('/');
+    appendAscii(m_url, interval);
+    m_url.append("?from=");
+    appendAscii(m_url, from);
+    m_url.append("&to=");
+    appendAscii(m_url, to);
+    if (continuous)
+        m_url.append("&continuous=1");
+    return fromBuffer(m_getTemplate);
+}
+
+QNetworkRequest KiteRequestBuilder::quote(Endpoint endpoint, const QStringList& instruments, int first, int count)
+{
+    m_url.resize(0);
+    m_url.append(m_prefixes[int(endpoint)]);
+    const int end = qMin(int(instruments.size()), first + count);
+    for (int i = first; i < end; ++i) {
+        m_url.append(i == first ? "?i=" : "&i=");
+        appendQueryValue(m_url, instruments.at(i));
+    }
+    return fromBuffer(m_getTemplate);
+}
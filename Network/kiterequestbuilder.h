@@ -0,0 +1,105 @@
+#ifndef KITEREQUESTBUILDER_H
+#define KITEREQUESTBUILDER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QNetworkRequest>
+#include <QStringList>
+
+/**
+ * @brief Assembles Kite Connect requests from pre-built templates.
+ *
+ * The encoded X-Kite-Version and Authorization headers are built once per session (in
+ * setSession()) and baked into template QNetworkRequests; every request is a copy of a template
+ * plus a URL. URL prefixes are precomputed per endpoint and URLs are written into one reusable
+ * byte buffer, so the per-request cost is a few appends and one QUrl parse. Nothing here logs.
+ *
+ * Not thread-safe (the URL buffer is shared); use from the thread that owns KiteConnectAPI.
+ */
+class KiteRequestBuilder
+{
+public:
+    /**
+     * @brief REST endpoints with a fixed path prefix.
+     */
+    enum class Endpoint {
+        SessionToken = 0,   ///< POST /session/token
+        Instruments,        ///< GET /instruments
+        Historical,         ///< GET /instruments/historical/{token}/{interval}
+        UserProfile,        ///< GET /user/profile
+        UserMargins,        ///< GET /user/margins
+        Quote,              ///< GET /quote
+        QuoteOhlc,          ///< GET /quote/ohlc
+        QuoteLtp,           ///< GET /quote/ltp
+        Orders,             ///< POST/PUT/DELETE /orders/{variety}[/{order_id}]
+        Count
+    };
+
+    /**
+     * @brief Constructor.
+     * @param baseUrl API root, e.g. "https://api.kite.trade" (no trailing slash).
+     * @param apiVersion Value of the X-Kite-Version header.
+     */
+    explicit KiteRequestBuilder(const QString& baseUrl, const QString& apiVersion);
+
+    /**
+     * @brief Changes the API root and recomputes every endpoint prefix.
+     */
+    void setBaseUrl(const QString& baseUrl);
+    QString baseUrl() const { return QString::fromLatin1(m_baseUrl); }
+
+    /**
+     * @brief Caches the Authorization header ("token api_key:access_token") for the session.
+     * Pass an empty access token to drop it (requests are then built without Authorization).
+     */
+    void setSession(const QString& apiKey, const QString& accessToken);
+    bool hasSession() const { return !m_authHeader.isEmpty(); }
+
+    /**
+     * @brief Authenticated request for a fixed endpoint.
+     * @param endpoint Endpoint whose prefix starts the URL.
+     * @param pathSuffix Optional path appended after the prefix (e.g. "regular" for Orders).
+     */
+    QNetworkRequest request(Endpoint endpoint, const QString& pathSuffix = QString());
+
+    /**
+     * @brief Authenticated request with a form-encoded body (orders). Session creation uses it
+     * before any token exists, in which case the Authorization header is simply absent.
+     */
+    QNetworkRequest formRequest(Endpoint endpoint, const QString& pathSuffix = QString());
+
+    /**
+     * @brief GET /instruments/historical/{token}/{interval}?from=..&to=..[&continuous=1].
+     * from/to are passed through as-is ("yyyy-MM-dd+HH:mm:ss").
+     */
+    QNetworkRequest historical(const QString& instrumentToken, const QString& interval,
+                               const QString& from, const QString& to, bool continuous);
+
+    /**
+     * @brief GET /quote[/ohlc|/ltp]?i=..&i=.. for instruments[first, first + count).
+     * Instruments are tokens or "EXCHANGE:TRADINGSYMBOL"; reserved characters are escaped.
+     */
+    QNetworkRequest quote(Endpoint endpoint, const QStringList& instruments, int first, int count);
+
+    /**
+     * @brief Encoded URL prefix of an endpoint (base URL + path), e.g. for matching replies.
+     */
+    const QByteArray& prefix(Endpoint endpoint) const { return m_prefixes[int(endpoint)]; }
+
+private:
+    void rebuildTemplates();
+    QNetworkRequest fromBuffer(const QNetworkRequest& tmpl) const;
+    void startUrl(Endpoint endpoint, const QString& pathSuffix);
+    static void appendAscii(QByteArray& out, const QString& s);
+    static void appendQueryValue(QByteArray& out, const QString& s);
+
+    QByteArray m_baseUrl;
+    QByteArray m_prefixes[int(Endpoint::Count)];
+    QByteArray m_versionHeader;
+    QByteArray m_authHeader;            ///< Empty until a session exists.
+    QNetworkRequest m_getTemplate;      ///< Version (+ Authorization) headers.
+    QNetworkRequest m_formTemplate;     ///< As above plus form Content-Type.
+    QByteArray m_url;                   ///< Reused URL buffer; keeps its capacity between calls.
+};
+
+#endif // KITEREQUESTBUILDER_H
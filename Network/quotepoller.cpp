@@ -0,0 +1,103 @@
+#include "Network/quotepoller.h"
+#include "Network/kiteconnectapi.h"
+
+#include <QTimer>
+#include <QJsonArray>
+#include <QDebug>
+
+QuotePoller::QuotePoller(KiteConnectAPI* api, QObject* parent)
+    : QObject(parent), m_api(api)
+{
+}
+
+QuoteData::Mode QuotePoller::modeFromString(const QString& mode)
+{
+    const QString m = mode.trimmed().toLower();
+    if (m == "full" || m == "quote") return QuoteData::Full;
+    if (m == "ohlc") return QuoteData::Ohlc;
+    return QuoteData::Ltp;
+}
+
+void QuotePoller::setGroup(const Group& group)
+{
+    if (group.name.isEmpty()) {
+        qWarning() << "QuotePoller::setGroup: group needs a name.";
+        return;
+    }
+    Slot& slot = m_groups[group.name];
+    slot.group = group;
+    slot.group.intervalMs = qMax(250, group.intervalMs);   // Kite quote limits make faster pointless
+    if (!slot.timer) {
+        slot.timer = new QTimer(this);
+        const QString name = group.name;
+        connect(slot.timer, &QTimer::timeout, this, [this, name]() { poll(name); });
+    }
+    if (m_running) startSlot(slot);
+}
+
+void QuotePoller::removeGroup(const QString& name)
+{
+    auto it = m_groups.find(name);
+    if (it == m_groups.end()) return;
+    if (it->timer) it->timer->deleteLater();
+    m_groups.erase(it);
+}
+
+void QuotePoller::loadFromConfig(const QJsonObject& config)
+{
+    const QStringList old = m_groups.keys();
+    for (const QString& name : old) removeGroup(name);
+
+    const QJsonArray groups = config.value("groups").toArray();
+    for (const QJsonValue& v : groups) {
+        const QJsonObject o = v.toObject();
+        Group g;
+        g.name = o.value("name").toString();
+        g.mode = modeFromString(o.value("mode").toString());
+        g.intervalMs = o.value("interval_ms").toInt(1000);
+        for (const QJsonValue& inst : o.value("instruments").toArray()) {
+            // Tokens may be written as numbers or strings
+            g.instruments << (inst.isDouble() ? QString::number(qint64(inst.toDouble())) : inst.toString());
+        }
+        if (g.name.isEmpty() || g.instruments.isEmpty()) {
+            qWarning() << "QuotePoller: skipping quote_polling group without name or instruments.";
+            continue;
+        }
+        setGroup(g);
+    }
+}
+
+void QuotePoller::start()
+{
+    m_running = true;
+    for (auto it = m_groups.begin(); it != m_groups.end(); ++it) startSlot(it.value());
+}
+
+void QuotePoller::stop()
+{
+    m_running = false;
+    for (auto it = m_groups.begin(); it != m_groups.end(); ++it)
+        if (it->timer) it->timer->stop();
+}
+
+void QuotePoller::startSlot(Slot& slot)
+{
+    slot.timer->start(slot.group.intervalMs);
+    poll(slot.group.name);
+}
+
+void QuotePoller::poll(const QString& name)
+{
+    auto it = m_groups.find(name);
+    if (it == m_groups.end() || !m_api) return;
+    if (it->inFlight || it->group.instruments.isEmpty()) return;   // previous poll still running
+
+    it->inFlight = true;
+    m_api->fetchQuotesAsync(it->group.mode, it->group.instruments, name)
+        .then(this, [this, name](const ApiResult<QVector<QuoteData>>& r) {
+            auto slot = m_groups.find(name);
+            if (slot != m_groups.end()) slot->inFlight = false;
+            if (!r.value.isEmpty()) emit quotesUpdated(name, r.value);
+            if (!r.ok) emit pollFailed(name, r.error);
+        });
+}
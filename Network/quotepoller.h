@@ -0,0 +1,90 @@
+#ifndef QUOTEPOLLER_H
+#define QUOTEPOLLER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QJsonObject>
+
+#include "Data/DataStructures/quotedata.h"
+
+class KiteConnectAPI;
+class QTimer;
+
+/**
+ * @brief Refreshes quote snapshots for named instrument groups at fixed cadences.
+ *
+ * Each group has its own mode (LTP/OHLC/full), instrument list and interval, and is fetched
+ * through KiteConnectAPI::fetchQuotesAsync (batched, so a group costs one call per 500/1000
+ * instruments regardless of size). A group is skipped for a tick while its previous poll is
+ * still in flight, so a slow API never piles requests up.
+ *
+ * Config ("quote_polling" in config.json):
+ * @code
+ * { "groups": [ { "name": "indices", "mode": "ltp", "interval_ms": 1000,
+ *                 "instruments": ["256265", "260105"] } ] }
+ * @endcode
+ */
+class QuotePoller : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief One polled set of instruments.
+     */
+    struct Group {
+        QString name;
+        QuoteData::Mode mode = QuoteData::Ltp;
+        QStringList instruments;    ///< Tokens or "EXCHANGE:TRADINGSYMBOL".
+        int intervalMs = 1000;
+    };
+
+    explicit QuotePoller(KiteConnectAPI* api, QObject* parent = nullptr);
+
+    /** @brief Adds a group or replaces the one with the same name (its timer restarts if running). */
+    void setGroup(const Group& group);
+    void removeGroup(const QString& name);
+    QStringList groupNames() const { return m_groups.keys(); }
+
+    /** @brief Replaces all groups with those in a "quote_polling" config object. */
+    void loadFromConfig(const QJsonObject& config);
+
+    /** @brief Starts every group's timer and polls each once immediately. */
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    /** @brief Parses "ltp", "ohlc" or "full"/"quote" (anything else -> Ltp). */
+    static QuoteData::Mode modeFromString(const QString& mode);
+
+signals:
+    /**
+     * @brief Emitted after each successful (or partially successful) poll of a group.
+     * @param group Group name.
+     * @param quotes Everything parsed in this poll.
+     */
+    void quotesUpdated(const QString& group, const QVector<QuoteData>& quotes);
+
+    /**
+     * @brief Emitted when a poll fails (in whole or in part).
+     */
+    void pollFailed(const QString& group, const QString& error);
+
+private:
+    struct Slot {
+        Group group;
+        QTimer* timer = nullptr;
+        bool inFlight = false;
+    };
+
+    void poll(const QString& name);
+    void startSlot(Slot& slot);
+
+    KiteConnectAPI* m_api;
+    QMap<QString, Slot> m_groups;   // name -> group state
+    bool m_running = false;
+};
+
+#endif // QUOTEPOLLER_H
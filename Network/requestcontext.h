@@ -0,0 +1,90 @@
+#ifndef REQUESTCONTEXT_H
+#define REQUESTCONTEXT_H
+
+#include <QString>
+#include <QMetaType>
+#include <functional>
+
+class QNetworkReply;
+
+/**
+ * @brief Defines the types of API requests managed by KiteConnectAPI.
+ */
+enum class RequestType {
+    InvalidRequest = 0,         ///< Default or error type
+    InstrumentsRequest = 1,     ///< Fetching instrument list (CSV)
+    HistoricalDataRequest = 2,  ///< Fetching historical candles (JSON)
+    SessionRequest = 3,         ///< Generating session/access token (JSON)
+    ProfileRequest = 4,         ///< Fetching user profile (JSON)
+    MarginsRequest = 5,         ///< Fetching user margins (JSON)
+    OrderRequest = 6,           ///< Placeholder for Order related requests
+    QuoteRequest = 7,           ///< Placeholder for Quote requests
+    HoldingsRequest = 8,        ///< Placeholder for Holdings requests
+    PositionsRequest = 9        ///< Placeholder for Positions requests
+};
+// Make RequestType usable with QVariant for storing in QObject properties
+Q_DECLARE_METATYPE(RequestType)
+
+/**
+ * @brief Scheduling priority of a request; lower values go first.
+ */
+enum class RequestPriority : quint8 {
+    Critical = 0,   ///< Order placement/modification
+    High = 1,       ///< Quotes
+    Normal = 2,     ///< Session, profile, margins, instruments
+    Low = 3         ///< Historical backfill
+};
+
+/**
+ * @brief Priority a request of this type gets when the caller does not choose one.
+ */
+inline RequestPriority defaultPriorityFor(RequestType type)
+{
+    switch (type) {
+    case RequestType::OrderRequest:          return RequestPriority::Critical;
+    case RequestType::QuoteRequest:          return RequestPriority::High;
+    case RequestType::HistoricalDataRequest: return RequestPriority::Low;
+    default:                                 return RequestPriority::Normal;
+    }
+}
+
+/**
+ * @brief Typed context carried by every request from creation to its reply.
+ *
+ * The caller fills in what it knows (type, instrument, interval, chunk range, priority);
+ * HttpManager assigns the request ID and send timestamp, keeps the context with the in-flight
+ * reply and hands it back in requestFinished(), so no reply ever has to be parsed to find out
+ * what it was for.
+ */
+struct RequestContext
+{
+    quint64 requestId = 0;                      ///< Unique per HttpManager; assigned on send.
+    RequestType type = RequestType::InvalidRequest;
+    RequestPriority priority = RequestPriority::Normal;
+    QString caller;                             ///< Fair-queuing key among equal-priority requests.
+
+    QString instrumentToken;                    ///< Historical/quote requests.
+    QString interval;                           ///< Historical requests ("day", "5minute", ...).
+    QString rangeFrom;                          ///< Chunk range as sent ("yyyy-MM-dd+HH:mm:ss").
+    QString rangeTo;
+    int chunkIndex = 0;                         ///< Position of this chunk in a multi-chunk fetch.
+    int chunkCount = 1;
+
+    int attempt = 1;                            ///< Send attempt that produced the reply (retries count up).
+
+    qint64 enqueuedNs = 0;                      ///< When the caller created the request (steady clock).
+    qint64 sentNs = 0;                          ///< When HttpManager handed it to the network.
+    quint64 traceFlow = 0;                      ///< Tracer flow id (0 when tracing is off).
+
+    /**
+     * @brief Reply handler installed by KiteConnectAPI::sendAsync. Runs on the network thread,
+     * so it may only decode and post results back; it also receives failed and cancelled replies
+     * (check reply->error()) and must not delete the reply; the dispatcher does that after it returns.
+     */
+    std::function<void(QNetworkReply*, const RequestContext&)> continuation;
+
+    /** @brief "TOKEN_INTERVAL", the context string used by the failure signals. */
+    QString label() const { return instrumentToken + "_" + interval; }
+};
+
+#endif // REQUESTCONTEXT_H
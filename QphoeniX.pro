@@ -10,13 +10,28 @@ CONFIG += c++17
 
 DEFINES += DEVELOPMENT
 
+# Let the compiler vectorize the '#pragma omp simd' loops (Data/correlationengine.cpp) without the OpenMP runtime.
+msvc: QMAKE_CXXFLAGS += -openmp:experimental
+else: QMAKE_CXXFLAGS += -fopenmp-simd
+
 SOURCES += \
     Data/accountdata.cpp \
+    Data/correlationengine.cpp \
     Data/datamanager.cpp \
+    Data/intradayseasonality.cpp \
     Data/marketdatacache.cpp \
+    Data/optionchainanalytics.cpp \
+    Data/optiongreeksengine.cpp \
+    Data/priceladder.cpp \
+    Data/volatilitysurface.cpp \
+    Data/volumeprofile.cpp \
+    Data/vwapengine.cpp \
+    Network/bufferedreply.cpp \
     Network/httpmanager.cpp \
     Network/kiteconnectapi.cpp \
+    Network/kiterequestbuilder.cpp \
     Network/kitewebsocket.cpp \
+    Network/quotepoller.cpp \
     OrderManagement/ordermanager.cpp \
     RiskManagement/riskmanager.cpp \
     Strategies/daytradingstrategy1.cpp \
@@ -31,17 +46,30 @@ SOURCES += \
     UI/orderlogwidget.cpp \
     UI/strategyconfigwidget.cpp \
     UI/watchlistwidget.cpp \
+    Utils/black76.cpp \
     Utils/configurationmanager.cpp \
+    Utils/latencymonitor.cpp \
     Utils/logger.cpp \
     Utils/marketcalendar.cpp \
+    Utils/realizedvol.cpp \
+    Utils/signalexpression.cpp \
     Utils/ta_simple.cpp \
+    Utils/tracer.cpp \
     main.cpp
 
 HEADERS += \
     Data/DataStructures/instrumentanalytics.h \
     Data/accountdata.h \
+    Data/correlationengine.h \
     Data/datamanager.h \
+    Data/intradayseasonality.h \
     Data/marketdatacache.h \
+    Data/optionchainanalytics.h \
+    Data/optiongreeksengine.h \
+    Data/priceladder.h \
+    Data/volatilitysurface.h \
+    Data/volumeprofile.h \
+    Data/vwapengine.h \
     Data/DataStructures/candle.h \
     Data/DataStructures/historicaldata.h \
     Data/DataStructures/holding.h \
@@ -49,9 +77,13 @@ HEADERS += \
     Data/DataStructures/margins.h \
     Data/DataStructures/position.h \
     Data/DataStructures/quotedata.h \
+    Network/bufferedreply.h \
     Network/httpmanager.h \
     Network/kiteconnectapi.h \
+    Network/kiterequestbuilder.h \
     Network/kitewebsocket.h \
+    Network/quotepoller.h \
+    Network/requestcontext.h \
     OrderManagement/ordermanager.h \
     RiskManagement/riskmanager.h \
     Strategies/daytradingstrategy1.h \
@@ -67,10 +99,15 @@ HEADERS += \
     UI/orderlogwidget.h \
     UI/strategyconfigwidget.h \
     UI/watchlistwidget.h \
+    Utils/black76.h \
     Utils/configurationmanager.h \
+    Utils/latencymonitor.h \
     Utils/logger.h \
     Utils/marketcalendar.h \
-    Utils/ta_simple.h
+    Utils/realizedvol.h \
+    Utils/signalexpression.h \
+    Utils/ta_simple.h \
+    Utils/tracer.h
 
 RESOURCES += \
     resources.qrc
@@ -0,0 +1,26 @@
+QT = core network
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = kitestub
+
+# Sources include each other by repository-relative path ("Tools/KiteStub/...")
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    recordstore.cpp \
+    stubprofile.cpp \
+    stubserver.cpp \
+    syntheticdata.cpp
+
+HEADERS += \
+    recordstore.h \
+    stubprofile.h \
+    stubserver.h \
+    syntheticdata.h
+
+DISTFILES += \
+    profiles/default.json \
+    profiles/faulty.json
@@ -0,0 +1,66 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include "Tools/KiteStub/stubserver.h"
+
+// KiteStub: a local Kite Connect API for benchmarks and load tests. Point QphoeniX at it with
+// QPX_API_BASE_URL=http://127.0.0.1:8765 (or "http": { "base_url": ... } in config.json).
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("kitestub");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Deterministic local stand-in for the Kite Connect REST API.");
+    parser.addHelpOption();
+    const QCommandLineOption portOption({ "p", "port" }, "Port to listen on (default 8765).", "port", "8765");
+    const QCommandLineOption listenOption("listen", "Address to bind (default 127.0.0.1).", "address", "127.0.0.1");
+    const QCommandLineOption profileOption("profile", "JSON profile: latency, rate limits, faults, seed.", "file");
+    const QCommandLineOption seedOption("seed", "Overrides the profile seed.", "n");
+    const QCommandLineOption recordingsOption({ "r", "recordings" }, "Directory of recorded responses to replay.", "dir");
+    const QCommandLineOption recordOption("record", "Record mode: forward to this API root (e.g. https://api.kite.trade) "
+                                                    "and save responses into --recordings.", "url");
+    const QCommandLineOption replayOnlyOption("replay-only", "Answer 404 instead of synthetic data when nothing is recorded.");
+    const QCommandLineOption noAuthOption("no-auth", "Accept API calls without an Authorization header.");
+    const QCommandLineOption verboseOption({ "v", "verbose" }, "Log every request.");
+    parser.addOptions({ portOption, listenOption, profileOption, seedOption, recordingsOption, recordOption,
+                        replayOnlyOption, noAuthOption, verboseOption });
+    parser.process(app);
+
+    StubServer::Options options;
+    options.address = QHostAddress(parser.value(listenOption));
+    options.port = quint16(parser.value(portOption).toUInt());
+    if (parser.isSet(profileOption)) {
+        QString error;
+        if (!options.profile.load(parser.value(profileOption), &error)) {
+            qCritical().noquote() << error;
+            return 1;
+        }
+    }
+    if (parser.isSet(seedOption)) options.profile.seed = parser.value(seedOption).toULongLong();
+    options.recordingsDir = parser.value(recordingsOption);
+    options.replayOnly = parser.isSet(replayOnlyOption);
+    options.requireAuth = !parser.isSet(noAuthOption);
+    options.verbose = parser.isSet(verboseOption);
+    if (parser.isSet(recordOption)) {
+        if (options.recordingsDir.isEmpty()) {
+            qCritical() << "--record needs --recordings <dir> to save into.";
+            return 1;
+        }
+        options.upstream = QUrl(parser.value(recordOption));
+    }
+
+    StubServer server(options);
+    QString error;
+    if (!server.start(&error)) {
+        qCritical().noquote() << "KiteStub: cannot listen:" << error;
+        return 1;
+    }
+    const QString base = server.baseUrl().toString();
+    qInfo().noquote() << "KiteStub listening on" << base
+                      << (options.upstream.isEmpty() ? QString("(seed %1)").arg(options.profile.seed)
+                                                     : "(recording from " + options.upstream.toString() + ")");
+    qInfo().noquote() << "Point QphoeniX at it with QPX_API_BASE_URL=" + base;
+    return app.exec();
+}
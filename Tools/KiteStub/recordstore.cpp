@@ -0,0 +1,113 @@
+#include "Tools/KiteStub/recordstore.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <algorithm>
+
+RecordStore::RecordStore(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+QByteArray RecordStore::keyFor(const QByteArray& method, const QByteArray& target)
+{
+    const int q = target.indexOf('?');
+    if (q < 0) return method + ' ' + target;
+    QList<QByteArray> params = target.mid(q + 1).split('&');
+    std::sort(params.begin(), params.end());
+    return method + ' ' + target.left(q) + '?' + params.join('&');
+}
+
+QByteArray RecordStore::pathKeyFor(const QByteArray& method, const QByteArray& target)
+{
+    const int q = target.indexOf('?');
+    return method + ' ' + (q < 0 ? target : target.left(q));
+}
+
+int RecordStore::load()
+{
+    m_exact.clear();
+    m_byPath.clear();
+    if (!isEnabled()) return 0;
+    QDir dir(m_directory);
+    if (!dir.exists()) return 0;
+
+    // Oldest first, so the newest recording of a path wins the fallback slot
+    const QFileInfoList entries = dir.entryInfoList({ "*.json" }, QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QFileInfo& info : entries) {
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        const QJsonObject meta = QJsonDocument::fromJson(file.readAll()).object();
+        const QByteArray method = meta.value("method").toString().toLatin1();
+        const QByteArray target = meta.value("target").toString().toUtf8();
+        if (method.isEmpty() || target.isEmpty()) {
+            qWarning() << "RecordStore: skipping malformed recording" << info.fileName();
+            continue;
+        }
+        m_exact.insert(keyFor(method, target), info.completeBaseName());
+        m_byPath.insert(pathKeyFor(method, target), info.completeBaseName());
+    }
+    return m_exact.size();
+}
+
+bool RecordStore::readEntry(const QString& baseName, StoredResponse* out) const
+{
+    QFile metaFile(QDir(m_directory).filePath(baseName + ".json"));
+    QFile bodyFile(QDir(m_directory).filePath(baseName + ".body"));
+    if (!metaFile.open(QIODevice::ReadOnly) || !bodyFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "RecordStore: cannot read recording" << baseName;
+        return false;
+    }
+    const QJsonObject meta = QJsonDocument::fromJson(metaFile.readAll()).object();
+    out->status = meta.value("status").toInt(200);
+    out->contentType = meta.value("content_type").toString("application/json").toLatin1();
+    out->body = bodyFile.readAll();
+    return true;
+}
+
+bool RecordStore::lookup(const QByteArray& method, const QByteArray& target, StoredResponse* out) const
+{
+    if (!isEnabled()) return false;
+    auto exact = m_exact.constFind(keyFor(method, target));
+    if (exact != m_exact.constEnd()) return readEntry(*exact, out);
+    auto byPath = m_byPath.constFind(pathKeyFor(method, target));
+    if (byPath != m_byPath.constEnd()) return readEntry(*byPath, out);
+    return false;
+}
+
+bool RecordStore::save(const QByteArray& method, const QByteArray& target, const StoredResponse& response)
+{
+    if (!isEnabled()) return false;
+    QDir dir(m_directory);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qWarning() << "RecordStore: cannot create" << m_directory;
+        return false;
+    }
+    const QByteArray key = keyFor(method, target);
+    const QString baseName = QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(20));
+
+    QFile bodyFile(dir.filePath(baseName + ".body"));
+    QFile metaFile(dir.filePath(baseName + ".json"));
+    if (!bodyFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        !metaFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "RecordStore: cannot write recording" << baseName;
+        return false;
+    }
+    bodyFile.write(response.body);
+    const QJsonObject meta{
+        { "method", QString::fromLatin1(method) },
+        { "target", QString::fromUtf8(target) },
+        { "status", response.status },
+        { "content_type", QString::fromLatin1(response.contentType) },
+    };
+    metaFile.write(QJsonDocument(meta).toJson(QJsonDocument::Indented));
+
+    m_exact.insert(key, baseName);
+    m_byPath.insert(pathKeyFor(method, target), baseName);
+    return true;
+}
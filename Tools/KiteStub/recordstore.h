@@ -0,0 +1,56 @@
+#ifndef RECORDSTORE_H
+#define RECORDSTORE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+
+/**
+ * @brief One recorded HTTP response.
+ */
+struct StoredResponse
+{
+    int status = 200;
+    QByteArray contentType;
+    QByteArray body;
+};
+
+/**
+ * @brief Directory of recorded Kite responses, one pair of files per request:
+ * "<hash>.json" ({"method", "target", "status", "content_type"}) and "<hash>.body".
+ *
+ * Requests match on method, path and query (parameters sorted, so i=A&i=B and i=B&i=A are the
+ * same recording). A request with no exact recording falls back to the last one saved for the
+ * same method and path, so a capture of /instruments/historical/{token}/day with last week's
+ * from/to still serves the candles when the app asks for today's range.
+ */
+class RecordStore
+{
+public:
+    explicit RecordStore(const QString& directory = QString());
+
+    bool isEnabled() const { return !m_directory.isEmpty(); }
+    int size() const { return m_exact.size(); }
+
+    /** @brief Indexes every recording in the directory; returns how many were found. */
+    int load();
+
+    /** @brief Exact match first, then the same method and path; false if neither exists. */
+    bool lookup(const QByteArray& method, const QByteArray& target, StoredResponse* out) const;
+
+    /** @brief Writes a recording (replacing one with the same key) and indexes it. */
+    bool save(const QByteArray& method, const QByteArray& target, const StoredResponse& response);
+
+    /** @brief "METHOD path?sorted&query", the exact-match key. */
+    static QByteArray keyFor(const QByteArray& method, const QByteArray& target);
+
+private:
+    static QByteArray pathKeyFor(const QByteArray& method, const QByteArray& target);
+    bool readEntry(const QString& baseName, StoredResponse* out) const;
+
+    QString m_directory;
+    QHash<QByteArray, QString> m_exact;     // key -> file base name
+    QHash<QByteArray, QString> m_byPath;    // "METHOD path" -> most recently saved base name
+};
+
+#endif // RECORDSTORE_H
@@ -0,0 +1,140 @@
+#include "Tools/KiteStub/stubprofile.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <cmath>
+
+static const double kPi = 3.14159265358979323846;
+
+int LatencyModel::sample(QRandomGenerator& rng) const
+{
+    double ms = a;
+    switch (kind) {
+    case Fixed:
+        break;
+    case Uniform:
+        ms = a + (b - a) * rng.generateDouble();
+        break;
+    case Normal:
+    case LogNormal: {
+        // Box-Muller; 1 - u keeps log() away from 0
+        const double u1 = 1.0 - rng.generateDouble();
+        const double u2 = rng.generateDouble();
+        const double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * kPi * u2);
+        if (kind == Normal) {
+            ms = a + b * z;
+        } else {
+            // median = e^mu, p99 = e^(mu + 2.326 sigma)
+            const double mu = std::log(qMax(0.001, a));
+            const double sigma = qMax(0.0, (std::log(qMax(a, b)) - mu) / 2.326);
+            ms = std::exp(mu + sigma * z);
+        }
+        break;
+    }
+    }
+    return int(qBound(0.0, ms, 600000.0));
+}
+
+LatencyModel LatencyModel::fromJson(const QJsonObject& o, const LatencyModel& fallback)
+{
+    if (o.isEmpty()) return fallback;
+    LatencyModel m = fallback;
+    const QString dist = o.value("dist").toString().toLower();
+    if (dist == "fixed") {
+        m.kind = Fixed;
+        m.a = o.value("ms").toDouble(m.a);
+    } else if (dist == "uniform") {
+        m.kind = Uniform;
+        m.a = o.value("min_ms").toDouble(m.a);
+        m.b = qMax(m.a, o.value("max_ms").toDouble(m.b));
+    } else if (dist == "normal") {
+        m.kind = Normal;
+        m.a = o.value("mean_ms").toDouble(m.a);
+        m.b = o.value("stddev_ms").toDouble(m.b);
+    } else {
+        m.kind = LogNormal;
+        m.a = o.value("median_ms").toDouble(m.a);
+        m.b = qMax(m.a, o.value("p99_ms").toDouble(m.b));
+    }
+    return m;
+}
+
+FaultModel::Fault FaultModel::roll(QRandomGenerator& rng) const
+{
+    double r = rng.generateDouble();
+    if ((r -= http500) < 0) return Http500;
+    if ((r -= http503) < 0) return Http503;
+    if ((r -= reset) < 0) return Reset;
+    if ((r -= stall) < 0) return Stall;
+    if ((r -= malformed) < 0) return Malformed;
+    return None;
+}
+
+StubProfile StubProfile::defaults()
+{
+    StubProfile p;
+    ClassProfile& orders = p.classes[int(StubClass::Orders)];
+    orders.rate = 10.0;
+    orders.latency = { LatencyModel::LogNormal, 25.0, 120.0 };
+    ClassProfile& quotes = p.classes[int(StubClass::Quotes)];
+    quotes.rate = 1.0;
+    quotes.latency = { LatencyModel::LogNormal, 30.0, 150.0 };
+    ClassProfile& account = p.classes[int(StubClass::Account)];
+    account.rate = 10.0;
+    account.latency = { LatencyModel::LogNormal, 40.0, 200.0 };
+    ClassProfile& historical = p.classes[int(StubClass::Historical)];
+    historical.rate = 3.0;
+    historical.latency = { LatencyModel::LogNormal, 80.0, 400.0 };
+    return p;
+}
+
+bool StubProfile::load(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Cannot open profile " + path + ": " + file.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = "Invalid profile " + path + ": " + parseError.errorString();
+        return false;
+    }
+    const QJsonObject root = doc.object();
+    if (root.contains("seed")) seed = quint64(root.value("seed").toDouble());
+
+    const QJsonObject classObjects = root.value("classes").toObject();
+    for (int c = 0; c < int(StubClass::Count); ++c) {
+        const QJsonObject o = classObjects.value(className(StubClass(c))).toObject();
+        if (o.isEmpty()) continue;
+        ClassProfile& cp = classes[c];
+        cp.latency = LatencyModel::fromJson(o.value("latency").toObject(), cp.latency);
+        cp.rate = qMax(0.0, o.value("rate").toDouble(cp.rate));
+        cp.burst = qMax(1.0, o.value("burst").toDouble(cp.burst));
+        cp.retryAfterS = qMax(0, o.value("retry_after_s").toInt(cp.retryAfterS));
+
+        const QJsonObject f = o.value("faults").toObject();
+        cp.faults.http500 = qBound(0.0, f.value("http_500").toDouble(cp.faults.http500), 1.0);
+        cp.faults.http503 = qBound(0.0, f.value("http_503").toDouble(cp.faults.http503), 1.0);
+        cp.faults.reset = qBound(0.0, f.value("reset").toDouble(cp.faults.reset), 1.0);
+        cp.faults.stall = qBound(0.0, f.value("stall").toDouble(cp.faults.stall), 1.0);
+        cp.faults.malformed = qBound(0.0, f.value("malformed").toDouble(cp.faults.malformed), 1.0);
+    }
+    return true;
+}
+
+StubClass StubProfile::classOf(const QString& path)
+{
+    if (path.startsWith("/orders")) return StubClass::Orders;
+    if (path.startsWith("/quote")) return StubClass::Quotes;
+    if (path.startsWith("/instruments/historical/")) return StubClass::Historical;
+    return StubClass::Account;
+}
+
+QString StubProfile::className(StubClass cls)
+{
+    static const char* const names[] = { "orders", "quotes", "account", "historical" };
+    return QString::fromLatin1(names[qBound(0, int(cls), int(StubClass::Count) - 1)]);
+}
@@ -0,0 +1,95 @@
+#ifndef STUBPROFILE_H
+#define STUBPROFILE_H
+
+#include <QString>
+#include <QJsonObject>
+
+class QRandomGenerator;
+
+/**
+ * @brief Endpoint classes of the stand-in server; the same split HttpManager rate-limits by.
+ */
+enum class StubClass : quint8 {
+    Orders = 0,     ///< /orders
+    Quotes,         ///< /quote, /quote/ohlc, /quote/ltp
+    Account,        ///< Session, user, portfolio, instruments, everything else
+    Historical,     ///< /instruments/historical
+    Count
+};
+
+/**
+ * @brief Response delay distribution of one endpoint class.
+ */
+struct LatencyModel
+{
+    enum Kind { Fixed, Uniform, Normal, LogNormal };
+    Kind kind = LogNormal;
+    double a = 30.0;    ///< Fixed: delay; Uniform: min; Normal: mean; LogNormal: median (ms).
+    double b = 150.0;   ///< Uniform: max; Normal: standard deviation; LogNormal: p99 (ms).
+
+    /** @brief One delay in ms (never negative). */
+    int sample(QRandomGenerator& rng) const;
+
+    /**
+     * @brief Reads {"dist": "lognormal", "median_ms": 40, "p99_ms": 250} and friends
+     * ("fixed": ms; "uniform": min_ms/max_ms; "normal": mean_ms/stddev_ms).
+     */
+    static LatencyModel fromJson(const QJsonObject& o, const LatencyModel& fallback);
+};
+
+/**
+ * @brief Probabilities (0..1, per request) of each injected failure.
+ */
+struct FaultModel
+{
+    double http500 = 0.0;       ///< 500 with a Kite GeneralException body.
+    double http503 = 0.0;       ///< 503 with a Kite NetworkException body.
+    double reset = 0.0;         ///< Connection closed without a response.
+    double stall = 0.0;         ///< Request never answered (exercises client timeouts).
+    double malformed = 0.0;     ///< 200 with a truncated, unparsable body.
+
+    enum Fault { None, Http500, Http503, Reset, Stall, Malformed };
+    /** @brief Rolls the dice once. */
+    Fault roll(QRandomGenerator& rng) const;
+};
+
+/**
+ * @brief Latency, rate limit and fault settings of one endpoint class.
+ */
+struct ClassProfile
+{
+    LatencyModel latency;
+    double rate = 10.0;         ///< Requests per second before 429s (0 = unlimited).
+    double burst = 1.0;
+    int retryAfterS = 0;        ///< Retry-After sent with 429s (0 = header omitted).
+    FaultModel faults;
+};
+
+/**
+ * @brief Everything that shapes how the stand-in server answers, loaded from a JSON profile:
+ * @code
+ * { "seed": 42,
+ *   "classes": { "historical": { "latency": { "dist": "lognormal", "median_ms": 80, "p99_ms": 400 },
+ *                                "rate": 3, "burst": 1, "retry_after_s": 1,
+ *                                "faults": { "http_500": 0.01, "http_503": 0, "reset": 0,
+ *                                            "stall": 0, "malformed": 0 } } } }
+ * @endcode
+ * Classes are "orders", "quotes", "account" and "historical"; missing keys keep the defaults
+ * (Kite's documented limits, no faults).
+ */
+struct StubProfile
+{
+    quint64 seed = 1;
+    ClassProfile classes[int(StubClass::Count)];
+
+    /** @brief Kite's limits (orders 10/s, quotes 1/s, account 10/s, historical 3/s), no faults. */
+    static StubProfile defaults();
+    /** @brief Applies a profile file on top of the current values. */
+    bool load(const QString& path, QString* error);
+
+    /** @brief Class of a request path ("/quote/ltp", "/orders/regular", ...). */
+    static StubClass classOf(const QString& path);
+    static QString className(StubClass cls);
+};
+
+#endif // STUBPROFILE_H
@@ -0,0 +1,399 @@
+#include "Tools/KiteStub/stubserver.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QPointer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+static const int kMaxHeaderBytes = 64 * 1024;
+static const qint64 kNanosPerSecond = 1000000000LL;
+
+static QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 302: return "Found";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default:  return "Status";
+    }
+}
+
+StubServer::StubServer(const Options& options, QObject* parent)
+    : QObject(parent),
+      m_options(options),
+      m_server(new QTcpServer(this)),
+      m_store(options.recordingsDir),
+      m_data(options.profile.seed),
+      m_rng(quint32(options.profile.seed ^ (options.profile.seed >> 32)))
+{
+    m_clock.start();
+    for (int c = 0; c < int(StubClass::Count); ++c)
+        m_buckets[c].tokens = m_options.profile.classes[c].burst;
+    if (m_options.upstream.isValid() && !m_options.upstream.isEmpty())
+        m_upstream = new QNetworkAccessManager(this);
+    connect(m_server, &QTcpServer::newConnection, this, &StubServer::onNewConnection);
+
+    m_statsTimer = new QTimer(this);
+    connect(m_statsTimer, &QTimer::timeout, this, &StubServer::reportStats);
+}
+
+bool StubServer::start(QString* error)
+{
+    if (m_store.isEnabled()) {
+        const int n = m_store.load();
+        qInfo().noquote() << QString("KiteStub: %1 recording(s) in %2").arg(n).arg(m_options.recordingsDir);
+    }
+    if (!m_server->listen(m_options.address, m_options.port)) {
+        if (error) *error = m_server->errorString();
+        return false;
+    }
+    m_statsTimer->start(10000);
+    return true;
+}
+
+QUrl StubServer::baseUrl() const
+{
+    QUrl url;
+    url.setScheme("http");
+    url.setHost(m_server->serverAddress().toString());
+    url.setPort(m_server->serverPort());
+    return url;
+}
+
+// ---------- connections ----------
+
+void StubServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_connections.insert(socket, Connection());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_connections.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void StubServer::readRequests(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) return;
+    it->buffer += socket->readAll();
+    if (it->busy) return;   // answered in order once the current response is out
+
+    Request request;
+    switch (parseRequest(it->buffer, &request)) {
+    case Parse::Incomplete:
+        return;
+    case Parse::Bad:
+        it->buffer.clear();
+        request.keepAlive = false;
+        send(socket, request, kiteError(400, "InputException", "Malformed HTTP request"));
+        return;
+    case Parse::Ready:
+        it->busy = true;
+        handle(socket, request);
+        return;
+    }
+}
+
+StubServer::Parse StubServer::parseRequest(QByteArray& buffer, Request* out) const
+{
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return buffer.size() > kMaxHeaderBytes ? Parse::Bad : Parse::Incomplete;
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(1).startsWith('/')) return Parse::Bad;
+
+    QHash<QByteArray, QByteArray> headers;
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines.at(i).indexOf(':');
+        if (colon <= 0) continue;
+        headers.insert(lines.at(i).left(colon).trimmed().toLower(), lines.at(i).mid(colon + 1).trimmed());
+    }
+    bool lengthOk = true;
+    const qint64 length = headers.value("content-length", "0").toLongLong(&lengthOk);
+    if (!lengthOk || length < 0) return Parse::Bad;
+    if (buffer.size() < headerEnd + 4 + length) return Parse::Incomplete;
+
+    out->method = requestLine.at(0).toUpper();
+    out->target = requestLine.at(1);
+    const QUrl url = QUrl::fromEncoded("http://stub" + out->target);
+    out->path = url.path();
+    out->query = QUrlQuery(url);
+    out->headers = headers;
+    out->body = buffer.mid(headerEnd + 4, int(length));
+    const QByteArray connection = headers.value("connection").toLower();
+    out->keepAlive = requestLine.at(2) == "HTTP/1.0" ? connection == "keep-alive" : connection != "close";
+    out->receivedNs = m_clock.nsecsElapsed();
+    buffer.remove(0, headerEnd + 4 + int(length));
+    return Parse::Ready;
+}
+
+// ---------- request handling ----------
+
+bool StubServer::takeToken(StubClass cls)
+{
+    const ClassProfile& cp = m_options.profile.classes[int(cls)];
+    if (cp.rate <= 0.0) return true;
+    Bucket& b = m_buckets[int(cls)];
+    const qint64 now = m_clock.nsecsElapsed();
+    b.tokens = qMin(cp.burst, b.tokens + cp.rate * double(now - b.lastNs) / kNanosPerSecond);
+    b.lastNs = now;
+    if (b.tokens < 1.0) return false;
+    b.tokens -= 1.0;
+    return true;
+}
+
+void StubServer::handle(QTcpSocket* socket, const Request& request)
+{
+    // Keep-alive pings and the login redirect are not API calls: no limits, delays or faults
+    if (request.path == "/" || request.path.startsWith("/connect/")) {
+        send(socket, request, route(request));
+        return;
+    }
+    if (m_upstream) {
+        forward(socket, request);
+        return;
+    }
+
+    const StubClass cls = StubProfile::classOf(request.path);
+    const ClassProfile& cp = m_options.profile.classes[int(cls)];
+    ClassStats& stats = m_stats[int(cls)];
+    ++stats.requests;
+    const int delayMs = cp.latency.sample(m_rng);
+
+    Response response;
+    if (!takeToken(cls)) {
+        ++stats.limited;
+        response = kiteError(429, "NetworkException", "Too many requests");
+        if (cp.retryAfterS > 0) response.headers.append({ "Retry-After", QByteArray::number(cp.retryAfterS) });
+    } else {
+        const FaultModel::Fault fault = cp.faults.roll(m_rng);
+        if (fault != FaultModel::None) ++stats.faults;
+        switch (fault) {
+        case FaultModel::Reset:
+            QTimer::singleShot(delayMs, socket, [socket]() { socket->abort(); });
+            return;
+        case FaultModel::Stall:
+            return;     // the connection stays busy until the client gives up on it
+        case FaultModel::Http500:
+            response = kiteError(500, "GeneralException", "Injected server error");
+            break;
+        case FaultModel::Http503:
+            response = kiteError(503, "NetworkException", "Injected service unavailable");
+            break;
+        case FaultModel::Malformed:
+            response = route(request);
+            response.body.truncate(response.body.size() / 2);
+            break;
+        case FaultModel::None:
+            response = route(request);
+            break;
+        }
+    }
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delayMs, socket, [this, guard, request, response]() {
+        if (guard) send(guard, request, response);
+    });
+}
+
+StubServer::Response StubServer::kiteSuccess(const QJsonValue& data)
+{
+    Response r;
+    r.body = QJsonDocument(QJsonObject{ { "status", "success" }, { "data", data } }).toJson(QJsonDocument::Compact);
+    return r;
+}
+
+StubServer::Response StubServer::kiteError(int status, const QString& errorType, const QString& message)
+{
+    Response r;
+    r.status = status;
+    r.body = QJsonDocument(QJsonObject{ { "status", "error" }, { "message", message },
+                                        { "data", QJsonValue::Null }, { "error_type", errorType } })
+                 .toJson(QJsonDocument::Compact);
+    return r;
+}
+
+StubServer::Response StubServer::route(const Request& request)
+{
+    const QByteArray& method = request.method;
+    const QString& path = request.path;
+
+    if (path == "/") {
+        Response r;
+        r.contentType = "text/plain";
+        r.body = "KiteStub\n";
+        return r;
+    }
+    if (path == "/connect/login") {
+        // Straight back with a request_token: LoginDialog finishes as soon as it sees one
+        Response r;
+        r.status = 302;
+        r.contentType = "text/plain";
+        r.headers.append({ "Location", baseUrl().toEncoded() +
+                                       "/connect/finish?action=login&status=success&request_token=stub" +
+                                       QByteArray::number(m_rng.bounded(1000000)) });
+        return r;
+    }
+    if (path == "/connect/finish") {
+        Response r;
+        r.contentType = "text/html";
+        r.body = "<html><body>Logged in to KiteStub.</body></html>";
+        return r;
+    }
+
+    const bool sessionCall = path == "/session/token";
+    if (m_options.requireAuth && !sessionCall && !request.headers.value("authorization").startsWith("token ")) {
+        return kiteError(403, "TokenException", "Incorrect `api_key` or `access_token`.");
+    }
+
+    StoredResponse stored;
+    if (m_store.lookup(method, request.target, &stored)) {
+        Response r;
+        r.status = stored.status;
+        r.contentType = stored.contentType;
+        r.body = stored.body;
+        return r;
+    }
+    if (m_options.replayOnly)
+        return kiteError(404, "GeneralException", "No recording for " + QString::fromUtf8(method + ' ' + request.target));
+
+    // ---------- synthetic responses ----------
+    if (sessionCall && method == "POST") {
+        const QUrlQuery form(QString::fromUtf8(request.body));
+        return kiteSuccess(m_data.session(form.queryItemValue("api_key"), form.queryItemValue("request_token")));
+    }
+    if (method == "GET" && path == "/instruments") {
+        Response r;
+        r.contentType = "text/csv";
+        r.body = m_data.instrumentsCsv();
+        return r;
+    }
+    if (method == "GET" && path.startsWith("/instruments/historical/")) {
+        const QStringList parts = path.split('/', Qt::SkipEmptyParts);  // instruments, historical, token, interval
+        if (parts.size() != 4) return kiteError(400, "InputException", "invalid historical path");
+        QString error;
+        const QJsonObject data = m_data.historical(parts.at(2), parts.at(3),
+                                                   request.query.queryItemValue("from", QUrl::FullyDecoded),
+                                                   request.query.queryItemValue("to", QUrl::FullyDecoded), &error);
+        if (!error.isEmpty()) return kiteError(400, "InputException", error);
+        return kiteSuccess(data);
+    }
+    if (method == "GET" && (path == "/quote" || path == "/quote/ohlc" || path == "/quote/ltp")) {
+        const QString mode = path == "/quote" ? "full" : path.mid(7);
+        QJsonObject data;
+        for (const QString& instrument : request.query.allQueryItemValues("i", QUrl::FullyDecoded))
+            data.insert(instrument, m_data.quote(instrument, mode));
+        return kiteSuccess(data);
+    }
+    if (method == "GET" && path == "/user/profile") return kiteSuccess(m_data.profile());
+    if (method == "GET" && path == "/user/margins") return kiteSuccess(m_data.margins());
+    if (method == "GET" && path.startsWith("/user/margins/"))
+        return kiteSuccess(m_data.margins().value(path.mid(14)));
+    if (method == "GET" && (path == "/orders" || path == "/trades" || path == "/portfolio/holdings"))
+        return kiteSuccess(QJsonArray());
+    if (method == "GET" && path == "/portfolio/positions")
+        return kiteSuccess(QJsonObject{ { "net", QJsonArray() }, { "day", QJsonArray() } });
+    if (path.startsWith("/orders/")) {
+        const QStringList parts = path.split('/', Qt::SkipEmptyParts);  // orders, variety[, order_id]
+        if (method == "POST" && parts.size() == 2)
+            return kiteSuccess(QJsonObject{ { "order_id", m_data.nextOrderId() } });
+        if ((method == "PUT" || method == "DELETE") && parts.size() == 3)
+            return kiteSuccess(QJsonObject{ { "order_id", parts.at(2) } });
+    }
+    return kiteError(404, "GeneralException", "Route not found");
+}
+
+// Record mode: pass the request to the real API unchanged and keep what comes back
+void StubServer::forward(QTcpSocket* socket, const Request& request)
+{
+    QNetworkRequest upstream(QUrl::fromEncoded(m_options.upstream.toEncoded() + request.target));
+    for (const QByteArray name : { QByteArray("authorization"), QByteArray("x-kite-version"),
+                                   QByteArray("content-type"), QByteArray("user-agent") }) {
+        if (request.headers.contains(name)) upstream.setRawHeader(name, request.headers.value(name));
+    }
+    QNetworkReply* reply = m_upstream->sendCustomRequest(upstream, request.method, request.body);
+    connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+    QPointer<QTcpSocket> guard(socket);
+    connect(reply, &QNetworkReply::finished, this, [this, guard, reply, request]() {
+        Response response;
+        response.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (response.status == 0) {
+            response = kiteError(502, "NetworkException", "Upstream: " + reply->errorString());
+        } else {
+            response.contentType = reply->rawHeader("Content-Type");
+            response.body = reply->readAll();
+            // Never persist the session exchange (it carries the access token)
+            const bool ok = response.status >= 200 && response.status < 300;
+            if (ok && request.path != "/session/token") {
+                StoredResponse stored;
+                stored.status = response.status;
+                stored.contentType = response.contentType;
+                stored.body = response.body;
+                m_store.save(request.method, request.target, stored);
+            }
+        }
+        if (guard) send(guard, request, response);
+    });
+}
+
+void StubServer::send(QTcpSocket* socket, const Request& request, const Response& response)
+{
+    QByteArray out = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' + reasonPhrase(response.status) + "\r\n";
+    out += "Content-Type: " + response.contentType + "\r\n";
+    out += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    for (const auto& header : response.headers)
+        out += header.first + ": " + header.second + "\r\n";
+    out += request.keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    if (request.method != "HEAD") out += response.body;
+    socket->write(out);
+
+    if (m_options.verbose) {
+        const double ms = double(m_clock.nsecsElapsed() - request.receivedNs) / 1e6;
+        qInfo().noquote() << QString("%1 %2 -> %3 (%4 ms, %5 bytes)")
+                                 .arg(QString::fromLatin1(request.method), QString::fromUtf8(request.target))
+                                 .arg(response.status).arg(ms, 0, 'f', 1).arg(response.body.size());
+    }
+
+    if (!request.keepAlive) {
+        socket->disconnectFromHost();
+        return;
+    }
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) return;
+    it->busy = false;
+    if (!it->buffer.isEmpty()) readRequests(socket);    // a request that arrived meanwhile
+}
+
+void StubServer::reportStats()
+{
+    quint64 total = 0;
+    for (const ClassStats& s : m_stats) total += s.requests;
+    if (total == m_lastReportedRequests) return;
+    m_lastReportedRequests = total;
+
+    QStringList parts;
+    for (int c = 0; c < int(StubClass::Count); ++c) {
+        const ClassStats& s = m_stats[c];
+        if (!s.requests) continue;
+        parts << QString("%1 %2 (429: %3, faults: %4)").arg(StubProfile::className(StubClass(c)))
+                     .arg(s.requests).arg(s.limited).arg(s.faults);
+    }
+    qInfo().noquote() << "KiteStub:" << parts.join(", ") << "| connections:" << m_connections.size();
+}
@@ -0,0 +1,134 @@
+#ifndef STUBSERVER_H
+#define STUBSERVER_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QJsonValue>
+
+#include "Tools/KiteStub/stubprofile.h"
+#include "Tools/KiteStub/recordstore.h"
+#include "Tools/KiteStub/syntheticdata.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class QNetworkAccessManager;
+
+/**
+ * @brief Local stand-in for api.kite.trade, for offline load tests and benchmarks.
+ *
+ * Plain HTTP/1.1 with keep-alive, one request at a time per connection (QNetworkAccessManager
+ * does not pipeline). Serves instruments, historical candles, quotes, profile, margins, orders
+ * and the session exchange with Kite's response envelope, plus /connect/login, which redirects
+ * straight back with a request_token so the app's login dialog completes without a browser
+ * login. Every API request goes through the same steps:
+ * - the class's token bucket (StubProfile rates; Kite's limits by default) answers 429 with
+ *   Kite's NetworkException body when exceeded;
+ * - the class's fault model may reset the connection, stall, answer 500/503 or truncate the body;
+ * - the response comes from the recording directory when it has one for the request, otherwise
+ *   from SyntheticData (or 404 in replay-only mode);
+ * - it is sent after a delay drawn from the class's latency distribution.
+ *
+ * All randomness comes from the profile seed, so a run with the same seed and request order
+ * makes the same decisions. In record mode the server instead forwards each request to the real
+ * API, returns the answer unchanged and saves successful ones (never /session/token) for replay.
+ */
+class StubServer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Command-line settings.
+     */
+    struct Options {
+        QHostAddress address = QHostAddress::LocalHost;
+        quint16 port = 8765;
+        StubProfile profile = StubProfile::defaults();
+        QString recordingsDir;      ///< Replay from (and, in record mode, save to) here.
+        QUrl upstream;              ///< Record mode: forward to this API root.
+        bool replayOnly = false;    ///< 404 instead of synthetic data when nothing is recorded.
+        bool requireAuth = true;    ///< 403 for API calls without "Authorization: token ...".
+        bool verbose = false;       ///< Log every request.
+    };
+
+    explicit StubServer(const Options& options, QObject* parent = nullptr);
+
+    bool start(QString* error);
+    /** @brief Root URL to point the app at (QPX_API_BASE_URL). */
+    QUrl baseUrl() const;
+    int recordingCount() const { return m_store.size(); }
+
+private slots:
+    void onNewConnection();
+    void reportStats();
+
+private:
+    struct Request {
+        QByteArray method;
+        QByteArray target;      // path?query as sent
+        QString path;
+        QUrlQuery query;
+        QHash<QByteArray, QByteArray> headers;  // lower-case names
+        QByteArray body;
+        bool keepAlive = true;
+        qint64 receivedNs = 0;
+    };
+
+    struct Response {
+        int status = 200;
+        QByteArray contentType = "application/json";
+        QByteArray body;
+        QList<QPair<QByteArray, QByteArray>> headers;
+    };
+
+    struct Connection {
+        QByteArray buffer;
+        bool busy = false;      // a request is being answered; later ones wait in the buffer
+    };
+
+    struct Bucket {
+        double tokens = 1.0;
+        qint64 lastNs = 0;
+    };
+
+    struct ClassStats {
+        quint64 requests = 0;
+        quint64 limited = 0;
+        quint64 faults = 0;
+    };
+
+    void readRequests(QTcpSocket* socket);
+    enum class Parse { Incomplete, Ready, Bad };
+    Parse parseRequest(QByteArray& buffer, Request* out) const;
+    void handle(QTcpSocket* socket, const Request& request);
+    Response route(const Request& request);
+    void forward(QTcpSocket* socket, const Request& request);
+    void send(QTcpSocket* socket, const Request& request, const Response& response);
+    bool takeToken(StubClass cls);
+
+    static Response kiteSuccess(const QJsonValue& data);
+    static Response kiteError(int status, const QString& errorType, const QString& message);
+
+    Options m_options;
+    QTcpServer* m_server;
+    QNetworkAccessManager* m_upstream = nullptr;
+    RecordStore m_store;
+    SyntheticData m_data;
+    QRandomGenerator m_rng;
+    QElapsedTimer m_clock;
+    Bucket m_buckets[int(StubClass::Count)];
+    ClassStats m_stats[int(StubClass::Count)];
+    QHash<QTcpSocket*, Connection> m_connections;
+    QTimer* m_statsTimer;
+    quint64 m_lastReportedRequests = 0;
+};
+
+#endif // STUBSERVER_H
@@ -0,0 +1,450 @@
+#include "Tools/KiteStub/syntheticdata.h"
+
+#include <QJsonArray>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+static const double kPi = 3.14159265358979323846;
+static const qint64 kIstOffsetSeconds = 19800;     // UTC+5:30
+static const int kSessionOpenSeconds = 9 * 3600 + 15 * 60;
+static const int kSessionCloseSeconds = 15 * 3600 + 30 * 60;
+static const quint32 kNiftyToken = 256265;
+static const quint32 kBankNiftyToken = 260105;
+
+// ---------- hashing ----------
+
+static quint64 fnv1a(const QByteArray& bytes)
+{
+    quint64 h = 1469598103934665603ULL;
+    for (char c : bytes) {
+        h ^= quint8(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static quint64 splitmix(quint64 x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+quint64 SyntheticData::mix(quint64 a, quint64 b) const
+{
+    return splitmix(splitmix(m_seed ^ a) ^ b);
+}
+
+double SyntheticData::unit(quint64 h) const
+{
+    return double(h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// ---------- calendar ----------
+
+static qint64 istEpochSeconds(const QDate& date, int secondsOfDay)
+{
+    return (date.toJulianDay() - 2440588) * 86400 + secondsOfDay - kIstOffsetSeconds;
+}
+
+static QDate istDateOf(qint64 epochSeconds)
+{
+    return QDate::fromJulianDay((epochSeconds + kIstOffsetSeconds) / 86400 + 2440588);
+}
+
+static bool isTradingDay(const QDate& date)
+{
+    return date.dayOfWeek() <= 5;
+}
+
+static QDate lastThursdayOf(int year, int month)
+{
+    QDate d(year, month, QDate(year, month, 1).daysInMonth());
+    while (d.dayOfWeek() != 4) d = d.addDays(-1);
+    return d;
+}
+
+// "yyyy-MM-dd HH:mm:ss" (or with '+' for the space, or just a date) -> IST epoch seconds
+static bool parseRangeBound(QString text, bool endOfDay, qint64* out)
+{
+    text.replace('+', ' ');
+    const QDateTime dt = QDateTime::fromString(text.trimmed(), "yyyy-MM-dd HH:mm:ss");
+    if (dt.isValid()) {
+        *out = istEpochSeconds(dt.date(), dt.time().msecsSinceStartOfDay() / 1000);
+        return true;
+    }
+    const QDate d = QDate::fromString(text.trimmed(), "yyyy-MM-dd");
+    if (!d.isValid()) return false;
+    *out = istEpochSeconds(d, endOfDay ? 86399 : 0);
+    return true;
+}
+
+static QString kiteTimestamp(qint64 epochSeconds)
+{
+    const qint64 local = epochSeconds + kIstOffsetSeconds;
+    const QDate date = QDate::fromJulianDay(local / 86400 + 2440588);
+    const QTime time = QTime(0, 0).addSecs(int(local % 86400));
+    return date.toString("yyyy-MM-dd") + "T" + time.toString("HH:mm:ss") + "+0530";
+}
+
+static QString quoteTimestamp(qint64 epochSeconds)
+{
+    const qint64 local = epochSeconds + kIstOffsetSeconds;
+    const QDate date = QDate::fromJulianDay(local / 86400 + 2440588);
+    const QTime time = QTime(0, 0).addSecs(int(local % 86400));
+    return date.toString("yyyy-MM-dd") + " " + time.toString("HH:mm:ss");
+}
+
+static double roundToTick(double price, double tick)
+{
+    return std::round(price / tick) * tick;
+}
+
+// ---------- instruments ----------
+
+SyntheticData::SyntheticData(quint64 seed)
+    : m_seed(seed), m_nextOrderId(250000000000000ULL + (seed % 1000) * 1000000ULL)
+{
+    buildInstruments();
+}
+
+void SyntheticData::addInstrument(const Instrument& instrument)
+{
+    m_instruments.insert(instrument.token, instrument);
+    m_bySymbol.insert(instrument.exchange + ":" + instrument.tradingSymbol, instrument.token);
+    m_order.append(instrument.token);
+}
+
+void SyntheticData::buildInstruments()
+{
+    Instrument nifty;
+    nifty.token = kNiftyToken;
+    nifty.tradingSymbol = "NIFTY 50";
+    nifty.name = "NIFTY 50";
+    nifty.instrumentType = "EQ";
+    nifty.segment = "INDICES";
+    nifty.exchange = "NSE";
+    nifty.tickSize = 0.0;
+    nifty.lotSize = 0;
+    nifty.basePrice = 24000.0;
+    addInstrument(nifty);
+
+    Instrument bank = nifty;
+    bank.token = kBankNiftyToken;
+    bank.tradingSymbol = "NIFTY BANK";
+    bank.name = "NIFTY BANK";
+    bank.basePrice = 52000.0;
+    addInstrument(bank);
+
+    // Monthly expiries (last Thursday) for three months, weekly (Thursday) for two weeks
+    const QDate today = QDate::currentDate();
+    QList<QDate> monthly;
+    for (int m = 0; monthly.size() < 3 && m < 4; ++m) {
+        const QDate first = QDate(today.year(), today.month(), 1).addMonths(m);
+        const QDate expiry = lastThursdayOf(first.year(), first.month());
+        if (expiry >= today) monthly << expiry;
+    }
+    QList<QDate> optionExpiries = monthly.mid(0, 2);
+    QDate weekly = today;
+    while (weekly.dayOfWeek() != 4) weekly = weekly.addDays(1);
+    for (int w = 0; w < 2; ++w, weekly = weekly.addDays(7))
+        if (!optionExpiries.contains(weekly)) optionExpiries << weekly;
+    std::sort(optionExpiries.begin(), optionExpiries.end());
+
+    struct Underlying { quint32 indexToken; double indexBase; const char* name; double step; int lot; };
+    const Underlying underlyings[] = {
+        { kNiftyToken, nifty.basePrice, "NIFTY", 50.0, 75 },
+        { kBankNiftyToken, bank.basePrice, "BANKNIFTY", 100.0, 35 },
+    };
+    quint32 nextToken = 12000000;
+    for (const Underlying& u : underlyings) {
+        const quint32 indexToken = u.indexToken;
+        const double indexBase = u.indexBase;
+        for (const QDate& expiry : monthly) {
+            Instrument fut;
+            fut.token = nextToken++;
+            fut.name = u.name;
+            fut.tradingSymbol = QString("%1%2%3FUT").arg(u.name, expiry.toString("yy"),
+                                                         expiry.toString("MMM").toUpper());
+            fut.expiry = expiry.toString("yyyy-MM-dd");
+            fut.lotSize = u.lot;
+            fut.instrumentType = "FUT";
+            fut.segment = "NFO-FUT";
+            fut.exchange = "NFO";
+            fut.underlying = indexToken;
+            fut.basePrice = indexBase;
+            addInstrument(fut);
+        }
+        const double atm = roundToTick(indexBase, u.step);
+        for (const QDate& expiry : optionExpiries) {
+            for (int k = -20; k <= 20; ++k) {
+                for (const char* type : { "CE", "PE" }) {
+                    Instrument opt;
+                    opt.token = nextToken++;
+                    opt.name = u.name;
+                    opt.strike = atm + k * u.step;
+                    opt.tradingSymbol = QString("%1%2%3%4%5").arg(u.name, expiry.toString("yy"),
+                                                                  expiry.toString("MMMdd").toUpper())
+                                            .arg(qint64(opt.strike)).arg(type);
+                    opt.expiry = expiry.toString("yyyy-MM-dd");
+                    opt.lotSize = u.lot;
+                    opt.instrumentType = type;
+                    opt.segment = "NFO-OPT";
+                    opt.exchange = "NFO";
+                    opt.underlying = indexToken;
+                    opt.basePrice = indexBase;
+                    addInstrument(opt);
+                }
+            }
+        }
+    }
+
+    // A few cash equities (real tokens, synthetic prices) for watchlists and quote polling
+    struct Equity { quint32 token; const char* symbol; const char* name; double price; };
+    const Equity equities[] = {
+        { 738561, "RELIANCE", "RELIANCE INDUSTRIES", 2900.0 },
+        { 408065, "INFY", "INFOSYS", 1600.0 },
+        { 2953217, "TCS", "TATA CONSULTANCY SERV LT", 3900.0 },
+        { 341249, "HDFCBANK", "HDFC BANK", 1650.0 },
+        { 1270529, "ICICIBANK", "ICICI BANK.", 1200.0 },
+        { 779521, "SBIN", "STATE BANK OF INDIA", 800.0 },
+    };
+    for (const Equity& e : equities) {
+        Instrument eq;
+        eq.token = e.token;
+        eq.tradingSymbol = e.symbol;
+        eq.name = e.name;
+        eq.instrumentType = "EQ";
+        eq.segment = "NSE";
+        eq.exchange = "NSE";
+        eq.basePrice = e.price;
+        addInstrument(eq);
+    }
+}
+
+QByteArray SyntheticData::instrumentsCsv()
+{
+    QByteArray csv = "instrument_token,exchange_token,tradingsymbol,name,last_price,expiry,strike,"
+                     "tick_size,lot_size,instrument_type,segment,exchange\n";
+    for (quint32 token : std::as_const(m_order)) {
+        const Instrument& i = m_instruments[token];
+        csv += QString("%1,%2,%3,\"%4\",0,%5,%6,%7,%8,%9,%10,%11\n")
+                   .arg(i.token).arg(i.token >> 8).arg(i.tradingSymbol, i.name, i.expiry)
+                   .arg(i.strike).arg(i.tickSize).arg(i.lotSize)
+                   .arg(i.instrumentType, i.segment, i.exchange)
+                   .toUtf8();
+    }
+    return csv;
+}
+
+// ---------- prices ----------
+
+double SyntheticData::basePriceOf(quint32 token) const
+{
+    auto it = m_instruments.constFind(token);
+    if (it != m_instruments.constEnd()) return it->basePrice;
+    return 100.0 + 2900.0 * unit(mix(token, 0xBA5E));
+}
+
+quint32 SyntheticData::tokenOf(const QString& instrument) const
+{
+    bool numeric = false;
+    const quint32 token = instrument.toUInt(&numeric);
+    if (numeric) return token;
+    auto it = m_bySymbol.constFind(instrument);
+    if (it != m_bySymbol.constEnd()) return *it;
+    return 30000000 + quint32(fnv1a(instrument.toUtf8()) % 1000000);
+}
+
+// Smooth level: three sine waves (weeks, days, hours) with per-instrument phases
+double SyntheticData::indexLevelAt(quint32 token, double basePrice, qint64 t) const
+{
+    const double p1 = 2.0 * kPi * unit(mix(token, 1));
+    const double p2 = 2.0 * kPi * unit(mix(token, 2));
+    const double p3 = 2.0 * kPi * unit(mix(token, 3));
+    const double x = 0.04 * std::sin(2.0 * kPi * double(t) / (23.0 * 86400.0) + p1)
+                   + 0.015 * std::sin(2.0 * kPi * double(t) / (3.1 * 86400.0) + p2)
+                   + 0.004 * std::sin(2.0 * kPi * double(t) / (2.3 * 3600.0) + p3);
+    return basePrice * std::exp(x);
+}
+
+double SyntheticData::levelAt(quint32 token, qint64 t) const
+{
+    auto it = m_instruments.constFind(token);
+    if (it == m_instruments.constEnd() || !it->underlying)
+        return indexLevelAt(token, basePriceOf(token), t);
+
+    const Instrument& i = *it;
+    const double spot = indexLevelAt(i.underlying, i.basePrice, t);
+    const QDate expiry = QDate::fromString(i.expiry, "yyyy-MM-dd");
+    const double days = qMax(0.0, double(istEpochSeconds(expiry, kSessionCloseSeconds) - t) / 86400.0);
+    if (i.instrumentType == "FUT")
+        return spot * (1.0 + 0.0002 * days);
+
+    // Options: intrinsic value plus a time value that decays with expiry and distance from spot
+    const double intrinsic = i.instrumentType == "CE" ? qMax(0.0, spot - i.strike) : qMax(0.0, i.strike - spot);
+    const double timeValue = spot * 0.008 * std::sqrt(days / 7.0 + 0.01)
+                             * std::exp(-std::abs(i.strike - spot) / (0.02 * spot));
+    return qMax(0.05, intrinsic + timeValue);
+}
+
+// ---------- responses ----------
+
+QJsonObject SyntheticData::historical(const QString& instrumentToken, const QString& interval,
+                                      const QString& from, const QString& to, QString* error)
+{
+    static const QHash<QString, int> stepMinutes = {
+        { "minute", 1 }, { "3minute", 3 }, { "5minute", 5 }, { "10minute", 10 },
+        { "15minute", 15 }, { "30minute", 30 }, { "60minute", 60 }, { "day", 0 },
+    };
+    QJsonArray candles;
+    auto step = stepMinutes.constFind(interval);
+    qint64 fromS = 0, toS = 0;
+    if (step == stepMinutes.constEnd()) {
+        *error = "invalid interval: " + interval;
+        return QJsonObject{ { "candles", candles } };
+    }
+    if (!parseRangeBound(from, false, &fromS) || !parseRangeBound(to, true, &toS) || fromS > toS) {
+        *error = "invalid from/to range";
+        return QJsonObject{ { "candles", candles } };
+    }
+
+    const quint32 token = instrumentToken.toUInt();
+    const double tick = 0.05;
+    // Noise is a function of the timestamp, so adjacent candles share their boundary price
+    auto priceAt = [&](qint64 t) {
+        return levelAt(token, t) * (1.0 + 0.001 * (unit(mix(token, quint64(t))) - 0.5));
+    };
+    auto appendCandle = [&](qint64 stamp, qint64 t0, qint64 t1, double volumeScale) {
+        const double o = priceAt(t0), c = priceAt(t1);
+        const quint64 h = mix(token ^ 0xC0FFEE, quint64(t0));
+        const double spread = 0.002 * std::sqrt(volumeScale);
+        const double hi = qMax(o, c) * (1.0 + spread * unit(h));
+        const double lo = qMin(o, c) * (1.0 - spread * unit(splitmix(h)));
+        const qint64 volume = qint64(1000.0 * volumeScale * (0.5 + unit(splitmix(h ^ 7))));
+        candles.append(QJsonArray{ kiteTimestamp(stamp), roundToTick(o, tick), roundToTick(hi, tick),
+                                   roundToTick(lo, tick), roundToTick(c, tick), volume });
+    };
+
+    const int maxCandles = 200000;
+    for (QDate d = istDateOf(fromS); d <= istDateOf(toS) && candles.size() < maxCandles; d = d.addDays(1)) {
+        if (!isTradingDay(d)) continue;
+        const qint64 open = istEpochSeconds(d, kSessionOpenSeconds);
+        const qint64 close = istEpochSeconds(d, kSessionCloseSeconds);
+        if (*step == 0) {
+            const qint64 midnight = istEpochSeconds(d, 0);
+            if (midnight + 86399 < fromS || midnight > toS) continue;
+            appendCandle(midnight, open, close, 75.0);
+            continue;
+        }
+        const qint64 stepS = qint64(*step) * 60;
+        for (qint64 t = open; t < close; t += stepS) {
+            if (t < fromS || t > toS) continue;
+            appendCandle(t, t, qMin(t + stepS, close), double(*step));
+        }
+    }
+    return QJsonObject{ { "candles", candles } };
+}
+
+QJsonObject SyntheticData::quote(const QString& instrument, const QString& mode)
+{
+    const quint32 token = tokenOf(instrument);
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const double tick = 0.05;
+    const double last = roundToTick(levelAt(token, now), tick);
+
+    QJsonObject q{ { "instrument_token", qint64(token) }, { "last_price", last } };
+    if (mode == "ltp") return q;
+
+    // Session so far (or the whole of the last session outside market hours)
+    QDate day = istDateOf(now);
+    while (!isTradingDay(day)) day = day.addDays(-1);
+    QDate previous = day.addDays(-1);
+    while (!isTradingDay(previous)) previous = previous.addDays(-1);
+    const qint64 open = istEpochSeconds(day, kSessionOpenSeconds);
+    const qint64 until = qBound(open, now, istEpochSeconds(day, kSessionCloseSeconds));
+    const double o = levelAt(token, open);
+    double hi = qMax(o, last), lo = qMin(o, last);
+    for (qint64 t = open; t < until; t += 900) {
+        const double p = levelAt(token, t);
+        hi = qMax(hi, p);
+        lo = qMin(lo, p);
+    }
+    const double prevClose = roundToTick(levelAt(token, istEpochSeconds(previous, kSessionCloseSeconds)), tick);
+    q.insert("ohlc", QJsonObject{ { "open", roundToTick(o, tick) }, { "high", roundToTick(hi, tick) },
+                                  { "low", roundToTick(lo, tick) }, { "close", prevClose } });
+    if (mode == "ohlc") return q;
+
+    const quint64 h = mix(token, quint64(now));
+    const qint64 volume = qint64(500000.0 * (0.5 + unit(h)) * double(until - open + 60) / 22500.0);
+    q.insert("timestamp", quoteTimestamp(now));
+    q.insert("last_trade_time", quoteTimestamp(now - qint64(unit(splitmix(h)) * 5)));
+    q.insert("net_change", roundToTick(last - prevClose, tick));
+    q.insert("average_price", roundToTick((o + hi + lo + last) / 4.0, tick));
+    q.insert("lower_circuit_limit", roundToTick(prevClose * 0.8, tick));
+    q.insert("upper_circuit_limit", roundToTick(prevClose * 1.2, tick));
+    q.insert("last_quantity", qint64(1 + unit(splitmix(h ^ 1)) * 100));
+    q.insert("volume", volume);
+    q.insert("buy_quantity", qint64(volume * 0.1 * (0.5 + unit(splitmix(h ^ 2)))));
+    q.insert("sell_quantity", qint64(volume * 0.1 * (0.5 + unit(splitmix(h ^ 3)))));
+    q.insert("oi", qint64(volume * 0.3));
+    q.insert("oi_day_high", qint64(volume * 0.35));
+    q.insert("oi_day_low", qint64(volume * 0.25));
+
+    QJsonArray buy, sell;
+    for (int level = 0; level < 5; ++level) {
+        const quint64 lh = splitmix(h ^ quint64(100 + level));
+        buy.append(QJsonObject{ { "price", roundToTick(last - tick * (level + 1), tick) },
+                                { "quantity", qint64(50 + unit(lh) * 1000) }, { "orders", 1 + int(unit(lh) * 20) } });
+        sell.append(QJsonObject{ { "price", roundToTick(last + tick * (level + 1), tick) },
+                                 { "quantity", qint64(50 + unit(splitmix(lh)) * 1000) },
+                                 { "orders", 1 + int(unit(splitmix(lh)) * 20) } });
+    }
+    q.insert("depth", QJsonObject{ { "buy", buy }, { "sell", sell } });
+    return q;
+}
+
+QJsonObject SyntheticData::session(const QString& apiKey, const QString& requestToken)
+{
+    const QString accessToken = "stub" + QString::number(mix(fnv1a(requestToken.toUtf8()), 0x5E55), 16);
+    return QJsonObject{
+        { "user_id", "QX0001" }, { "user_name", "Stub User" }, { "user_shortname", "Stub" },
+        { "email", "stub@example.com" }, { "user_type", "individual" }, { "broker", "ZERODHA" },
+        { "api_key", apiKey }, { "access_token", accessToken }, { "public_token", accessToken.left(12) },
+        { "refresh_token", "" }, { "login_time", quoteTimestamp(QDateTime::currentSecsSinceEpoch()) },
+    };
+}
+
+QJsonObject SyntheticData::profile() const
+{
+    return QJsonObject{
+        { "user_id", "QX0001" }, { "user_name", "Stub User" }, { "user_shortname", "Stub" },
+        { "email", "stub@example.com" }, { "user_type", "individual" }, { "broker", "ZERODHA" },
+        { "exchanges", QJsonArray{ "NSE", "NFO", "BSE" } },
+        { "products", QJsonArray{ "CNC", "NRML", "MIS" } },
+        { "order_types", QJsonArray{ "MARKET", "LIMIT", "SL", "SL-M" } },
+    };
+}
+
+QJsonObject SyntheticData::margins() const
+{
+    auto segment = [](double cash) {
+        return QJsonObject{
+            { "enabled", true }, { "net", cash },
+            { "available", QJsonObject{ { "adhoc_margin", 0 }, { "cash", cash }, { "opening_balance", cash },
+                                        { "live_balance", cash }, { "collateral", 0 }, { "intraday_payin", 0 } } },
+            { "utilised", QJsonObject{ { "debits", 0 }, { "exposure", 0 }, { "m2m_realised", 0 },
+                                       { "m2m_unrealised", 0 }, { "option_premium", 0 }, { "payout", 0 },
+                                       { "span", 0 }, { "holding_sales", 0 }, { "turnover", 0 } } },
+        };
+    };
+    return QJsonObject{ { "equity", segment(500000.0) }, { "commodity", segment(0.0) } };
+}
+
+QString SyntheticData::nextOrderId()
+{
+    return QString::number(m_nextOrderId++);
+}
@@ -0,0 +1,84 @@
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDate>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QHash>
+
+/**
+ * @brief Deterministic market data for the stand-in server.
+ *
+ * Every value is a pure function of the seed and what is asked for: prices follow a smooth
+ * curve per instrument (a few overlapping sine waves around a base price) plus hashed noise per
+ * candle, so the same candle always has the same OHLCV no matter which range it was requested
+ * in, and two runs with one seed serve byte-identical data. Quotes sample the same curve at the
+ * current time.
+ *
+ * The instrument list holds what the app filters for: the NIFTY 50 and NIFTY BANK indices,
+ * NIFTY/BANKNIFTY futures for the next three monthly expiries, and weekly plus monthly options
+ * around the current level, followed by a block of NSE equities.
+ */
+class SyntheticData
+{
+public:
+    explicit SyntheticData(quint64 seed);
+
+    /** @brief Kite's instruments CSV (header plus one row per instrument). */
+    QByteArray instrumentsCsv();
+
+    /**
+     * @brief Candles of /instruments/historical/{token}/{interval} between from and to
+     * ("yyyy-MM-dd HH:mm:ss", "yyyy-MM-dd+HH:mm:ss" or "yyyy-MM-dd"), trading hours only.
+     * @param error Set (and an empty array returned) for an unknown interval or bad range.
+     */
+    QJsonObject historical(const QString& instrumentToken, const QString& interval,
+                           const QString& from, const QString& to, QString* error);
+
+    /**
+     * @brief One instrument of /quote (mode "full"), /quote/ohlc ("ohlc") or /quote/ltp ("ltp").
+     * @param instrument Token or "EXCHANGE:TRADINGSYMBOL", as passed in i=.
+     */
+    QJsonObject quote(const QString& instrument, const QString& mode);
+
+    QJsonObject session(const QString& apiKey, const QString& requestToken);
+    QJsonObject profile() const;
+    QJsonObject margins() const;
+    /** @brief Next order ID (increasing, deterministic per run). */
+    QString nextOrderId();
+
+private:
+    struct Instrument {
+        quint32 token = 0;
+        QString tradingSymbol;
+        QString name;
+        QString expiry;         // yyyy-MM-dd, empty for non-derivatives
+        double strike = 0.0;
+        double tickSize = 0.05;
+        int lotSize = 1;
+        QString instrumentType; // EQ, INDEX, FUT, CE, PE
+        QString segment;
+        QString exchange;
+        double basePrice = 100.0;
+        quint32 underlying = 0; // index token of a future/option
+    };
+
+    void buildInstruments();
+    void addInstrument(const Instrument& instrument);
+    double basePriceOf(quint32 token) const;
+    quint32 tokenOf(const QString& instrument) const;
+    double levelAt(quint32 token, qint64 epochSeconds) const;
+    double indexLevelAt(quint32 token, double basePrice, qint64 epochSeconds) const;
+    quint64 mix(quint64 a, quint64 b) const;
+    double unit(quint64 h) const;  // [0, 1)
+
+    quint64 m_seed;
+    QHash<quint32, Instrument> m_instruments;
+    QHash<QString, quint32> m_bySymbol;     // "EXCHANGE:TRADINGSYMBOL" -> token
+    QList<quint32> m_order;                 // CSV row order
+    quint64 m_nextOrderId;
+};
+
+#endif // SYNTHETICDATA_H
@@ -2,10 +2,12 @@
 #include "ui_mainWindow.h" // Verify exact filename generated by Qt UIC
 #include "UI/LoginDialog.h"
 #include "Network/kiteconnectapi.h"
+#include "Network/quotepoller.h"
 #include "Data/datamanager.h"
 #include "Utils/configurationmanager.h"
 #include "Data/DataStructures/InstrumentData.h"
 #include "Utils/marketcalendar.h"
+#include "Utils/tracer.h"
 
 #include <QDebug>
 #include <QUrl>
@@ -14,13 +16,10 @@
 #include <QDateTime>
 #include <QVariant>
 #include <algorithm> // Needed for std::sort
-#include <QTimer> // Include QTimer for singleShot
+#include <QFuture>
 #include <QLocale> // Needed for currency formatting
 #include <QStatusBar> // Include for QStatusBar
 
-const int API_REQUEST_DELAY_MS = 500;
-
-
 // Constructor
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -30,6 +29,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_dataManager(nullptr)
     , m_availableFunds(0.0) // Initialize member
 {
+    TRACE_ZONE("startup", "MainWindow::MainWindow");
     ui->setupUi(this);
     this->setWindowTitle("QphoeniX Trading Application");
 
@@ -89,6 +89,14 @@ void MainWindow::setKiteConnectAPI(KiteConnectAPI *api) {
     // Setup connections related to KiteAPI now that it's valid
     setupConnections();
 
+    // Quote polling: groups from config.json ("quote_polling"); started once instruments are ready
+    delete m_quotePoller;
+    m_quotePoller = new QuotePoller(m_kiteApi, this);
+    if (ConfigurationManager::instance())
+        m_quotePoller->loadFromConfig(ConfigurationManager::instance()->getQuotePollingConfig());
+    connect(m_quotePoller, &QuotePoller::quotesUpdated, m_dataManager,
+            [this](const QString&, const QVector<QuoteData>& quotes) { m_dataManager->onQuotesReceived(quotes); });
+
     // Check API key status after API object is set
     ConfigurationManager* configMgr = ConfigurationManager::instance();
     bool keysOk = (configMgr && !configMgr->getApiKey().isEmpty() && !configMgr->getApiSecret().isEmpty());
@@ -111,17 +119,7 @@ void MainWindow::setupConnections() {
     connect(m_kiteApi, &KiteConnectAPI::requiresUserLoginRedirect, this, &MainWindow::onRedirectUserForLogin, Qt::UniqueConnection);
     connect(m_kiteApi, &KiteConnectAPI::sessionGenerated, this, &MainWindow::onLoginSuccessful, Qt::UniqueConnection);
     connect(m_kiteApi, &KiteConnectAPI::sessionGenerationFailed, this, &MainWindow::onLoginFailed, Qt::UniqueConnection); // Connect to the single onLoginFailed
-    connect(m_kiteApi, &KiteConnectAPI::userProfileReceived, this, &MainWindow::onUserProfileReceived, Qt::UniqueConnection);
-    connect(m_kiteApi, &KiteConnectAPI::userMarginsReceived, this, &MainWindow::onUserMarginsReceived, Qt::UniqueConnection);
-
-    // Connect failure signals using lambdas WITHOUT UniqueConnection to avoid warnings
-    connect(m_kiteApi, &KiteConnectAPI::userProfileFailed, this,
-            [this](const QString& error){ this->onProfileOrMarginsFailed("Profile", error); } /* Removed Qt::UniqueConnection */ );
-    connect(m_kiteApi, &KiteConnectAPI::userMarginsFailed, this,
-            [this](const QString& error){ this->onProfileOrMarginsFailed("Margins", error); } /* Removed Qt::UniqueConnection */ );
-
-    connect(m_kiteApi, &KiteConnectAPI::instrumentsFetched, this, &MainWindow::onInstrumentsFetched, Qt::UniqueConnection);
-    connect(m_kiteApi, &KiteConnectAPI::instrumentsFetchFailed, this, &MainWindow::onInstrumentsFetchFailed, Qt::UniqueConnection);
+    // Profile, margins and instruments are awaited in startSessionWorkflow(), not connected here
     connect(m_kiteApi, &KiteConnectAPI::historicalDataReceived, this, &MainWindow::onHistoricalDataReceived, Qt::UniqueConnection);
     connect(m_kiteApi, &KiteConnectAPI::historicalDataFailed, this, &MainWindow::onHistoricalDataFailed, Qt::UniqueConnection);
 
@@ -297,36 +295,61 @@ void MainWindow::onLoginFailed(const QString &error) {
 }
 
 
-// Handles successful session generation -> schedules Profile request
+// Handles successful session generation -> starts the post-login workflow
 void MainWindow::onLoginSuccessful(const QString &accessToken) {
     Q_UNUSED(accessToken);
+    TRACE_INSTANT("startup", "loginSuccessful");
     qDebug() << "MainWindow::onLoginSuccessful (Session Generated)";
     resetUserInfo();
     // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("API session active. Scheduling profile fetch...", 3000);
+    showStatusMessage("API session active. Fetching profile, margins and instruments...", 3000);
     ui->loginButton->setEnabled(false);
     if (m_loginDialog) { m_loginDialog = nullptr; }
 
-    qDebug() << "Scheduling user profile request with" << API_REQUEST_DELAY_MS << "ms delay.";
-    QTimer::singleShot(API_REQUEST_DELAY_MS, this, &MainWindow::requestUserProfile);
+    startSessionWorkflow();
 }
 
 
-// --- Profile/Margins/Instruments Sequence Slots ---
+// --- Profile/Margins/Instruments Workflow ---
 
-// Initiates the user profile request (called by timer)
-void MainWindow::requestUserProfile() {
-    if (!m_kiteApi) { qWarning("requestUserProfile: m_kiteApi is null"); return; }
-    qDebug() << "MainWindow: Requesting user profile (after delay)...";
-    // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("Fetching user profile...", 3000);
-    m_kiteApi->fetchUserProfile();
+// Post-login startup DAG: profile, margins and the instrument download are independent, so all
+// three go out at once. Each result is applied as soon as it lands (instruments go straight to
+// DataManager, whose ready signal starts the historical queue); the join only reports failures.
+void MainWindow::startSessionWorkflow() {
+    if (!m_kiteApi) { qWarning("startSessionWorkflow: m_kiteApi is null"); return; }
+    TRACE_ZONE("startup", "MainWindow::startSessionWorkflow");
+
+    // Each branch resolves to its error message (empty on success)
+    QList<QFuture<QString>> branches;
+    branches << m_kiteApi->fetchUserProfileAsync().then(this, [this](const ApiResult<QJsonObject>& r) {
+        if (r.ok) onUserProfileReceived(r.value);
+        return r.error;
+    });
+    branches << m_kiteApi->fetchUserMarginsAsync().then(this, [this](const ApiResult<QJsonObject>& r) {
+        if (r.ok) onUserMarginsReceived(r.value);
+        return r.error;
+    });
+    branches << m_kiteApi->fetchAllInstrumentsAsync().then(this, [this](const ApiResult<QVector<InstrumentData>>& r) {
+        if (r.ok) onInstrumentsFetched(r.value);
+        return r.error;
+    });
+
+    QtFuture::whenAll(branches.begin(), branches.end()).then(this, [this](const QList<QFuture<QString>>& done) {
+        const QString profileError = done.at(0).result();
+        const QString marginsError = done.at(1).result();
+        const QString instrumentsError = done.at(2).result();
+        // Report one failure, not a dialog per branch
+        if (!profileError.isEmpty())          onProfileOrMarginsFailed("Profile", profileError);
+        else if (!marginsError.isEmpty())     onProfileOrMarginsFailed("Margins", marginsError);
+        else if (!instrumentsError.isEmpty()) onInstrumentsFetchFailed(instrumentsError);
+    });
 }
 
-// Handles successful profile fetch -> updates UI & schedules Margins request
+// Applies the user profile -> updates UI
 void MainWindow::onUserProfileReceived(const QJsonObject& profileData)
 {
     if (!m_kiteApi) { qWarning("onUserProfileReceived: m_kiteApi is null"); return; }
+    TRACE_ZONE("startup", "MainWindow::onUserProfileReceived");
     qDebug() << "MainWindow: User Profile Received.";
 
     m_userName = profileData.value("user_name").toString("N/A");
@@ -337,24 +360,13 @@ void MainWindow::onUserProfileReceived(const QJsonObject& profileData)
         ui->statusLabel->setText(QString("User: %1 (%2)").arg(m_userName).arg(m_userId));
     }
 
-    // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("Profile OK. Scheduling margins fetch...", 3000);
-    qDebug() << "Scheduling user margins request with" << API_REQUEST_DELAY_MS << "ms delay.";
-    QTimer::singleShot(API_REQUEST_DELAY_MS, this, &MainWindow::requestUserMargins);
+    showStatusMessage("Profile OK.", 3000);
 }
 
-// Initiates the user margins request (called by timer)
-void MainWindow::requestUserMargins() {
-    if (!m_kiteApi) { qWarning("requestUserMargins: m_kiteApi is null"); return; }
-    qDebug() << "MainWindow: Requesting user margins (after delay)...";
-     // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("Fetching user margins...", 3000);
-    m_kiteApi->fetchUserMargins();
-}
-
-// Handles successful margin fetch -> stores info, updates label, schedules Instruments request
+// Applies the margins -> stores info, updates label
 void MainWindow::onUserMarginsReceived(const QJsonObject& marginData) {
     if (!m_kiteApi) { qWarning("onUserMarginsReceived: m_kiteApi is null"); return; }
+    TRACE_ZONE("startup", "MainWindow::onUserMarginsReceived");
     qDebug() << "MainWindow: User Margins Received OK.";
 
     m_availableFunds = 0.0;
@@ -379,22 +391,11 @@ void MainWindow::onUserMarginsReceived(const QJsonObject& marginData) {
         } else { ui->fundsLabel->setText("Funds: Error"); }
     } else { qWarning("fundsLabel UI element not found!"); }
 
-    // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("Margins OK. Scheduling instrument fetch...", 3000);
-    QTimer::singleShot(API_REQUEST_DELAY_MS, this, &MainWindow::requestInstruments);
+    showStatusMessage("Margins OK.", 3000);
 }
 
-// Initiates the instrument fetch request (called by timer)
-void MainWindow::requestInstruments() {
-    if (!m_kiteApi) { qWarning("requestInstruments: m_kiteApi is null"); return; }
-    qDebug() << "MainWindow: Requesting instrument fetch (after delay)...";
-     // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage("Fetching instruments...", 3000);
-    m_kiteApi->fetchAllInstruments();
-}
 
-
-// Handles failure during profile OR margin fetch - Stops sequence, resets labels
+// Handles failure during profile OR margin fetch - resets labels, re-enables login
 void MainWindow::onProfileOrMarginsFailed(const QString& context, const QString& error) {
     qCritical() << "MainWindow: Failed to fetch" << context << ":" << error;
     QMessageBox::critical(this, "API Error", QString("Failed to fetch user %1:\n%2").arg(context).arg(error));
@@ -409,11 +410,12 @@ void MainWindow::onProfileOrMarginsFailed(const QString& context, const QString&
 
 // --- Data Flow Slots ---
 // Handles successful instrument CSV download
-void MainWindow::onInstrumentsFetched(const QString& filePath) {
-    qDebug() << "MainWindow::onInstrumentsFetched: File downloaded to:" << filePath;
+void MainWindow::onInstrumentsFetched(const QVector<InstrumentData>& instruments) {
+    TRACE_ZONE("startup", "MainWindow::onInstrumentsFetched");
+    qDebug() << "MainWindow::onInstrumentsFetched: Parsed instrument rows:" << instruments.size();
      // *** MODIFIED *** Use showStatusMessage
     showStatusMessage("Instruments downloaded. Processing...", 3000);
-    if(m_dataManager) { m_dataManager->loadInstrumentsFromFile(filePath); }
+    if(m_dataManager) { m_dataManager->loadInstruments(instruments); }
     else { /* ... handle error ... */ }
 }
 
@@ -429,6 +431,7 @@ void MainWindow::onInstrumentsFetchFailed(const QString& error) {
 
 // Handles DataManager signal indicating instruments are loaded and ready
 void MainWindow::onDataManagerReady() {
+    TRACE_ZONE("startup", "MainWindow::onDataManagerReady");
     qDebug() << "MainWindow::onDataManagerReady: DataManager reports instruments ready.";
      // *** MODIFIED *** Use showStatusMessage
     showStatusMessage("Instruments processed. Enqueuing data requests...", 3000);
@@ -459,6 +462,19 @@ void MainWindow::onDataManagerReady() {
         ui->statusLabel->setText(QString("User: %1 (%2)").arg(m_userName).arg(m_userId));
     }
 
+    // Without configured groups, keep the filtered instruments' last prices fresh
+    if (m_quotePoller) {
+        if (m_quotePoller->groupNames().isEmpty() && !m_localInstrumentMap.isEmpty()) {
+            QuotePoller::Group watchlist;
+            watchlist.name = "watchlist";
+            watchlist.mode = QuoteData::Ltp;
+            watchlist.intervalMs = 2000;
+            watchlist.instruments = m_localInstrumentMap.keys();
+            m_quotePoller->setGroup(watchlist);
+        }
+        m_quotePoller->start();
+    }
+
     enqueueHistoricalDataRequests();
 
     if (!m_historicalDataRequests.isEmpty()) { startHistoricalDataProcessing(); }
@@ -469,8 +485,8 @@ void MainWindow::onDataManagerReady() {
     }
 }
 
-// Handles historical data success -> schedules NEXT request using constant delay
-void MainWindow::onHistoricalDataReceived(const QString& instrumentToken, const QString& interval, const QJsonArray& candles) {
+// Handles historical data success
+void MainWindow::onHistoricalDataReceived(const QString& instrumentToken, const QString& interval, const QVector<CandleData>& candles) {
     qDebug() << "MainWindow::onHistoricalDataReceived: Notified for" << instrumentToken << interval << "Count:" << candles.size();
     // Update chart if needed...
     int currentInstIndex = ui->instrumentComboBox->currentIndex();
@@ -482,15 +498,13 @@ void MainWindow::onHistoricalDataReceived(const QString& instrumentToken, const
              updateChart();
          }
     }
-    // Schedule the next request
-    if (!m_historicalDataRequests.isEmpty()) {
-        qDebug() << "Scheduling next historical data request after delay (" << API_REQUEST_DELAY_MS << "ms)";
-        QTimer::singleShot(API_REQUEST_DELAY_MS, this, &MainWindow::processNextHistoricalDataRequest);
-    } else {
-        qDebug() << "Historical data queue empty after successful fetch. Stopping.";
-         // *** MODIFIED *** Use showStatusMessage
-        showStatusMessage("Historical data fetching complete.", 5000);
+    if (m_historicalPending > 0 && --m_historicalPending == 0) {
+        qDebug() << "All historical data requests answered.";
+        TRACE_INSTANT("startup", "historical.complete");
+        showStatusMessage(m_historicalFailures ? QString("Historical data fetching complete (%1 errors).").arg(m_historicalFailures)
+                                               : QString("Historical data fetching complete."), 5000);
     }
+    TRACE_COUNTER("historical.pending", m_historicalPending);
 }
 
 // Handles historical data fetch failure
@@ -499,20 +513,18 @@ void MainWindow::onHistoricalDataFailed(const QString& error, const QString& con
      // *** MODIFIED *** Use showStatusMessage
     showStatusMessage(QString("Error fetching data: %1").arg(context), 5000);
 
-    // Schedule the next request even after failure
-    if (!m_historicalDataRequests.isEmpty()) {
-        qWarning() << "Scheduling next historical data request after failure (delay:" << API_REQUEST_DELAY_MS << "ms)";
-        QTimer::singleShot(API_REQUEST_DELAY_MS, this, &MainWindow::processNextHistoricalDataRequest);
-    } else {
-        qDebug() << "Historical data queue empty after failed fetch. Stopping.";
-         // *** MODIFIED *** Use showStatusMessage
-        showStatusMessage("Historical data fetching complete (with errors).", 5000);
+    if (m_historicalPending > 0) {
+        ++m_historicalFailures;
+        if (--m_historicalPending == 0)
+            showStatusMessage(QString("Historical data fetching complete (%1 errors).").arg(m_historicalFailures), 5000);
     }
+    TRACE_COUNTER("historical.pending", m_historicalPending);
 }
 
 // --- Queue Processing ---
 // Fills the historical data request queue based on the filtered local instrument map
 void MainWindow::enqueueHistoricalDataRequests() {
+    TRACE_ZONE("startup", "MainWindow::enqueueHistoricalDataRequests");
     m_historicalDataRequests.clear();
     qDebug() << "Enqueuing historical data requests based on filtered local map (" << m_localInstrumentMap.count() << " instruments)...";
     if (m_localInstrumentMap.isEmpty()) { return; }
@@ -528,7 +540,8 @@ void MainWindow::enqueueHistoricalDataRequests() {
     qDebug() << "Total historical data requests enqueued:" << m_historicalDataRequests.size();
 }
 
-// *** MODIFIED *** Kicks off the first request directly
+// Issues every queued request at once; HttpManager paces them at the historical rate limit
+// behind any quote or order traffic
 void MainWindow::startHistoricalDataProcessing() {
     if (m_historicalDataRequests.isEmpty()) {
         qDebug() << "Historical data request queue is empty. Nothing to start.";
@@ -536,24 +549,30 @@ void MainWindow::startHistoricalDataProcessing() {
         showStatusMessage("Instruments ready. No historical data to fetch.", 3000);
         return;
     }
-    qDebug() << "Starting historical data request sequence...";
+    qDebug() << "Starting historical data requests...";
      // *** MODIFIED *** Use showStatusMessage
     showStatusMessage(QString("Fetching historical data (%1 requests)...").arg(m_historicalDataRequests.size()), 3000);
-    processNextHistoricalDataRequest();
+    m_historicalPending = 0;
+    m_historicalFailures = 0;
+    while (!m_historicalDataRequests.isEmpty())
+        processNextHistoricalDataRequest();
 }
 
-// Processes one historical data request from the queue (called initially and by singleShot timers)
+// Hands one historical data request from the queue to the DataManager
 void MainWindow::processNextHistoricalDataRequest() {
     if (m_historicalDataRequests.isEmpty()) {
         qDebug() << "Historical data queue is empty. Processing finished or nothing to process.";
         return;
     }
+    TRACE_ZONE("startup", "MainWindow::processNextHistoricalDataRequest");
     HistoricalRequestInfo requestInfo = m_historicalDataRequests.dequeue();
+    TRACE_COUNTER("historical.queue", m_historicalDataRequests.size());
     qDebug() << "Processing next historical data request: Token =" << requestInfo.instrumentToken << "Interval =" << requestInfo.interval << "[" << m_historicalDataRequests.size() << "left ]";
-     // *** MODIFIED *** Use showStatusMessage
-    showStatusMessage(QString("Requesting %1 %2 (%3 left)...").arg(requestInfo.instrumentToken).arg(requestInfo.interval).arg(m_historicalDataRequests.size()), 3000);
 
-    if(m_dataManager) { m_dataManager->requestHistoricalData(requestInfo.instrumentToken, requestInfo.interval); }
+    if(m_dataManager) {
+        ++m_historicalPending;
+        m_dataManager->requestHistoricalData(requestInfo.instrumentToken, requestInfo.interval);
+    }
     else {
         qCritical() << "DataManager is null! Cannot process historical data request for" << requestInfo.instrumentToken;
          // *** MODIFIED *** Use showStatusMessage
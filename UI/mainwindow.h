@@ -19,10 +19,12 @@ QT_END_NAMESPACE
 class LoginDialog;
 class KiteConnectAPI;
 class DataManager;
+class QuotePoller;
 class QChartView;
 class QLineSeries;
 
 #include "Data/DataStructures/InstrumentData.h"
+#include "Data/DataStructures/candle.h"
 
 struct HistoricalRequestInfo {
     QString instrumentToken;
@@ -53,30 +55,28 @@ private slots:
     void handleLoginDialogSuccess(const QString& requestToken);
     void handleLoginDialogFailure(const QString& error);
     void handleLoginDialogFinished(int result);
-    void requestUserProfile();
     void onUserProfileReceived(const QJsonObject& profileData);
-    void requestUserMargins();
     void onUserMarginsReceived(const QJsonObject& marginData);
-    void requestInstruments();
     void onProfileOrMarginsFailed(const QString& context, const QString& error);
-    void onInstrumentsFetched(const QString& filePath);
+    void onInstrumentsFetched(const QVector<InstrumentData>& instruments);
     void onInstrumentsFetchFailed(const QString& error);
     void onDataManagerReady();
-    void onHistoricalDataReceived(const QString& instrumentToken, const QString& interval, const QJsonArray& candles);
+    void onHistoricalDataReceived(const QString& instrumentToken, const QString& interval, const QVector<CandleData>& candles);
     void onHistoricalDataFailed(const QString& error, const QString& context);
 
-    // Historical Data Queue Processing Slot (Now called sequentially)
+    // Historical Data Queue Processing Slot (the whole queue is issued at once; HttpManager paces it)
     void processNextHistoricalDataRequest();
 
 private:
     // Helper methods ... (remain the same)
     void setupConnections();
+    void startSessionWorkflow(); // Post-login profile/margins/instruments, fetched concurrently
     // *** MODIFIED *** Renamed for clarity, now uses status bar
     void showStatusMessage(const QString& message, int timeout = 0); // timeout 0 means persistent
     void populateInstrumentCombo();
     void populateIntervalCombo();
     void enqueueHistoricalDataRequests();
-    void startHistoricalDataProcessing(); // Will now just kick off the first request
+    void startHistoricalDataProcessing(); // Issues every queued request
     void resetUserInfo(); // Helper to clear user/funds info
 
     // Member variables ...
@@ -84,9 +84,12 @@ private:
     LoginDialog *m_loginDialog;
     KiteConnectAPI *m_kiteApi;
     DataManager *m_dataManager;
+    QuotePoller *m_quotePoller = nullptr; // Snapshot quotes (configured groups, else the watchlist)
 
     // QTimer *m_historicalDataTimer; // *** REMOVED *** No longer needed as member
     QQueue<HistoricalRequestInfo> m_historicalDataRequests; // Queue remains
+    int m_historicalPending = 0;    // Issued historical requests not yet answered
+    int m_historicalFailures = 0;
     QMap<QString, InstrumentData> m_localInstrumentMap;
 
     // *** ADDED *** Members to store user/account info
@@ -0,0 +1,163 @@
+#include "Utils/black76.h"
+
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+namespace Black76 {
+
+namespace {
+const double kInvSqrt2   = 0.70710678118654752440;
+const double kInvSqrt2Pi = 0.39894228040143267794;
+const double kSqrt2Pi    = 2.50662827463100050242;
+const double kPi         = 3.14159265358979323846;
+const double kMinVol     = 1e-4;
+const double kMaxVol     = 5.0;
+const int    kMaxIter    = 12;
+const double kTolerance  = 1e-9;  // relative price error
+const double kVolStep    = 1e-10; // sigma no longer moving (price at float precision)
+
+inline double clampVol(double s) { return s < kMinVol ? kMinVol : (s > kMaxVol ? kMaxVol : s); }
+
+// Corrado-Miller closed-form guess from the undiscounted out-of-the-money price.
+inline double initialGuess(double otmPrice, double F, double K, double T) {
+    const double callPrice = otmPrice + qMax(0.0, F - K);
+    const double half = 0.5 * (F - K);
+    const double a = callPrice - half;
+    const double disc = a * a - (F - K) * (F - K) / kPi;
+    const double sigmaSqrtT = kSqrt2Pi / (F + K) * (a + std::sqrt(disc > 0.0 ? disc : 0.0));
+    return clampVol(sigmaSqrtT / std::sqrt(T));
+}
+
+// One Halley step on g(sigma) = ln(model / target) for the out-of-the-money option
+// (otmSign = +1 call when K >= F, -1 put otherwise). Working on log price keeps the
+// wings, where prices and vega are tiny, converging as fast as the at-the-money strikes.
+// Returns the updated sigma and writes |g| (relative price error) to err.
+inline double halleyStep(double sigma, double target, double F, double K, double logFK,
+                         double sqrtT, double otmSign, double &err) {
+    const double sv = sigma * sqrtT;
+    const double d1 = logFK / sv + 0.5 * sv;
+    const double d2 = d1 - sv;
+    const double model = otmSign * (F * normCdf(otmSign * d1) - K * normCdf(otmSign * d2));
+    if (!(model > 1e-300)) { err = 1.0; return clampVol(sigma * 2.0); } // underflow: vol far too low
+    const double vega = F * normPdf(d1) * sqrtT;
+    const double g = std::log(model / target);
+    const double g1 = vega / model;
+    const double g2 = vega * d1 * d2 / (sigma * model) - g1 * g1;
+    err = std::fabs(g);
+    if (!(g1 > 1e-300)) return sigma;
+    const double step = g / g1;
+    double denom = 1.0 - 0.5 * step * g2 / g1;
+    if (denom < 0.5) denom = 0.5; // fall back towards Newton when curvature dominates
+    return clampVol(sigma - step / denom);
+}
+} // namespace
+
+double normCdf(double x) { return 0.5 * std::erfc(-x * kInvSqrt2); }
+double normPdf(double x) { return kInvSqrt2Pi * std::exp(-0.5 * x * x); }
+
+double price(double F, double K, double T, double sigma, double r, double sign) {
+    const double df = std::exp(-r * T);
+    if (T <= 0.0 || sigma <= 0.0) return df * qMax(0.0, sign * (F - K));
+    const double sv = sigma * std::sqrt(T);
+    const double d1 = std::log(F / K) / sv + 0.5 * sv;
+    const double d2 = d1 - sv;
+    return df * sign * (F * normCdf(sign * d1) - K * normCdf(sign * d2));
+}
+
+double impliedVol(double optionPrice, double F, double K, double T, double r, double sign, double guess) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (!(F > 0.0) || !(K > 0.0) || !(T > 0.0) || !(optionPrice > 0.0)) return nan;
+    const double target = optionPrice * std::exp(r * T);
+    const double intrinsic = qMax(0.0, sign * (F - K));
+    const double upper = sign > 0 ? F : K;
+    if (target <= intrinsic || target >= upper) return nan;
+
+    const double logFK = std::log(F / K);
+    const double sqrtT = std::sqrt(T);
+    const double otm = target - intrinsic; // parity: ITM price = OTM price + intrinsic
+    const double otmSign = K >= F ? 1.0 : -1.0;
+    double sigma = (guess > 0.0 && qIsFinite(guess)) ? clampVol(guess) : initialGuess(otm, F, K, T);
+    for (int it = 0; it <= kMaxIter; ++it) {
+        double err = 0.0;
+        const double next = halleyStep(sigma, otm, F, K, logFK, sqrtT, otmSign, err);
+        if (err <= kTolerance || std::fabs(next - sigma) <= kVolStep) return sigma;
+        sigma = next;
+    }
+    return nan; // out of iterations without meeting the tolerance
+}
+
+int solveChain(const ChainArrays &c, double F, double T, double r) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const int n = c.n;
+    if (n <= 0) return 0;
+    if (!(F > 0.0) || !(T > 0.0)) {
+        for (int i = 0; i < n; ++i) c.iv[i] = c.delta[i] = c.gamma[i] = c.vega[i] = c.theta[i] = nan;
+        return 0;
+    }
+
+    const double df = std::exp(-r * T);
+    const double growth = 1.0 / df;
+    const double sqrtT = std::sqrt(T);
+    quint8 *active = c.scratch;
+    // Per-strike constants of the iteration, kept in output columns that pass 3 overwrites.
+    double *logFK = c.delta;
+    double *otmTarget = c.gamma;
+
+    // Pass 1: validate against no-arbitrage bounds and seed sigma (warm or Corrado-Miller).
+    int pending = 0;
+    for (int i = 0; i < n; ++i) {
+        const double K = c.strike[i], s = c.sign[i];
+        const double target = c.price[i] * growth;
+        const double intrinsic = qMax(0.0, s * (F - K));
+        const double upper = s > 0 ? F : K;
+        const bool ok = K > 0.0 && target > intrinsic && target < upper;
+        const double prev = c.iv[i];
+        const double seed = (prev > 0.0 && prev < kMaxVol) ? prev : initialGuess(target - intrinsic, F, K, T);
+        c.iv[i] = ok ? seed : nan;
+        logFK[i] = ok ? std::log(F / K) : 0.0;
+        otmTarget[i] = target - intrinsic; // parity: ITM price = OTM price + intrinsic
+        active[i] = ok ? 1 : 0;
+        pending += ok ? 1 : 0;
+    }
+
+    // Pass 2: Halley iterations over the strikes still moving; a warm start usually settles in 1-2.
+    // The extra round only checks the last step: strikes still active after it did not converge.
+    for (int it = 0; it <= kMaxIter && pending > 0; ++it) {
+        pending = 0;
+        for (int i = 0; i < n; ++i) {
+            if (!active[i]) continue;
+            const double K = c.strike[i];
+            double err = 0.0;
+            const double next = halleyStep(c.iv[i], otmTarget[i], F, K, logFK[i],
+                                           sqrtT, K >= F ? 1.0 : -1.0, err);
+            const bool step = !(err <= kTolerance) && std::fabs(next - c.iv[i]) > kVolStep;
+            c.iv[i] = step ? next : c.iv[i];
+            active[i] = step ? 1 : 0;
+            pending += step ? 1 : 0;
+        }
+    }
+    for (int i = 0; i < n; ++i)
+        if (active[i]) c.iv[i] = nan;
+
+    // Pass 3: Greeks from the solved vols.
+    int solved = 0;
+    for (int i = 0; i < n; ++i) {
+        const double sigma = c.iv[i];
+        const double K = c.strike[i], s = c.sign[i];
+        const double sv = sigma * sqrtT;
+        const double d1 = logFK[i] / sv + 0.5 * sv;
+        const double d2 = d1 - sv;
+        const double pdf = normPdf(d1);
+        const double value = df * s * (F * normCdf(s * d1) - K * normCdf(s * d2));
+        const bool ok = qIsFinite(sigma);
+        c.delta[i] = ok ? s * df * normCdf(s * d1) : nan;
+        c.gamma[i] = ok ? df * pdf / (F * sv) : nan;
+        c.vega[i]  = ok ? df * F * pdf * sqrtT * 0.01 : nan;
+        c.theta[i] = ok ? (r * value - df * F * pdf * sigma / (2.0 * sqrtT)) / 365.0 : nan;
+        solved += ok ? 1 : 0;
+    }
+    return solved;
+}
+
+} // namespace Black76
@@ -0,0 +1,44 @@
+#ifndef BLACK76_H
+#define BLACK76_H
+
+#include <QtGlobal>
+
+// Black-76 pricing, Greeks and implied volatility for options on futures.
+// All inputs are per-annum (T in years, r continuously compounded); sign = +1 call, -1 put.
+namespace Black76 {
+
+double normCdf(double x);
+double normPdf(double x);
+
+double price(double F, double K, double T, double sigma, double r, double sign);
+
+// Single-contract implied vol. guess <= 0 (or NaN) means cold start.
+// Returns NaN when the price is outside the no-arbitrage bounds or the solver does not converge.
+double impliedVol(double optionPrice, double F, double K, double T, double r, double sign,
+                  double guess = 0.0);
+
+// Structure-of-arrays chain kernel: solves IV and computes Greeks for n strikes that share
+// one forward and one expiry. Per-strike constants (ln(F/K), target price) are computed once;
+// the loops call erfc/exp/log, so they run scalar.
+//   iv      in: previous IV (warm start; <= 0 or NaN = cold), out: solved IV (NaN if unsolvable
+//           or not converged within the iteration limit; its Greeks are NaN too)
+//   vega    per 1.00 vol point (0.01 change in sigma)
+//   theta   per calendar day
+// scratch must hold n bytes. Returns the number of contracts with a valid IV.
+struct ChainArrays {
+    int n = 0;
+    const double *strike = nullptr;
+    const double *sign = nullptr;
+    const double *price = nullptr;
+    double *iv = nullptr;
+    double *delta = nullptr;
+    double *gamma = nullptr;
+    double *vega = nullptr;
+    double *theta = nullptr;
+    quint8 *scratch = nullptr;
+};
+int solveChain(const ChainArrays &c, double F, double T, double r);
+
+} // namespace Black76
+
+#endif // BLACK76_H
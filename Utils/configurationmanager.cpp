@@ -78,6 +78,11 @@ QString ConfigurationManager::getApiSecret() const
     return m_configData["api_secret"].toString();
 }
 
+QStringList ConfigurationManager::getStrategyNames() const
+{
+    return m_configData["strategies"].toObject().keys();
+}
+
 QJsonObject ConfigurationManager::getStrategyConfig(const QString &strategyName) const
 {
     return m_configData["strategies"].toObject()[strategyName].toObject();
@@ -88,6 +93,16 @@ QJsonObject ConfigurationManager::getRiskParameters() const
     return m_configData["risk_parameters"].toObject();
 }
 
+QJsonObject ConfigurationManager::getQuotePollingConfig() const
+{
+    return m_configData["quote_polling"].toObject();
+}
+
+QJsonObject ConfigurationManager::getHttpConfig() const
+{
+    return m_configData["http"].toObject();
+}
+
 QJsonArray ConfigurationManager::getHolidays() const
 {
     return m_configData["holidays"].toArray();
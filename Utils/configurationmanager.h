@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
@@ -19,8 +20,11 @@ public:
 
     QString getApiKey() const;
     QString getApiSecret() const;
+    QStringList getStrategyNames() const;
     QJsonObject getStrategyConfig(const QString &strategyName) const;
     QJsonObject getRiskParameters() const;
+    QJsonObject getQuotePollingConfig() const;
+    QJsonObject getHttpConfig() const;
     QJsonArray getHolidays() const;
     void setHolidays(const QJsonArray &holidays);
     QString getAccessToken() const;
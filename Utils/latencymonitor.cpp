@@ -0,0 +1,156 @@
+#include "Utils/latencymonitor.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QDebug>
+#include <QtAlgorithms>
+
+// ---------- histogram ----------
+LatencyHistogram::LatencyHistogram(const QString &name)
+    : m_name(name)
+{
+    for (auto &b : m_buckets) b.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketFor(quint64 v)
+{
+    const int msb = v ? 63 - int(qCountLeadingZeroBits(v)) : 0;
+    const int shift = qMax(0, msb - (kSubBits - 1));
+    return shift * kHalf + int(v >> shift);
+}
+
+qint64 LatencyHistogram::bucketValue(int index)
+{
+    if (index < 2 * kHalf) return index;
+    const int shift = index / kHalf - 1;
+    const quint64 lower = quint64(index - shift * kHalf) << shift;
+    return qint64(lower + (quint64(1) << shift) / 2);
+}
+
+void LatencyHistogram::record(qint64 nanos)
+{
+    const quint64 v = nanos > 0 ? quint64(nanos) : 0;
+    m_buckets[bucketFor(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(v, std::memory_order_relaxed);
+    qint64 seen = m_max.load(std::memory_order_relaxed);
+    while (qint64(v) > seen && !m_max.compare_exchange_weak(seen, qint64(v), std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &b : m_buckets) b.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::meanNanos() const
+{
+    const quint64 n = count();
+    return n ? double(m_sum.load(std::memory_order_relaxed)) / double(n) : 0.0;
+}
+
+qint64 LatencyHistogram::percentileNanos(double q) const
+{
+    // Count from the buckets themselves: m_count may run ahead of them mid-record.
+    quint64 total = 0;
+    for (const auto &b : m_buckets) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+
+    const quint64 rank = qMax<quint64>(1, quint64(qBound(0.0, q, 1.0) * double(total) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return qMin(bucketValue(i), maxNanos());
+    }
+    return maxNanos();
+}
+
+// ---------- monitor ----------
+LatencyMonitor* LatencyMonitor::m_instance = nullptr;
+
+LatencyMonitor* LatencyMonitor::instance()
+{
+    // Stages are timed from worker threads too; construct exactly once.
+    static LatencyMonitor *self = (m_instance = new LatencyMonitor());
+    return self;
+}
+
+LatencyMonitor::LatencyMonitor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LatencyHistogram *LatencyMonitor::stage(const QString &name)
+{
+    QMutexLocker lock(&m_mutex);
+    for (LatencyHistogram *h : m_stages)
+        if (h->name() == name) return h;
+    auto *h = new LatencyHistogram(name);
+    m_stages.append(h);
+    return h;
+}
+
+QString LatencyMonitor::report() const
+{
+    QVector<LatencyHistogram*> stages;
+    {
+        QMutexLocker lock(&m_mutex);
+        stages = m_stages;
+    }
+
+    auto us = [](qint64 ns) { return QString::number(double(ns) / 1000.0, 'f', 1); };
+    QString out;
+    QTextStream ts(&out);
+    ts << QString("%1 %2 %3 %4 %5 %6 %7 %8  (us)\n")
+              .arg("stage", -28).arg("count", 9).arg("mean", 10).arg("p50", 10)
+              .arg("p90", 10).arg("p99", 10).arg("p99.9", 10).arg("max", 10);
+    for (const LatencyHistogram *h : stages) {
+        if (h->count() == 0) continue;
+        ts << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                  .arg(h->name(), -28).arg(h->count(), 9)
+                  .arg(us(qint64(h->meanNanos())), 10)
+                  .arg(us(h->percentileNanos(0.50)), 10)
+                  .arg(us(h->percentileNanos(0.90)), 10)
+                  .arg(us(h->percentileNanos(0.99)), 10)
+                  .arg(us(h->percentileNanos(0.999)), 10)
+                  .arg(us(h->maxNanos()), 10);
+    }
+    ts.flush();
+    return out;
+}
+
+bool LatencyMonitor::dumpToFile(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "LatencyMonitor: cannot open" << filePath;
+        return false;
+    }
+    QTextStream ts(&file);
+    ts << "=== Latency " << QDateTime::currentDateTime().toString(Qt::ISODate) << " ===\n"
+       << report() << "\n";
+    return true;
+}
+
+void LatencyMonitor::startPeriodicDump(const QString &filePath, int intervalSeconds)
+{
+    m_dumpPath = filePath;
+    if (!m_dumpTimer) {
+        m_dumpTimer = new QTimer(this);
+        connect(m_dumpTimer, &QTimer::timeout, this, [this]() { dumpToFile(m_dumpPath); });
+    }
+    m_dumpTimer->start(qMax(1, intervalSeconds) * 1000);
+}
+
+void LatencyMonitor::resetAll()
+{
+    QMutexLocker lock(&m_mutex);
+    for (LatencyHistogram *h : m_stages) h->reset();
+}
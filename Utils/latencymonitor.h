@@ -0,0 +1,111 @@
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QTimer>
+#include <atomic>
+#include <chrono>
+
+// Log-linear (HDR-style) latency histogram in nanoseconds.
+//
+// Values below 2^kSubBits land in exact buckets; above that every power of two is split into
+// 2^(kSubBits-1) = 64 linear sub-buckets, so any recorded value is reported within ~1.6%.
+// Recording is three relaxed atomic adds plus a max update: safe from any thread, no locks.
+class LatencyHistogram
+{
+public:
+    explicit LatencyHistogram(const QString &name = QString());
+
+    QString name() const { return m_name; }
+    void record(qint64 nanos);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double meanNanos() const;
+    qint64 maxNanos() const { return m_max.load(std::memory_order_relaxed); }
+    // q in [0, 1]; 0 when empty. Taken from a consistent-enough snapshot of the buckets.
+    qint64 percentileNanos(double q) const;
+
+private:
+    static const int kSubBits = 7;
+    static const int kHalf = 1 << (kSubBits - 1);
+    static const int kBuckets = (64 - kSubBits + 2) * kHalf;
+
+    static int bucketFor(quint64 v);
+    static qint64 bucketValue(int index); // representative (mid-point) value
+
+    QString m_name;
+    std::atomic<quint64> m_buckets[kBuckets];
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sum{0};
+    std::atomic<qint64> m_max{0};
+};
+
+// Records the lifetime of a scope into a histogram.
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram *h)
+        : m_hist(h), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        m_hist->record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - m_start).count());
+    }
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+    LatencyHistogram *m_hist;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Per-stage latency histograms for the data pipeline (HTTP round trip per request type, JSON
+// decode, merge, each analytics step). Stages are created on first use and live for the whole
+// run; the report lists count, mean and p50/p90/p99/p99.9/max per stage in microseconds.
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static LatencyMonitor* instance();
+
+    // Stable pointer; cache it (LATENCY_SCOPE does) rather than looking it up per call.
+    LatencyHistogram *stage(const QString &name);
+
+    QString report() const;
+    // Appends a timestamped report to filePath.
+    bool dumpToFile(const QString &filePath) const;
+    void startPeriodicDump(const QString &filePath, int intervalSeconds);
+    void resetAll();
+
+    static qint64 nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    explicit LatencyMonitor(QObject *parent = nullptr);
+
+    static LatencyMonitor* m_instance;
+    mutable QMutex m_mutex;
+    QVector<LatencyHistogram*> m_stages; // never freed: pointers are cached by callers
+    QTimer *m_dumpTimer = nullptr;
+    QString m_dumpPath;
+};
+
+// LATENCY_SCOPE("stage.name") times the rest of the enclosing scope. Define QPX_NO_LATENCY to
+// compile all timers out.
+#ifdef QPX_NO_LATENCY
+#  define LATENCY_SCOPE(name) do {} while (0)
+#else
+#  define QPX_LATENCY_CAT2(a, b) a##b
+#  define QPX_LATENCY_CAT(a, b) QPX_LATENCY_CAT2(a, b)
+#  define LATENCY_SCOPE(name) \
+    static LatencyHistogram *const QPX_LATENCY_CAT(qpxLatencyHist_, __LINE__) = LatencyMonitor::instance()->stage(name); \
+    ScopedLatency QPX_LATENCY_CAT(qpxLatencyScope_, __LINE__)(QPX_LATENCY_CAT(qpxLatencyHist_, __LINE__))
+#endif
+
+#endif // LATENCYMONITOR_H
@@ -0,0 +1,222 @@
+#include "Utils/logger.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+std::atomic<quint32> g_nextThread{1};
+thread_local void *t_ring = nullptr;
+thread_local bool t_exited = false;     // set once the thread's ring is retired
+
+const char *levelTag(Log::Level level)
+{
+    switch (level) {
+    case Log::Level::Trace:   return "T";
+    case Log::Level::Debug:   return "D";
+    case Log::Level::Info:    return "I";
+    case Log::Level::Warning: return "W";
+    case Log::Level::Error:   return "E";
+    }
+    return "?";
+}
+}
+
+// ---------- singleton ----------
+Logger* Logger::instance()
+{
+    // Thread-safe construction on first use; intentionally never destroyed so threads that log
+    // during shutdown never see a dead logger (call stop() to flush).
+    static Logger *self = new Logger();
+    return self;
+}
+
+void Logger::start(const QString &filePath)
+{
+    if (m_running.exchange(true)) return;
+    m_filePath = filePath;
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    m_writer = std::thread([this] { writerLoop(); });
+}
+
+void Logger::stop()
+{
+    if (!m_running.exchange(false)) return;
+    if (m_writer.joinable()) m_writer.join();
+}
+
+// ---------- producer side ----------
+// Retires the calling thread's ring when the thread exits
+struct RingRetirer {
+    ~RingRetirer() {
+        if (t_ring) static_cast<Logger::Ring*>(t_ring)->retired.store(true, std::memory_order_release);
+        t_ring = nullptr;
+        t_exited = true;
+    }
+};
+
+Logger::Ring *Logger::threadRing()
+{
+    if (!t_ring) {
+        // Logging from thread-exit code after the retirer ran: drop rather than leak a new ring
+        if (t_exited) return nullptr;
+        static thread_local RingRetirer retirer;
+        (void)retirer;
+        Ring *ring = new Ring;
+        ring->thread = g_nextThread.fetch_add(1, std::memory_order_relaxed);
+        Logger *self = instance();
+        QMutexLocker lock(&self->m_ringsMutex);
+        self->m_rings.append(ring);
+        t_ring = ring;
+    }
+    return static_cast<Ring*>(t_ring);
+}
+
+Logger::Record *Logger::beginRecord(Log::Level level, const char *format)
+{
+    Ring *ring = threadRing();
+    if (!ring) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    const quint32 head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= quint32(kRingSize)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Record *r = &ring->records[head & (kRingSize - 1)];
+    r->timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+    r->format = format;
+    r->thread = ring->thread;
+    r->level = level;
+    r->argCount = 0;
+    r->textUsed = 0;
+    return r;
+}
+
+void Logger::commitRecord()
+{
+    Ring *ring = static_cast<Ring*>(t_ring);
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Logger::encodeText(Record &r, int i, ArgType type, const void *data, int bytes)
+{
+    if (type == ArgType::Utf16 && (r.textUsed & 1)) ++r.textUsed; // keep UTF-16 text aligned
+    int n = qMin(bytes, kTextBytes - int(r.textUsed));
+    if (type == ArgType::Utf16) n &= ~1;
+    if (n < 0) n = 0;
+    if (n > 0) std::memcpy(r.text + r.textUsed, data, size_t(n));
+    r.args[i].type = type;
+    r.args[i].offset = r.textUsed;
+    r.args[i].length = quint16(n);
+    r.textUsed = quint16(r.textUsed + n);
+}
+
+// ---------- writer thread ----------
+int Logger::drain(QVector<Record> &out)
+{
+    QVector<Ring*> rings;
+    {
+        QMutexLocker lock(&m_ringsMutex);
+        rings = m_rings;
+    }
+    int count = 0;
+    QVector<Ring*> retired;
+    for (Ring *ring : rings) {
+        // Read before head: once set, the producer is gone and head is final
+        const bool exited = ring->retired.load(std::memory_order_acquire);
+        quint32 tail = ring->tail.load(std::memory_order_relaxed);
+        const quint32 head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail, ++count)
+            out.append(ring->records[tail & (kRingSize - 1)]);
+        ring->tail.store(tail, std::memory_order_release);
+        if (exited) retired.append(ring);
+    }
+    if (!retired.isEmpty()) {
+        {
+            QMutexLocker lock(&m_ringsMutex);
+            for (Ring *ring : std::as_const(retired)) m_rings.removeOne(ring);
+        }
+        qDeleteAll(retired);
+    }
+    return count;
+}
+
+void Logger::writerLoop()
+{
+    QFile file(m_filePath);
+    const bool open = file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    QVector<Record> batch;
+    quint64 reportedDrops = 0;
+
+    for (;;) {
+        const bool running = m_running.load(std::memory_order_acquire);
+        batch.clear();
+        if (drain(batch) == 0) {
+            if (!running) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        // Rings are drained one after another; restore a single time order across threads.
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const Record &a, const Record &b) { return a.timeMs < b.timeMs; });
+
+        QByteArray out;
+        for (const Record &r : batch) {
+            out += format(r).toUtf8();
+            out += '\n';
+        }
+        const quint64 dropped = droppedRecords();
+        if (dropped != reportedDrops) {
+            out += QByteArray("logger: ") + QByteArray::number(dropped - reportedDrops) + " records dropped (ring full)\n";
+            reportedDrops = dropped;
+        }
+        if (open) {
+            file.write(out);
+            file.flush();
+        }
+    }
+}
+
+QString Logger::format(const Record &r)
+{
+    QString line = QDateTime::fromMSecsSinceEpoch(r.timeMs).toString("yyyy-MM-dd HH:mm:ss.zzz");
+    line += QString(" %1 [T%2] ").arg(QLatin1String(levelTag(r.level))).arg(r.thread);
+
+    int next = 0;
+    for (const char *p = r.format; p && *p; ++p) {
+        if (*p != '{') { line += QLatin1Char(*p); continue; }
+        const char *close = std::strchr(p, '}');
+        if (!close) { line += QLatin1String(p); break; }
+
+        // Optional "{:.Nf}" precision for doubles.
+        int precision = -1;
+        if (p[1] == ':' && p[2] == '.') precision = std::atoi(p + 3);
+        p = close;
+        if (next >= r.argCount) { line += QLatin1String("{}"); continue; }
+
+        const Arg &a = r.args[next++];
+        switch (a.type) {
+        case ArgType::Int:      line += QString::number(a.i); break;
+        case ArgType::UInt:     line += QString::number(a.u); break;
+        case ArgType::Double:
+            line += precision >= 0 ? QString::number(a.d, 'f', precision) : QString::number(a.d, 'g', 10);
+            break;
+        case ArgType::Bool:     line += QLatin1String(a.i ? "true" : "false"); break;
+        case ArgType::DateTime: line += QDateTime::fromMSecsSinceEpoch(a.i).toString(Qt::ISODateWithMs); break;
+        case ArgType::Latin1:   line += QString::fromLatin1(r.text + a.offset, a.length); break;
+        case ArgType::Utf16:
+            line += QString(reinterpret_cast<const QChar*>(r.text + a.offset), a.length / 2);
+            break;
+        }
+    }
+    return line;
+}
@@ -0,0 +1,152 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Asynchronous logger for the data path.
+//
+// A log statement copies its arguments into a fixed-size binary record in the calling thread's
+// lock-free ring (single producer, single consumer) and returns: no formatting, no allocation,
+// no file I/O. A background thread drains every ring, formats records and appends them to
+// Logs/QphoeniX.log. When a ring is full the record is dropped and counted. A thread's ring is
+// retired when the thread exits and freed by the writer once drained.
+//
+// Formats use "{}" placeholders, or "{:.2f}" for fixed-point doubles. Format strings must be
+// literals (only the pointer is stored); string arguments are copied, truncated to fit.
+//
+//   LOG_DEBUG("historical {} {} -> {} candles", token, interval, candles.size());
+//
+// Statements below QPX_LOG_MIN_LEVEL compile to nothing (arguments are not evaluated).
+
+namespace Log {
+enum class Level : quint8 { Trace = 0, Debug = 1, Info = 2, Warning = 3, Error = 4 };
+}
+
+#ifndef QPX_LOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define QPX_LOG_MIN_LEVEL 2 // Info
+#  else
+#    define QPX_LOG_MIN_LEVEL 1 // Debug
+#  endif
+#endif
+
+#define QPX_LOG(level, ...) \
+    do { if constexpr (Logger::enabled(level)) Logger::write(level, __VA_ARGS__); } while (0)
+#define LOG_TRACE(...) QPX_LOG(Log::Level::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) QPX_LOG(Log::Level::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  QPX_LOG(Log::Level::Info, __VA_ARGS__)
+#define LOG_WARN(...)  QPX_LOG(Log::Level::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) QPX_LOG(Log::Level::Error, __VA_ARGS__)
+
+class Logger
+{
+public:
+    static Logger* instance();
+
+    // Starts the writer thread (appending to filePath). Records logged before start() are
+    // kept in the rings and written once it runs.
+    void start(const QString &filePath = "Logs/QphoeniX.log");
+    // Drains everything still queued, then joins the writer thread.
+    void stop();
+
+    quint64 droppedRecords() const { return m_dropped.load(std::memory_order_relaxed); }
+    // For work done only to feed a log statement: if constexpr (Logger::enabled(...)) { ... }
+    static constexpr bool enabled(Log::Level level) { return int(level) >= QPX_LOG_MIN_LEVEL; }
+
+    template <typename... Args>
+    static void write(Log::Level level, const char *format, const Args&... args);
+
+private:
+    static const int kMaxArgs = 8;
+    static const int kTextBytes = 104;
+    static const int kRingSize = 2048;  // records per thread, power of two
+
+    enum class ArgType : quint8 { Int, UInt, Double, Bool, Latin1, Utf16, DateTime };
+    struct Arg {
+        ArgType type;
+        quint8 pad;
+        quint16 offset;     // text args: byte offset into Record::text
+        quint16 length;     // text args: byte length
+        union { qint64 i; quint64 u; double d; };
+    };
+    struct Record {         // 256 bytes
+        qint64 timeMs;
+        const char *format;
+        quint32 thread;
+        Log::Level level;
+        quint8 argCount;
+        quint16 textUsed;
+        Arg args[kMaxArgs];
+        char text[kTextBytes];
+    };
+    struct Ring {
+        quint32 thread = 0;
+        std::atomic<quint32> head{0};   // next write (producer)
+        std::atomic<quint32> tail{0};   // next read (consumer)
+        std::atomic<bool> retired{false}; // owning thread has exited; freed once drained
+        Record records[kRingSize];
+    };
+
+    Logger() = default;
+
+    static Ring *threadRing();
+    friend struct RingRetirer;
+    Record *beginRecord(Log::Level level, const char *format);
+    void commitRecord();
+
+    static void encode(Record &r, int i, qint64 v)          { r.args[i].type = ArgType::Int; r.args[i].i = v; }
+    static void encode(Record &r, int i, double v)          { r.args[i].type = ArgType::Double; r.args[i].d = v; }
+    static void encode(Record &r, int i, bool v)            { r.args[i].type = ArgType::Bool; r.args[i].i = v; }
+    static void encode(Record &r, int i, const QDateTime &v) { r.args[i].type = ArgType::DateTime; r.args[i].i = v.toMSecsSinceEpoch(); }
+    static void encode(Record &r, int i, const QString &v)  { encodeText(r, i, ArgType::Utf16, v.constData(), v.size() * 2); }
+    static void encode(Record &r, int i, const QByteArray &v) { encodeText(r, i, ArgType::Latin1, v.constData(), v.size()); }
+    static void encode(Record &r, int i, const char *v)     { encodeText(r, i, ArgType::Latin1, v, v ? int(std::strlen(v)) : 0); }
+    template <typename T>
+    static void encode(Record &r, int i, const T &v) {
+        if constexpr (std::is_enum_v<T>) {
+            encode(r, i, qint64(v));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            encode(r, i, double(v));
+        } else if constexpr (std::is_unsigned_v<T>) {
+            r.args[i].type = ArgType::UInt; r.args[i].u = quint64(v);
+        } else {
+            static_assert(std::is_integral_v<T>, "Logger: unsupported argument type");
+            encode(r, i, qint64(v));
+        }
+    }
+    static void encodeText(Record &r, int i, ArgType type, const void *data, int bytes);
+
+    void writerLoop();
+    int drain(QVector<Record> &out);
+    static QString format(const Record &r);
+
+    QMutex m_ringsMutex;
+    QVector<Ring*> m_rings;
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<bool> m_running{false};
+    std::thread m_writer;
+    QString m_filePath;
+};
+
+template <typename... Args>
+void Logger::write(Log::Level level, const char *format, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= kMaxArgs, "Logger: too many arguments");
+    Logger *self = instance();
+    Record *r = self->beginRecord(level, format);
+    if (!r) return;
+    r->argCount = quint8(sizeof...(Args));
+    int i = 0;
+    (encode(*r, i++, args), ...);
+    self->commitRecord();
+}
+
+#endif // LOGGER_H
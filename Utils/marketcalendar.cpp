@@ -15,6 +15,12 @@
 
 MarketCalendar* MarketCalendar::m_instance = nullptr;
 
+namespace {
+const qint64 kIstOffsetMs = 19800000;  // +05:30
+const qint64 kMsPerDay = 86400000;
+const qint64 kUnixEpochJulianDay = 2440588;
+}
+
 MarketCalendar* MarketCalendar::instance()
 {
     if (!m_instance) {
@@ -268,3 +274,17 @@ QDate MarketCalendar::getPreviousTradingDay(const QDate &currentDate) const
     return QDate(); // Return invalid date if not found within limit
 }
 // --- End Added Implementation ---
+
+QDate MarketCalendar::tradingDateFor(const QDateTime &timestamp) const
+{
+    if (!timestamp.isValid()) return QDate();
+    const qint64 local = timestamp.toMSecsSinceEpoch() + kIstOffsetMs;
+    const qint64 day = local >= 0 ? local / kMsPerDay : (local - kMsPerDay + 1) / kMsPerDay;
+    return QDate::fromJulianDay(kUnixEpochJulianDay + day);
+}
+
+qint64 MarketCalendar::sessionEndMsecs(const QDate &tradingDate) const
+{
+    if (!tradingDate.isValid()) return 0;
+    return (tradingDate.toJulianDay() - kUnixEpochJulianDay + 1) * kMsPerDay - kIstOffsetMs;
+}
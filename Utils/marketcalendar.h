@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QDate>
 #include <QTime>
+#include <QDateTime>
 #include <QList>
 #include <QMap>
 #include <QNetworkAccessManager> // For fetching holidays
@@ -26,6 +27,12 @@ public:
     QDate getLastThursdayOfMonth(int year, int month) const;
     QDate getPreviousTradingDay(const QDate &currentDate) const;
 
+    // Session keys for streaming calculations: the IST trading date a timestamp belongs to, and
+    // the epoch-ms at which that date's session ends (next IST midnight, exclusive). Pure
+    // arithmetic on msecsSinceEpoch, so callers can roll sessions with one integer compare.
+    QDate tradingDateFor(const QDateTime &timestamp) const;
+    qint64 sessionEndMsecs(const QDate &tradingDate) const;
+
 signals:
     void holidaysUpdated();
 
@@ -0,0 +1,114 @@
+#include "Utils/realizedvol.h"
+#include "Utils/ta_simple.h"
+
+#include <QtMath>
+
+namespace TA {
+
+namespace {
+const double kFourLn2 = 4.0 * 0.69314718055994530942;
+const double kGkCoef = 2.0 * 0.69314718055994530942 - 1.0;
+
+// Sample variance of a window from its sum and sum of squares.
+inline double sampleVar(double s, double s2, int n) {
+    if (n < 2) return NaN();
+    const double v = (s2 - s * s / n) / (n - 1);
+    return v > 0.0 ? v : 0.0;
+}
+}
+
+// ---------- build ----------
+void RealizedVol::build(const QVector<CandleData> &bars)
+{
+    const int n = bars.size();
+    for (QVector<double> *v : { &m_ret, &m_ret2, &m_on, &m_on2, &m_oc, &m_oc2, &m_pk, &m_gk, &m_rs }) {
+        v->clear();
+        v->reserve(n + 1);
+        v->append(0.0);
+    }
+    for (QVector<int> *v : { &m_badBar, &m_badRet }) {
+        v->clear();
+        v->reserve(n + 1);
+        v->append(0);
+    }
+    m_prevClose = 0.0;
+    m_count = 0;
+    for (const auto &b : bars) append(b);
+}
+
+void RealizedVol::append(const CandleData &b)
+{
+    if (m_ret.isEmpty()) build({});
+
+    const bool barOk = b.open > 0.0 && b.high > 0.0 && b.low > 0.0 && b.close > 0.0 && b.high >= b.low;
+    const bool retOk = b.close > 0.0 && m_prevClose > 0.0;
+
+    double r = 0.0, on = 0.0, oc = 0.0, pk = 0.0, gk = 0.0, rs = 0.0;
+    if (barOk) {
+        const double hl = qLn(b.high / b.low);
+        oc = qLn(b.close / b.open);
+        pk = hl * hl / kFourLn2;
+        gk = 0.5 * hl * hl - kGkCoef * oc * oc;
+        rs = qLn(b.high / b.close) * qLn(b.high / b.open) + qLn(b.low / b.close) * qLn(b.low / b.open);
+    }
+    if (retOk) r = qLn(b.close / m_prevClose);
+    if (retOk && barOk) on = qLn(b.open / m_prevClose);
+
+    m_ret.append(m_ret.last() + r);
+    m_ret2.append(m_ret2.last() + r * r);
+    m_on.append(m_on.last() + on);
+    m_on2.append(m_on2.last() + on * on);
+    m_oc.append(m_oc.last() + oc);
+    m_oc2.append(m_oc2.last() + oc * oc);
+    m_pk.append(m_pk.last() + pk);
+    m_gk.append(m_gk.last() + gk);
+    m_rs.append(m_rs.last() + rs);
+    m_badBar.append(m_badBar.last() + (barOk ? 0 : 1));
+    m_badRet.append(m_badRet.last() + (retOk ? 0 : 1));
+
+    m_prevClose = (b.close > 0.0) ? b.close : 0.0;
+    ++m_count;
+}
+
+// ---------- queries ----------
+double RealizedVol::value(Estimator e, int end, int lookback) const
+{
+    if (lookback < 1 || end < 0 || end >= m_count) return NaN();
+    const int hi = end + 1;           // prefix index one past the window
+    const int lo = hi - lookback;     // prefix index of the first bar in the window
+    if (lo < 0) return NaN();
+    auto sum = [lo, hi](const QVector<double> &p) { return p[hi] - p[lo]; };
+    const bool barsOk = m_badBar[hi] == m_badBar[lo];
+    // Return-based terms need the close before the window too.
+    const bool retsOk = lo >= 1 && m_badRet[hi] == m_badRet[lo];
+
+    switch (e) {
+    case Estimator::CloseToClose:
+        if (!retsOk) return NaN();
+        return qSqrt(sampleVar(sum(m_ret), sum(m_ret2), lookback));
+    case Estimator::Parkinson:
+        return barsOk ? qSqrt(sum(m_pk) / lookback) : NaN();
+    case Estimator::GarmanKlass:
+        return barsOk ? qSqrt(qMax(0.0, sum(m_gk) / lookback)) : NaN();
+    case Estimator::RogersSatchell:
+        return barsOk ? qSqrt(qMax(0.0, sum(m_rs) / lookback)) : NaN();
+    case Estimator::YangZhang: {
+        if (!barsOk || !retsOk || lookback < 2) return NaN();
+        const double k = 0.34 / (1.34 + double(lookback + 1) / (lookback - 1));
+        const double varOn = sampleVar(sum(m_on), sum(m_on2), lookback);
+        const double varOc = sampleVar(sum(m_oc), sum(m_oc2), lookback);
+        const double varRs = qMax(0.0, sum(m_rs) / lookback);
+        return qSqrt(varOn + k * varOc + (1.0 - k) * varRs);
+    }
+    }
+    return NaN();
+}
+
+QVector<double> RealizedVol::series(Estimator e, int lookback) const
+{
+    QVector<double> out(m_count, NaN());
+    for (int i = 0; i < m_count; ++i) out[i] = value(e, i, lookback);
+    return out;
+}
+
+} // namespace TA
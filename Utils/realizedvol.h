@@ -0,0 +1,56 @@
+#ifndef REALIZEDVOL_H
+#define REALIZEDVOL_H
+
+#include <QVector>
+
+#include "Data/DataStructures/candle.h"
+
+namespace TA {
+
+// Realized volatility estimators over OHLC bars, built in one pass.
+//
+// build() stores prefix sums of the per-bar terms, so any estimator over any lookback ending at
+// any bar is O(1), and a full series is O(n) regardless of how many horizons are requested.
+// Values are per-bar (not annualized) standard deviations, matching the close-to-close
+// volatility DataManager has always used. A window touching a bar with unusable prices
+// (<= 0, or high < low) yields NaN.
+class RealizedVol
+{
+public:
+    enum class Estimator {
+        CloseToClose,   // sample std dev of ln(C_i / C_{i-1})
+        Parkinson,      // high/low range
+        GarmanKlass,    // OHLC, no drift
+        RogersSatchell, // OHLC, drift independent
+        YangZhang       // overnight + open-to-close + Rogers-Satchell
+    };
+
+    RealizedVol() = default;
+    explicit RealizedVol(const QVector<CandleData> &bars) { build(bars); }
+
+    void build(const QVector<CandleData> &bars);
+    // Appends one bar in O(1) (e.g. today's completed daily candle).
+    void append(const CandleData &bar);
+
+    int size() const { return m_count; }
+
+    // Estimate over the `lookback` bars ending at index `end` (inclusive).
+    double value(Estimator e, int end, int lookback) const;
+    double latest(Estimator e, int lookback) const { return value(e, m_count - 1, lookback); }
+    // Full series (NaN until enough bars). O(n).
+    QVector<double> series(Estimator e, int lookback) const;
+
+private:
+    // Prefix arrays have size() + 1 entries; entry i covers bars [0, i).
+    QVector<double> m_ret, m_ret2;         // close-to-close log return and its square
+    QVector<double> m_on, m_on2;           // overnight ln(O_i / C_{i-1})
+    QVector<double> m_oc, m_oc2;           // open-to-close ln(C_i / O_i)
+    QVector<double> m_pk, m_gk, m_rs;      // per-bar Parkinson / Garman-Klass / Rogers-Satchell variance
+    QVector<int> m_badBar, m_badRet;       // running count of unusable bars / returns
+    double m_prevClose = 0.0;
+    int m_count = 0;
+};
+
+} // namespace TA
+
+#endif // REALIZEDVOL_H
@@ -0,0 +1,743 @@
+#include "Utils/signalexpression.h"
+#include "Utils/ta_simple.h"
+
+#include <QSet>
+#include <QJsonValue>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// ---------- compiled program ----------
+struct SignalExpression::Program {
+    enum Op : quint8 {
+        Const, Column, Vwap, Load, Store,
+        Neg, Not, Abs, Add, Sub, Mul, Div, Min, Max,
+        Gt, Lt, Ge, Le, Eq, Ne, And, Or,
+        Ema, Sma, StdDev, BbUpper, BbLower, Highest, Lowest, Prev, CrossOver, CrossUnder
+    };
+    struct Instr {
+        Op op;
+        int arg = 0;        // column id, register or slot index
+        double value = 0.0; // constant, or band multiplier for bb_*
+    };
+    struct SlotInfo {
+        Op kind;
+        int period = 0;
+        int offset = 0;   // into the evaluator arena
+    };
+
+    QString text;
+    QVector<Instr> code;
+    QVector<SlotInfo> slotInfo;
+    int arenaSize = 0;
+    int stackDepth = 0;
+    int registerCount = 0;
+};
+
+namespace {
+
+using Program = SignalExpression::Program;
+
+enum ColumnId { ColOpen, ColHigh, ColLow, ColClose, ColVolume, ColHl2, ColHlc3, ColOhlc4, ColCount };
+
+const qint64 kIstOffsetMs = 19800000LL;  // +05:30, NSE session dates
+const qint64 kMsPerDay    = 86400000LL;
+
+int columnFromName(const QString &name) {
+    if (name == "open")   return ColOpen;
+    if (name == "high")   return ColHigh;
+    if (name == "low")    return ColLow;
+    if (name == "close")  return ColClose;
+    if (name == "volume") return ColVolume;
+    if (name == "hl2")    return ColHl2;
+    if (name == "hlc3" || name == "typical") return ColHlc3;
+    if (name == "ohlc4")  return ColOhlc4;
+    return -1;
+}
+
+// ---------- tokenizer ----------
+struct Token {
+    enum Kind { End, Number, Ident, LParen, RParen, Comma, Operator } kind = End;
+    QString text;
+    double number = 0.0;
+    int pos = 0;
+};
+
+QVector<Token> tokenize(const QString &src, QString &error) {
+    QVector<Token> out;
+    const int n = src.size();
+    int i = 0;
+    while (i < n) {
+        const QChar ch = src[i];
+        if (ch.isSpace()) { ++i; continue; }
+        Token t; t.pos = i;
+        if (ch.isDigit() || (ch == '.' && i + 1 < n && src[i + 1].isDigit())) {
+            int j = i;
+            while (j < n && (src[j].isDigit() || src[j] == '.')) ++j;
+            if (j < n && (src[j] == 'e' || src[j] == 'E')) {
+                int k = j + 1;
+                if (k < n && (src[k] == '+' || src[k] == '-')) ++k;
+                if (k < n && src[k].isDigit()) { j = k; while (j < n && src[j].isDigit()) ++j; }
+            }
+            bool ok = false;
+            t.kind = Token::Number;
+            t.text = src.mid(i, j - i);
+            t.number = t.text.toDouble(&ok);
+            if (!ok) { error = QString("Invalid number '%1' at %2").arg(t.text).arg(i); return {}; }
+            i = j;
+        } else if (ch.isLetter() || ch == '_') {
+            int j = i;
+            while (j < n && (src[j].isLetterOrNumber() || src[j] == '_')) ++j;
+            t.kind = Token::Ident;
+            t.text = src.mid(i, j - i).toLower();
+            i = j;
+        } else if (ch == '(') { t.kind = Token::LParen; t.text = "("; ++i; }
+        else if (ch == ')') { t.kind = Token::RParen; t.text = ")"; ++i; }
+        else if (ch == ',') { t.kind = Token::Comma;  t.text = ","; ++i; }
+        else {
+            static const char *twoChar[] = { ">=", "<=", "==", "!=", "&&", "||" };
+            t.kind = Token::Operator;
+            const QString two = src.mid(i, 2);
+            bool matched = false;
+            for (const char *op : twoChar) {
+                if (two == QLatin1String(op)) { t.text = two; i += 2; matched = true; break; }
+            }
+            if (!matched) {
+                if (QString("+-*/<>!").contains(ch)) { t.text = QString(ch); ++i; }
+                else { error = QString("Unexpected character '%1' at %2").arg(ch).arg(i); return {}; }
+            }
+        }
+        out.append(t);
+    }
+    Token end; end.pos = n;
+    out.append(end);
+    return out;
+}
+
+// ---------- AST ----------
+struct Node {
+    enum Kind { ConstNode, ColumnNode, VwapNode, UnaryNode, BinaryNode, CallNode } kind = ConstNode;
+    double value = 0.0;              // ConstNode
+    int column = -1;                 // ColumnNode
+    Program::Op op = Program::Const; // Unary/Binary/Call
+    QVector<double> params;          // Call: constant periods / multipliers
+    std::vector<std::unique_ptr<Node>> args;
+    QString key;                     // canonical form, for sub-expression sharing
+};
+using NodePtr = std::unique_ptr<Node>;
+
+// Shares its ring buffer with other mean/stddev/band calls on the same source and period.
+bool isWindowOp(Program::Op op) {
+    return op == Program::Sma || op == Program::StdDev || op == Program::BbUpper || op == Program::BbLower;
+}
+
+double applyBinary(Program::Op op, double a, double b);
+
+class Parser {
+public:
+    Parser(const QVector<Token> &tokens, QString &error) : m_t(tokens), m_error(error) {}
+
+    NodePtr parse() {
+        NodePtr n = parseOr();
+        if (n && peek().kind != Token::End) fail(QString("Unexpected '%1'").arg(peek().text));
+        return m_error.isEmpty() ? std::move(n) : nullptr;
+    }
+
+private:
+    const QVector<Token> &m_t;
+    QString &m_error;
+    int m_pos = 0;
+
+    const Token &peek() const { return m_t[m_pos]; }
+    const Token &next() { return m_t[m_pos < m_t.size() - 1 ? m_pos++ : m_pos]; }
+    bool acceptOp(const char *a, const char *b = nullptr) {
+        const Token &t = peek();
+        const bool isOp = t.kind == Token::Operator || t.kind == Token::Ident;
+        if (isOp && (t.text == QLatin1String(a) || (b && t.text == QLatin1String(b)))) { ++m_pos; return true; }
+        return false;
+    }
+    NodePtr fail(const QString &msg) {
+        if (m_error.isEmpty()) m_error = QString("%1 at %2").arg(msg).arg(peek().pos);
+        return nullptr;
+    }
+
+    static NodePtr makeConst(double v) {
+        NodePtr n(new Node); n->kind = Node::ConstNode; n->value = v; return n;
+    }
+    static NodePtr makeColumn(int col) {
+        NodePtr n(new Node); n->kind = Node::ColumnNode; n->column = col; return n;
+    }
+    static NodePtr makeUnary(Program::Op op, NodePtr a) {
+        if (a->kind == Node::ConstNode) {
+            const double v = a->value;
+            if (op == Program::Neg) return makeConst(-v);
+            if (op == Program::Abs) return makeConst(qAbs(v));
+            if (op == Program::Not && !qIsNaN(v)) return makeConst(v == 0.0 ? 1.0 : 0.0);
+        }
+        NodePtr n(new Node); n->kind = Node::UnaryNode; n->op = op;
+        n->args.push_back(std::move(a));
+        return n;
+    }
+    static NodePtr makeBinary(Program::Op op, NodePtr a, NodePtr b) {
+        if (a->kind == Node::ConstNode && b->kind == Node::ConstNode)
+            return makeConst(applyBinary(op, a->value, b->value));
+        NodePtr n(new Node); n->kind = Node::BinaryNode; n->op = op;
+        n->args.push_back(std::move(a));
+        n->args.push_back(std::move(b));
+        return n;
+    }
+
+    NodePtr parseOr() {
+        NodePtr l = parseAnd();
+        while (l && acceptOp("or", "||")) {
+            NodePtr r = parseAnd(); if (!r) return nullptr;
+            l = makeBinary(Program::Or, std::move(l), std::move(r));
+        }
+        return l;
+    }
+    NodePtr parseAnd() {
+        NodePtr l = parseCompare();
+        while (l && acceptOp("and", "&&")) {
+            NodePtr r = parseCompare(); if (!r) return nullptr;
+            l = makeBinary(Program::And, std::move(l), std::move(r));
+        }
+        return l;
+    }
+    NodePtr parseCompare() {
+        NodePtr l = parseAdditive();
+        if (!l) return nullptr;
+        Program::Op op;
+        if      (acceptOp(">="))  op = Program::Ge;
+        else if (acceptOp("<="))  op = Program::Le;
+        else if (acceptOp("==")) op = Program::Eq;
+        else if (acceptOp("!=")) op = Program::Ne;
+        else if (acceptOp(">"))  op = Program::Gt;
+        else if (acceptOp("<"))  op = Program::Lt;
+        else return l;
+        NodePtr r = parseAdditive(); if (!r) return nullptr;
+        return makeBinary(op, std::move(l), std::move(r));
+    }
+    NodePtr parseAdditive() {
+        NodePtr l = parseTerm();
+        while (l) {
+            Program::Op op;
+            if (acceptOp("+")) op = Program::Add;
+            else if (acceptOp("-")) op = Program::Sub;
+            else break;
+            NodePtr r = parseTerm(); if (!r) return nullptr;
+            l = makeBinary(op, std::move(l), std::move(r));
+        }
+        return l;
+    }
+    NodePtr parseTerm() {
+        NodePtr l = parseUnary();
+        while (l) {
+            Program::Op op;
+            if (acceptOp("*")) op = Program::Mul;
+            else if (acceptOp("/")) op = Program::Div;
+            else break;
+            NodePtr r = parseUnary(); if (!r) return nullptr;
+            l = makeBinary(op, std::move(l), std::move(r));
+        }
+        return l;
+    }
+    NodePtr parseUnary() {
+        if (acceptOp("-")) { NodePtr a = parseUnary(); return a ? makeUnary(Program::Neg, std::move(a)) : nullptr; }
+        if (acceptOp("+")) return parseUnary();
+        if (acceptOp("!", "not")) { NodePtr a = parseUnary(); return a ? makeUnary(Program::Not, std::move(a)) : nullptr; }
+        return parsePrimary();
+    }
+    NodePtr parsePrimary() {
+        const Token t = next();
+        if (t.kind == Token::Number) return makeConst(t.number);
+        if (t.kind == Token::LParen) {
+            NodePtr n = parseOr();
+            if (!n) return nullptr;
+            if (next().kind != Token::RParen) return fail("Expected ')'");
+            return n;
+        }
+        if (t.kind != Token::Ident) { --m_pos; return fail(QString("Unexpected '%1'").arg(t.text)); }
+
+        if (peek().kind != Token::LParen) {
+            if (t.text == "vwap") { NodePtr n(new Node); n->kind = Node::VwapNode; return n; }
+            const int col = columnFromName(t.text);
+            if (col < 0) { --m_pos; return fail(QString("Unknown identifier '%1'").arg(t.text)); }
+            return makeColumn(col);
+        }
+
+        next(); // '('
+        std::vector<NodePtr> args;
+        if (peek().kind != Token::RParen) {
+            for (;;) {
+                NodePtr a = parseOr();
+                if (!a) return nullptr;
+                args.push_back(std::move(a));
+                if (peek().kind == Token::Comma) { next(); continue; }
+                break;
+            }
+        }
+        if (next().kind != Token::RParen) return fail("Expected ')'");
+        return makeCall(t.text, std::move(args));
+    }
+
+    // Normalizes a call into source arguments (expressions) and constant parameters.
+    NodePtr makeCall(const QString &name, std::vector<NodePtr> args) {
+        struct Spec { const char *name; Program::Op op; int sources; int params; bool implicitClose; };
+        static const Spec specs[] = {
+            { "ema",        Program::Ema,        1, 1, false },
+            { "sma",        Program::Sma,        1, 1, false },
+            { "stddev",     Program::StdDev,     1, 1, false },
+            { "highest",    Program::Highest,    1, 1, false },
+            { "lowest",     Program::Lowest,     1, 1, false },
+            { "prev",       Program::Prev,       1, 1, false },
+            { "bb_upper",   Program::BbUpper,    1, 2, true  },
+            { "bb_lower",   Program::BbLower,    1, 2, true  },
+            { "bb_mid",     Program::Sma,        1, 1, true  },
+            { "crossover",  Program::CrossOver,  2, 0, false },
+            { "crossunder", Program::CrossUnder, 2, 0, false },
+            { "min",        Program::Min,        2, 0, false },
+            { "max",        Program::Max,        2, 0, false },
+            { "abs",        Program::Abs,        1, 0, false },
+        };
+        const Spec *spec = nullptr;
+        for (const Spec &s : specs) if (name == QLatin1String(s.name)) { spec = &s; break; }
+        if (!spec) return fail(QString("Unknown function '%1'").arg(name));
+
+        const int given = int(args.size());
+        const int full = spec->sources + spec->params;
+        if (spec->implicitClose && given == full - 1) {
+            args.insert(args.begin(), makeColumn(ColClose));
+        } else if (given != full) {
+            return fail(QString("%1() expects %2 argument(s), got %3").arg(name).arg(full).arg(given));
+        }
+
+        if (spec->op == Program::Abs) return makeUnary(Program::Abs, std::move(args[0]));
+        if (spec->op == Program::Min || spec->op == Program::Max)
+            return makeBinary(spec->op, std::move(args[0]), std::move(args[1]));
+
+        NodePtr n(new Node);
+        n->kind = Node::CallNode;
+        n->op = spec->op;
+        for (int i = 0; i < spec->sources; ++i) n->args.push_back(std::move(args[i]));
+        for (int i = spec->sources; i < full; ++i) {
+            if (args[i]->kind != Node::ConstNode)
+                return fail(QString("%1(): argument %2 must be a constant").arg(name).arg(i + 1));
+            n->params.append(args[i]->value);
+        }
+        if (spec->params > 0) {
+            const double p = n->params[0];
+            if (p < 1.0 || p > 100000.0 || p != qFloor(p))
+                return fail(QString("%1(): period must be a positive integer").arg(name));
+        }
+        return n;
+    }
+};
+
+double applyBinary(Program::Op op, double a, double b) {
+    const double nan = TA::NaN();
+    const bool anyNaN = qIsNaN(a) || qIsNaN(b);
+    switch (op) {
+    case Program::Add: return a + b;
+    case Program::Sub: return a - b;
+    case Program::Mul: return a * b;
+    case Program::Div: return b == 0.0 ? nan : a / b;
+    case Program::Min: return anyNaN ? nan : qMin(a, b);
+    case Program::Max: return anyNaN ? nan : qMax(a, b);
+    case Program::Gt:  return anyNaN ? nan : (a >  b ? 1.0 : 0.0);
+    case Program::Lt:  return anyNaN ? nan : (a <  b ? 1.0 : 0.0);
+    case Program::Ge:  return anyNaN ? nan : (a >= b ? 1.0 : 0.0);
+    case Program::Le:  return anyNaN ? nan : (a <= b ? 1.0 : 0.0);
+    case Program::Eq:  return anyNaN ? nan : (a == b ? 1.0 : 0.0);
+    case Program::Ne:  return anyNaN ? nan : (a != b ? 1.0 : 0.0);
+    case Program::And: return anyNaN ? nan : ((a != 0.0 && b != 0.0) ? 1.0 : 0.0);
+    case Program::Or:  return anyNaN ? nan : ((a != 0.0 || b != 0.0) ? 1.0 : 0.0);
+    default:           return nan;
+    }
+}
+
+// ---------- code generation ----------
+class Compiler {
+public:
+    explicit Compiler(Program &p) : m_p(p) {}
+
+    void compile(Node *root) {
+        assignKeys(root);
+        countKeys(root);
+        generate(root);
+        m_p.registerCount = m_nextRegister;
+    }
+
+private:
+    Program &m_p;
+    QHash<QString, int> m_keyCount;
+    QHash<QString, int> m_registerOfKey;
+    QSet<QString> m_emitted;
+    QHash<QString, int> m_windowSlot;
+    int m_nextRegister = 0;
+    int m_depth = 0;
+
+    static QString opName(Program::Op op) { return QString::number(int(op)); }
+
+    void assignKeys(Node *n) {
+        for (auto &a : n->args) assignKeys(a.get());
+        switch (n->kind) {
+        case Node::ConstNode:  n->key = "#" + QString::number(n->value, 'g', 17); break;
+        case Node::ColumnNode: n->key = "$" + QString::number(n->column); break;
+        case Node::VwapNode:   n->key = "$vwap"; break;
+        default: {
+            QStringList parts;
+            for (auto &a : n->args) parts << a->key;
+            for (double v : n->params) parts << QString::number(v, 'g', 17);
+            n->key = opName(n->op) + "(" + parts.join(',') + ")";
+        }
+        }
+    }
+
+    void countKeys(Node *n) {
+        if (n->kind == Node::ConstNode || n->kind == Node::ColumnNode) return;
+        ++m_keyCount[n->key];
+        for (auto &a : n->args) countKeys(a.get());
+    }
+
+    void push(Program::Op op, int arg = 0, double value = 0.0, int stackDelta = 0) {
+        Program::Instr in; in.op = op; in.arg = arg; in.value = value;
+        m_p.code.append(in);
+        m_depth += stackDelta;
+        m_p.stackDepth = qMax(m_p.stackDepth, m_depth);
+    }
+
+    int newSlot(Program::Op kind, int period, int arenaSize) {
+        Program::SlotInfo s; s.kind = kind; s.period = period; s.offset = m_p.arenaSize;
+        m_p.arenaSize += arenaSize;
+        m_p.slotInfo.append(s);
+        return m_p.slotInfo.size() - 1;
+    }
+
+    void generate(Node *n) {
+        const bool shared = m_keyCount.value(n->key) > 1;
+        if (shared && m_emitted.contains(n->key)) {
+            push(Program::Load, m_registerOfKey.value(n->key), 0.0, +1);
+            return;
+        }
+
+        for (auto &a : n->args) generate(a.get());
+
+        switch (n->kind) {
+        case Node::ConstNode:  push(Program::Const, 0, n->value, +1); break;
+        case Node::ColumnNode: push(Program::Column, n->column, 0.0, +1); break;
+        case Node::VwapNode:   push(Program::Vwap, newSlot(Program::Vwap, 0, 0), 0.0, +1); break;
+        case Node::UnaryNode:  push(n->op); break;
+        case Node::BinaryNode: push(n->op, 0, 0.0, -1); break;
+        case Node::CallNode: {
+            const int period = n->params.isEmpty() ? 0 : int(n->params[0]);
+            const double mult = n->params.size() > 1 ? n->params[1] : 0.0;
+            int slot = -1;
+            if (isWindowOp(n->op)) {
+                const QString wkey = n->args[0]->key + "|" + QString::number(period);
+                slot = m_windowSlot.value(wkey, -1);
+                if (slot < 0) { slot = newSlot(Program::Sma, period, period); m_windowSlot.insert(wkey, slot); }
+            } else if (n->op == Program::Highest || n->op == Program::Lowest) {
+                slot = newSlot(n->op, period, 2 * period); // (value, bar) pairs
+            } else if (n->op == Program::Prev) {
+                slot = newSlot(n->op, period, period);
+            } else {
+                slot = newSlot(n->op, period, 0);
+            }
+            push(n->op, slot, mult, 1 - int(n->args.size()));
+            break;
+        }
+        }
+
+        if (shared) {
+            const int reg = m_nextRegister++;
+            m_registerOfKey.insert(n->key, reg);
+            m_emitted.insert(n->key);
+            push(Program::Store, reg);
+        }
+    }
+};
+
+} // namespace
+
+// ---------- SignalExpression ----------
+SignalExpression SignalExpression::compile(const QString &text, QString *error)
+{
+    QString err;
+    const QVector<Token> tokens = tokenize(text, err);
+    NodePtr root;
+    if (err.isEmpty()) {
+        if (tokens.size() <= 1) err = "Empty expression";
+        else root = Parser(tokens, err).parse();
+    }
+    if (!err.isEmpty() || !root) {
+        if (error) *error = err.isEmpty() ? QString("Invalid expression") : err;
+        return SignalExpression();
+    }
+
+    QSharedPointer<Program> p(new Program);
+    p->text = text;
+    Compiler(*p).compile(root.get());
+    if (error) error->clear();
+    return SignalExpression(p);
+}
+
+QHash<QString, SignalExpression> SignalExpression::fromStrategyConfig(const QJsonObject &strategyConfig,
+                                                                      QStringList *errors)
+{
+    QHash<QString, SignalExpression> out;
+    const QJsonObject sigs = strategyConfig.value("signals").toObject();
+    for (auto it = sigs.constBegin(); it != sigs.constEnd(); ++it) {
+        QString err;
+        SignalExpression e = compile(it.value().toString(), &err);
+        if (!e.isValid()) {
+            if (errors) errors->append(QString("Signal '%1': %2").arg(it.key(), err));
+            continue;
+        }
+        out.insert(it.key(), e);
+    }
+    return out;
+}
+
+QString SignalExpression::text() const
+{
+    return m_program ? m_program->text : QString();
+}
+
+QVector<double> SignalExpression::evaluate(const QVector<CandleData> &bars) const
+{
+    QVector<double> out;
+    if (!m_program) return out;
+    out.resize(bars.size());
+    Evaluator ev(m_program);
+    double *dst = out.data();
+    for (const CandleData &c : bars) *dst++ = ev.update(c);
+    return out;
+}
+
+SignalExpression::Evaluator SignalExpression::streamingEvaluator() const
+{
+    return m_program ? Evaluator(m_program) : Evaluator();
+}
+
+// ---------- Evaluator ----------
+SignalExpression::Evaluator::Evaluator(QSharedPointer<const Program> program)
+    : m_program(program)
+{
+    m_slots.resize(program->slotInfo.size());
+    m_arena.resize(program->arenaSize);
+    m_stack.resize(qMax(1, program->stackDepth));
+    m_registers.resize(program->registerCount);
+    m_savedSlots.resize(m_slots.size());
+    m_savedArena.resize(m_arena.size());
+    reset();
+}
+
+void SignalExpression::Evaluator::reset()
+{
+    if (!m_program) return;
+    const double nan = TA::NaN();
+    for (int i = 0; i < m_slots.size(); ++i) {
+        Slot &s = m_slots[i];
+        s = Slot();
+        switch (m_program->slotInfo[i].kind) {
+        case Program::Ema:
+        case Program::CrossOver:
+        case Program::CrossUnder:
+            s.a = nan; s.b = nan;
+            break;
+        default:
+            break;
+        }
+    }
+    m_arena.fill(0.0);
+    m_registers.fill(nan);
+    m_bar = 0;
+    m_value = nan;
+}
+
+double SignalExpression::Evaluator::peek(const CandleData &bar)
+{
+    if (!m_program) return TA::NaN();
+    // Registers and the stack are rewritten by every update(), so only slots and rings need saving.
+    std::copy(m_slots.cbegin(), m_slots.cend(), m_savedSlots.begin());
+    std::copy(m_arena.cbegin(), m_arena.cend(), m_savedArena.begin());
+    const qint64 bar0 = m_bar;
+    const double value0 = m_value;
+
+    const double out = update(bar);
+
+    std::copy(m_savedSlots.cbegin(), m_savedSlots.cend(), m_slots.begin());
+    std::copy(m_savedArena.cbegin(), m_savedArena.cend(), m_arena.begin());
+    m_bar = bar0;
+    m_value = value0;
+    return out;
+}
+
+double SignalExpression::Evaluator::update(const CandleData &bar)
+{
+    if (!m_program) return TA::NaN();
+    const Program &p = *m_program;
+    const double nan = TA::NaN();
+
+    const double cols[ColCount] = {
+        bar.open, bar.high, bar.low, bar.close, double(bar.volume),
+        (bar.high + bar.low) * 0.5,
+        (bar.high + bar.low + bar.close) / 3.0,
+        (bar.open + bar.high + bar.low + bar.close) * 0.25
+    };
+
+    double *st = m_stack.data();
+    double *reg = m_registers.data();
+    double *arena = m_arena.data();
+    Slot *state = m_slots.data();
+    int sp = 0;
+
+    for (const Program::Instr &in : p.code) {
+        switch (in.op) {
+        case Program::Const:  st[sp++] = in.value; break;
+        case Program::Column: st[sp++] = cols[in.arg]; break;
+        case Program::Load:   st[sp++] = reg[in.arg]; break;
+        case Program::Store:  reg[in.arg] = st[sp - 1]; break;
+
+        case Program::Neg: st[sp - 1] = -st[sp - 1]; break;
+        case Program::Abs: st[sp - 1] = qAbs(st[sp - 1]); break;
+        case Program::Not: {
+            const double a = st[sp - 1];
+            st[sp - 1] = qIsNaN(a) ? nan : (a == 0.0 ? 1.0 : 0.0);
+            break;
+        }
+        case Program::Add: case Program::Sub: case Program::Mul: case Program::Div:
+        case Program::Min: case Program::Max:
+        case Program::Gt: case Program::Lt: case Program::Ge: case Program::Le:
+        case Program::Eq: case Program::Ne: case Program::And: case Program::Or: {
+            const double b = st[--sp];
+            st[sp - 1] = applyBinary(in.op, st[sp - 1], b);
+            break;
+        }
+
+        case Program::Vwap: {
+            // Session VWAP on typical price; resets when the IST calendar day changes.
+            Slot &s = state[in.arg];
+            const qint64 day = (bar.timestamp.toMSecsSinceEpoch() + kIstOffsetMs) / kMsPerDay;
+            if (s.stamp != day) { s.stamp = day; s.a = 0.0; s.b = 0.0; }
+            const double vol = cols[ColVolume];
+            const double tp = cols[ColHlc3];
+            if (qIsFinite(tp) && vol > 0.0) { s.a += tp * vol; s.b += vol; }
+            st[sp++] = s.b > 0.0 ? s.a / s.b : nan;
+            break;
+        }
+
+        case Program::Ema: {
+            // Same semantics as TA::ema: SMA seed over the first `period` finite values.
+            Slot &s = state[in.arg];
+            const int period = p.slotInfo[in.arg].period;
+            const double x = st[sp - 1];
+            double out = nan;
+            if (qIsFinite(x)) {
+                if (!qIsFinite(s.a)) {
+                    s.b = (s.count == 0 ? 0.0 : s.b) + x;
+                    if (++s.count >= period) { s.a = s.b / period; out = s.a; }
+                } else {
+                    const double k = 2.0 / (period + 1.0);
+                    s.a = x * k + s.a * (1.0 - k);
+                    out = s.a;
+                }
+            }
+            st[sp - 1] = out;
+            break;
+        }
+
+        case Program::Sma: case Program::StdDev: case Program::BbUpper: case Program::BbLower: {
+            // Rolling window shared by every mean/stddev/band over the same source & period.
+            Slot &s = state[in.arg];
+            const Program::SlotInfo &info = p.slotInfo[in.arg];
+            const int n = info.period;
+            const double x = st[sp - 1];
+            if (s.stamp != m_bar) {
+                s.stamp = m_bar;
+                double *ring = arena + info.offset;
+                if (s.count >= n) {
+                    const double old = ring[s.head];
+                    if (qIsFinite(old)) { s.a -= old; s.b -= old * old; } else { --s.aux; }
+                } else {
+                    ++s.count;
+                }
+                ring[s.head] = x;
+                if (qIsFinite(x)) { s.a += x; s.b += x * x; } else { ++s.aux; }
+                if (++s.head == n) s.head = 0;
+            }
+            double out = nan;
+            if (s.count >= n && s.aux == 0) {
+                const double mean = s.a / n;
+                if (in.op == Program::Sma) {
+                    out = mean;
+                } else {
+                    const double var = s.b / n - mean * mean;
+                    const double sd = (n > 1 && var > 0.0) ? qSqrt(var) : 0.0;
+                    if (in.op == Program::StdDev)       out = n > 1 ? sd : nan;
+                    else if (in.op == Program::BbUpper) out = mean + in.value * sd;
+                    else                                out = mean - in.value * sd;
+                }
+            }
+            st[sp - 1] = out;
+            break;
+        }
+
+        case Program::Highest: case Program::Lowest: {
+            // Monotonic deque of (value, bar) pairs in a ring of `period` entries.
+            Slot &s = state[in.arg];
+            const Program::SlotInfo &info = p.slotInfo[in.arg];
+            const int n = info.period;
+            double *dq = arena + info.offset;
+            const double x = st[sp - 1];
+            const bool isMax = in.op == Program::Highest;
+            auto at = [&](int i) -> double * { return dq + 2 * ((s.aux + i) % n); };
+            if (s.count > 0 && at(0)[1] <= double(m_bar - n)) { s.aux = (s.aux + 1) % n; --s.count; }
+            if (qIsFinite(x)) {
+                while (s.count > 0) {
+                    const double back = at(s.count - 1)[0];
+                    if (isMax ? back <= x : back >= x) --s.count; else break;
+                }
+                double *slot = at(s.count);
+                slot[0] = x; slot[1] = double(m_bar);
+                ++s.count;
+            }
+            st[sp - 1] = (m_bar + 1 >= n && s.count > 0) ? at(0)[0] : nan;
+            break;
+        }
+
+        case Program::Prev: {
+            Slot &s = state[in.arg];
+            const Program::SlotInfo &info = p.slotInfo[in.arg];
+            double *ring = arena + info.offset;
+            const double x = st[sp - 1];
+            const double out = s.count >= info.period ? ring[s.head] : nan;
+            ring[s.head] = x;
+            if (++s.head == info.period) s.head = 0;
+            if (s.count < info.period) ++s.count;
+            st[sp - 1] = out;
+            break;
+        }
+
+        case Program::CrossOver: case Program::CrossUnder: {
+            Slot &s = state[in.arg];
+            const double b = st[--sp];
+            const double a = st[sp - 1];
+            double out = nan;
+            if (!qIsNaN(a) && !qIsNaN(b) && !qIsNaN(s.a) && !qIsNaN(s.b)) {
+                out = in.op == Program::CrossOver ? ((s.a <= s.b && a > b) ? 1.0 : 0.0)
+                                                  : ((s.a >= s.b && a < b) ? 1.0 : 0.0);
+            }
+            s.a = a; s.b = b;
+            st[sp - 1] = out;
+            break;
+        }
+        }
+    }
+
+    ++m_bar;
+    m_value = sp > 0 ? st[sp - 1] : nan;
+    return m_value;
+}
@@ -0,0 +1,106 @@
+#ifndef SIGNALEXPRESSION_H
+#define SIGNALEXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QtGlobal>
+
+#include "Data/DataStructures/candle.h"
+
+// Small indicator expression language for strategy signals, e.g.
+//   ema(close,21) - vwap
+//   close > bb_upper(21,2) and volume > sma(volume,20)
+//
+// An expression is parsed once and compiled into a flat postfix program. Every
+// indicator call owns a streaming state slot, so the whole expression (however many
+// indicators it combines) is evaluated bar-by-bar in one pass over the candle columns,
+// without the temporary QVector per step that composing TA:: functions would need.
+// Identical sub-expressions are evaluated once per bar, and sma/stddev/bb_* over the
+// same source and period share one ring buffer.
+//
+// Columns:   open high low close volume hl2 hlc3 ohlc4 vwap (intraday, resets per session)
+// Functions: ema(src,n) sma(src,n) stddev(src,n) highest(src,n) lowest(src,n)
+//            bb_upper([src,]n,k) bb_mid([src,]n) bb_lower([src,]n,k)
+//            prev(src,n) crossover(a,b) crossunder(a,b) abs(x) min(a,b) max(a,b)
+// Operators: + - * /  > < >= <= == !=  and or not (also && || !)
+//
+// Comparisons/logic evaluate to 1.0 / 0.0. NaN (indicator still warming up) propagates,
+// matching the TA:: convention. Periods and multipliers must be numeric constants.
+//
+// Signals are configured per strategy in config.json:
+//   "strategies": { "DayTradingStrategy1": { "signals": { "trendUp": "ema(close,21) > vwap" } } }
+// DataManager compiles them at startup and streams them over every 5-minute series
+// (DataManager::getSignalValue).
+class SignalExpression
+{
+public:
+    class Evaluator;
+    struct Program; // compiled plan (opaque, immutable, shared between evaluators)
+
+    SignalExpression() = default;
+
+    // Parses and compiles text. On failure returns an invalid expression and sets *error.
+    static SignalExpression compile(const QString &text, QString *error = nullptr);
+
+    // Compiles every entry of strategyConfig["signals"] (name -> expression text).
+    // Entries that fail to compile are skipped and reported in *errors.
+    static QHash<QString, SignalExpression> fromStrategyConfig(const QJsonObject &strategyConfig,
+                                                               QStringList *errors = nullptr);
+
+    bool isValid() const { return !m_program.isNull(); }
+    QString text() const;
+
+    // Batch: one value per bar (same length as bars).
+    QVector<double> evaluate(const QVector<CandleData> &bars) const;
+
+    // Streaming: fresh evaluator with its own indicator state.
+    Evaluator streamingEvaluator() const;
+
+private:
+    explicit SignalExpression(QSharedPointer<const Program> program) : m_program(program) {}
+    QSharedPointer<const Program> m_program;
+};
+
+// Streaming evaluator: feed bars in timestamp order, one update() per bar.
+// Holds all indicator state in flat arrays sized at construction; update() and peek() do not allocate.
+class SignalExpression::Evaluator
+{
+public:
+    Evaluator() = default;
+
+    double update(const CandleData &bar);
+    // Value update(bar) would return, leaving the state as it was (for a still-forming bar).
+    double peek(const CandleData &bar);
+    double value() const { return m_value; }
+    void reset();
+    bool isValid() const { return !m_program.isNull(); }
+
+    // Per-instruction indicator state. Ring-buffer contents live in m_arena.
+    struct Slot {
+        double a = 0.0, b = 0.0, c = 0.0, d = 0.0; // kind-specific scalars (sums, prev values)
+        qint64 stamp = -1;                          // bar number of the last push (shared windows)
+        int head = 0;                               // ring write position
+        int count = 0;                              // values seen / held
+        int aux = 0;                                // kind-specific counter (non-finite count, deque head)
+    };
+
+private:
+    friend class SignalExpression;
+    explicit Evaluator(QSharedPointer<const Program> program);
+
+    QSharedPointer<const Program> m_program;
+    QVector<Slot> m_slots;
+    QVector<double> m_arena;     // ring buffers for windowed indicators
+    QVector<double> m_stack;     // value stack (max depth known at compile time)
+    QVector<double> m_registers; // common sub-expression results for the current bar
+    QVector<Slot> m_savedSlots;  // peek() scratch: state to restore after the trial update
+    QVector<double> m_savedArena;
+    qint64 m_bar = 0;
+    double m_value = 0.0;
+};
+
+#endif // SIGNALEXPRESSION_H
@@ -189,6 +189,136 @@ QVector<double> vwap(const QVector<double>& high,
     return out;
 }
 
+// --- True-range family ---
+void RangeIndicators::Rma::add(double x) {
+    if (count < period) {
+        sum += x;
+        if (++count == period) value = sum / period;
+    } else {
+        value = (value * (period - 1) + x) / period;
+    }
+}
+
+void RangeIndicators::reset() {
+    auto init = [](Rma& r, int period) { r = Rma(); r.period = qMax(1, period); };
+    init(m_atr, m_p.atrPeriod);
+    init(m_dmTr, m_p.dmiPeriod);
+    init(m_plusDm, m_p.dmiPeriod);
+    init(m_minusDm, m_p.dmiPeriod);
+    init(m_adx, m_p.dmiPeriod);
+    init(m_stAtr, m_p.supertrendPeriod);
+    init(m_kAtr, m_p.keltnerAtrPeriod);
+    m_ema = m_emaSeed = 0.0;
+    m_emaCount = 0;
+    m_prevHigh = m_prevLow = m_prevClose = 0.0;
+    m_hasPrev = false;
+    m_stUpper = m_stLower = 0.0;
+    m_stDir = 0;
+    const double nan = NaN();
+    m_last = RangeValues{ nan, nan, nan, nan, nan, nan, 0, nan, nan, nan };
+}
+
+RangeValues RangeIndicators::update(double h, double l, double c) {
+    const double nan = NaN();
+    RangeValues v{ nan, nan, nan, nan, nan, nan, 0, nan, nan, nan };
+    if (!isFinite(h) || !isFinite(l) || !isFinite(c)) { m_last = v; return v; }
+
+    // True range and directional movement, once.
+    const double tr = m_hasPrev ? qMax(h - l, qMax(qAbs(h - m_prevClose), qAbs(l - m_prevClose))) : (h - l);
+    v.tr = tr;
+    m_atr.add(tr);
+    m_stAtr.add(tr);
+    m_kAtr.add(tr);
+    if (m_atr.ready()) v.atr = m_atr.value;
+
+    // +/-DI and ADX
+    if (m_hasPrev) {
+        const double up = h - m_prevHigh;
+        const double down = m_prevLow - l;
+        m_plusDm.add((up > down && up > 0) ? up : 0.0);
+        m_minusDm.add((down > up && down > 0) ? down : 0.0);
+        m_dmTr.add(tr);
+        if (m_dmTr.ready() && m_dmTr.value > 0.0) {
+            v.plusDI = 100.0 * m_plusDm.value / m_dmTr.value;
+            v.minusDI = 100.0 * m_minusDm.value / m_dmTr.value;
+            const double diSum = v.plusDI + v.minusDI;
+            m_adx.add(diSum > 0.0 ? 100.0 * qAbs(v.plusDI - v.minusDI) / diSum : 0.0);
+            if (m_adx.ready()) v.adx = m_adx.value;
+        }
+    }
+
+    // Supertrend: final bands only tighten while price stays on the trend side.
+    if (m_stAtr.ready()) {
+        const double hl2 = 0.5 * (h + l);
+        const double basicUpper = hl2 + m_p.supertrendMult * m_stAtr.value;
+        const double basicLower = hl2 - m_p.supertrendMult * m_stAtr.value;
+        if (m_stDir == 0) {
+            m_stUpper = basicUpper;
+            m_stLower = basicLower;
+            m_stDir = 1;
+        } else {
+            m_stUpper = (basicUpper < m_stUpper || m_prevClose > m_stUpper) ? basicUpper : m_stUpper;
+            m_stLower = (basicLower > m_stLower || m_prevClose < m_stLower) ? basicLower : m_stLower;
+            if (m_stDir > 0 && c < m_stLower) m_stDir = -1;
+            else if (m_stDir < 0 && c > m_stUpper) m_stDir = 1;
+        }
+        v.supertrendDir = m_stDir;
+        v.supertrend = m_stDir > 0 ? m_stLower : m_stUpper;
+    }
+
+    // Keltner: EMA(close) +/- mult * ATR
+    const int kp = qMax(1, m_p.keltnerPeriod);
+    if (m_emaCount < kp) {
+        m_emaSeed += c;
+        if (++m_emaCount == kp) m_ema = m_emaSeed / kp;
+    } else {
+        const double k = 2.0 / (kp + 1.0);
+        m_ema = c * k + m_ema * (1.0 - k);
+    }
+    if (m_emaCount >= kp) {
+        v.keltnerMid = m_ema;
+        if (m_kAtr.ready()) {
+            v.keltnerUpper = m_ema + m_p.keltnerMult * m_kAtr.value;
+            v.keltnerLower = m_ema - m_p.keltnerMult * m_kAtr.value;
+        }
+    }
+
+    m_prevHigh = h; m_prevLow = l; m_prevClose = c;
+    m_hasPrev = true;
+    m_last = v;
+    return v;
+}
+
+RangeSeries rangeIndicators(const QVector<double>& high,
+                            const QVector<double>& low,
+                            const QVector<double>& close,
+                            const RangeParams& p, int warmup)
+{
+    const int n = qMin(close.size(), qMin(high.size(), low.size()));
+    RangeSeries s;
+    for (QVector<double>* col : { &s.tr, &s.atr, &s.plusDI, &s.minusDI, &s.adx, &s.supertrend,
+                                  &s.keltnerMid, &s.keltnerUpper, &s.keltnerLower })
+        col->resize(n);
+    s.supertrendDir.resize(n);
+
+    RangeIndicators state(p);
+    const double* H = high.constData();
+    const double* L = low.constData();
+    const double* C = close.constData();
+    for (int i = 0; i < n; ++i) {
+        RangeValues v = state.update(H[i], L[i], C[i]);
+        if (warmup > 0 && i + 1 < warmup) {
+            const double nan = NaN();
+            v = RangeValues{ nan, nan, nan, nan, nan, nan, 0, nan, nan, nan };
+        }
+        s.tr[i] = v.tr;                 s.atr[i] = v.atr;
+        s.plusDI[i] = v.plusDI;         s.minusDI[i] = v.minusDI;     s.adx[i] = v.adx;
+        s.supertrend[i] = v.supertrend; s.supertrendDir[i] = v.supertrendDir;
+        s.keltnerMid[i] = v.keltnerMid; s.keltnerUpper[i] = v.keltnerUpper; s.keltnerLower[i] = v.keltnerLower;
+    }
+    return s;
+}
+
 // --- Pivot Point sets ---
 Pivots pivotsClassic(double H, double L, double C) {
     Pivots p{};
@@ -39,6 +39,69 @@ QVector<double> vwap(const QVector<double>& high,
                      const QVector<double>& volume,
                      const QVector<QDateTime>& ts);
 
+// --- True-range family (ATR, ADX/DMI, Supertrend, Keltner) ---
+// One kernel computes TR and +/-DM once per bar and derives everything else from them.
+// Smoothing follows Wilder (RMA seeded with the SMA of the first `period` values); the Keltner
+// mid line is an EMA of close seeded the same way as TA::ema.
+struct RangeParams {
+    int atrPeriod = 14;
+    int dmiPeriod = 14;           // +DI/-DI and ADX
+    int supertrendPeriod = 10;
+    double supertrendMult = 3.0;
+    int keltnerPeriod = 20;       // EMA of close
+    int keltnerAtrPeriod = 10;
+    double keltnerMult = 2.0;
+};
+
+// One bar's outputs (NaN until the respective warm-up is complete).
+struct RangeValues {
+    double tr, atr;
+    double plusDI, minusDI, adx;
+    double supertrend;
+    int supertrendDir;            // +1 up-trend (line below price), -1 down-trend, 0 not ready
+    double keltnerMid, keltnerUpper, keltnerLower;
+};
+
+// Streaming form: O(1) per bar, a few dozen bytes of state.
+class RangeIndicators {
+public:
+    explicit RangeIndicators(const RangeParams& p = RangeParams()) : m_p(p) { reset(); }
+    void reset();
+    RangeValues update(double high, double low, double close);
+    const RangeValues& last() const { return m_last; }
+    const RangeParams& params() const { return m_p; }
+
+private:
+    struct Rma {
+        int period = 1, count = 0;
+        double sum = 0.0, value = 0.0;
+        bool ready() const { return count >= period; }
+        void add(double x);
+    };
+    RangeParams m_p;
+    Rma m_atr, m_dmTr, m_plusDm, m_minusDm, m_adx, m_stAtr, m_kAtr;
+    double m_ema = 0.0, m_emaSeed = 0.0;
+    int m_emaCount = 0;
+    double m_prevHigh = 0.0, m_prevLow = 0.0, m_prevClose = 0.0;
+    bool m_hasPrev = false;
+    double m_stUpper = 0.0, m_stLower = 0.0;
+    int m_stDir = 0;
+    RangeValues m_last;
+};
+
+// Batch form: one pass over the arrays, same results as feeding RangeIndicators bar by bar.
+struct RangeSeries {
+    QVector<double> tr, atr;
+    QVector<double> plusDI, minusDI, adx;
+    QVector<double> supertrend;
+    QVector<int> supertrendDir;
+    QVector<double> keltnerMid, keltnerUpper, keltnerLower;
+};
+RangeSeries rangeIndicators(const QVector<double>& high,
+                            const QVector<double>& low,
+                            const QVector<double>& close,
+                            const RangeParams& p = RangeParams(), int warmup = 0);
+
 // Pivot point sets (Classic, Fibonacci, Camarilla) from previous day H/L/C
 struct Pivots {
     double P;
@@ -0,0 +1,179 @@
+#include "Utils/tracer.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QDebug>
+
+namespace {
+thread_local void *t_buffer = nullptr;
+thread_local quint64 t_currentFlow = 0;
+std::atomic<quint32> g_nextTid{1};
+
+// Names are literals written by us, but escape anyway so a stray quote can't break the file.
+QByteArray jsonString(const char *s)
+{
+    QByteArray out("\"");
+    for (const char *p = s ? s : ""; *p; ++p) {
+        if (*p == '"' || *p == '\\') out += '\\';
+        out += *p;
+    }
+    out += '"';
+    return out;
+}
+
+QByteArray micros(qint64 ns)
+{
+    return QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+}
+
+std::atomic<bool> Tracer::s_enabled{false};
+std::atomic<quint64> Tracer::s_nextFlow{1};
+
+// ---------- setup ----------
+Tracer* Tracer::instance()
+{
+    static Tracer *self = new Tracer(); // never destroyed: threads may trace during shutdown
+    return self;
+}
+
+void Tracer::setEnabled(bool on)
+{
+    if (on && !m_originNs) m_originNs = nowNs();
+    s_enabled.store(on, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const char *name)
+{
+    threadBuffer()->threadName = name;
+}
+
+quint64 Tracer::currentFlow()
+{
+    return t_currentFlow;
+}
+
+TraceFlowScope::TraceFlowScope(quint64 id)
+    : m_previous(t_currentFlow)
+{
+    t_currentFlow = id;
+}
+
+TraceFlowScope::~TraceFlowScope()
+{
+    t_currentFlow = m_previous;
+}
+
+// ---------- recording ----------
+Tracer::Buffer *Tracer::threadBuffer()
+{
+    if (!t_buffer) {
+        auto *b = new Buffer;
+        b->tid = g_nextTid.fetch_add(1, std::memory_order_relaxed);
+        Tracer *self = instance();
+        QMutexLocker lock(&self->m_buffersMutex);
+        self->m_buffers.append(b);
+        t_buffer = b;
+    }
+    return static_cast<Buffer*>(t_buffer);
+}
+
+void Tracer::append(const Event &e)
+{
+    Buffer *b = threadBuffer();
+    Chunk *chunk = b->chunks.isEmpty() ? nullptr : b->chunks.last();
+    int n = chunk ? chunk->count.load(std::memory_order_relaxed) : kChunkEvents;
+    if (n >= kChunkEvents) {
+        if (b->chunks.size() >= kMaxChunks) return;
+        chunk = new Chunk;
+        QMutexLocker lock(&b->chunksMutex);
+        b->chunks.append(chunk);
+        n = 0;
+    }
+    chunk->events[n] = e;
+    chunk->count.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::complete(const char *cat, const char *name, qint64 startNs, qint64 endNs)
+{
+    append(Event{ startNs, endNs - startNs, cat, name, 0.0, 0, 'X' });
+}
+
+void Tracer::instant(const char *cat, const char *name)
+{
+    append(Event{ nowNs(), 0, cat, name, 0.0, 0, 'i' });
+}
+
+void Tracer::counter(const char *name, double value)
+{
+    append(Event{ nowNs(), 0, "counter", name, value, 0, 'C' });
+}
+
+void Tracer::flow(char phase, const char *cat, const char *name, quint64 id)
+{
+    if (id == 0) return;
+    append(Event{ nowNs(), 0, cat, name, 0.0, id, phase });
+}
+
+// ---------- export ----------
+bool Tracer::exportChromeJson(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Tracer: cannot open" << filePath;
+        return false;
+    }
+
+    QVector<Buffer*> buffers;
+    {
+        QMutexLocker lock(&m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    QByteArray out("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto begin = [&](const Buffer *b, char phase) {
+        if (!first) out += ",\n";
+        first = false;
+        out += "{\"pid\":1,\"tid\":" + QByteArray::number(int(b->tid)) + ",\"ph\":\"";
+        out += phase;
+        out += '"';
+    };
+
+    for (const Buffer *b : buffers) {
+        if (b->threadName) {
+            begin(b, 'M');
+            out += ",\"name\":\"thread_name\",\"args\":{\"name\":" + jsonString(b->threadName) + "}}";
+        }
+        QVector<Chunk*> chunks;
+        {
+            QMutexLocker lock(&b->chunksMutex);
+            chunks = b->chunks;
+        }
+        for (const Chunk *c : chunks) {
+            const int n = c->count.load(std::memory_order_acquire);
+            for (int i = 0; i < n; ++i) {
+                const Event &e = c->events[i];
+                begin(b, e.phase);
+                out += ",\"cat\":" + jsonString(e.cat) + ",\"name\":" + jsonString(e.name)
+                     + ",\"ts\":" + micros(e.tsNs - m_originNs);
+                switch (e.phase) {
+                case 'X': out += ",\"dur\":" + micros(e.durNs); break;
+                case 'i': out += ",\"s\":\"t\""; break;
+                case 'C': out += ",\"args\":{\"value\":" + QByteArray::number(e.value, 'g', 12) + "}"; break;
+                case 's': case 't': case 'f':
+                    out += ",\"id\":" + QByteArray::number(e.id) + ",\"bp\":\"e\"";
+                    break;
+                }
+                out += "}";
+            }
+        }
+        if (out.size() > (1 << 20)) { file.write(out); out.clear(); }
+    }
+    out += "\n]}\n";
+    file.write(out);
+    return true;
+}
@@ -0,0 +1,140 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <atomic>
+#include <chrono>
+
+// Timeline tracing exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Events go into the calling thread's buffer: fixed chunks of events that are appended to and
+// published with a release store, so recording never locks (except once per 4096 events to
+// add a chunk) and export can run while threads keep tracing. When tracing is disabled every
+// macro is a single relaxed load; define QPX_NO_TRACE to compile them out entirely.
+//
+// Names and categories must be string literals (only the pointer is stored).
+//
+//   TRACE_ZONE("http", "HttpManager::sendGetRequest");   // slice for the rest of the scope
+//   TRACE_COUNTER("historical.queue", queue.size());
+//   const quint64 flow = Tracer::newFlowId();           // arrow from here ...
+//   TRACE_FLOW_BEGIN("http", "request", flow);
+//   TRACE_FLOW_END("http", "request", flow);             // ... to here (any thread)
+//
+// TraceFlowScope makes a flow id "current" on a thread so code further down a direct call
+// chain (KiteConnectAPI -> DataManager) can add steps without the id being passed along.
+class Tracer
+{
+public:
+    static Tracer* instance();
+
+    void setEnabled(bool on);
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Labels the calling thread in the exported timeline.
+    void setThreadName(const char *name);
+    // Writes everything recorded so far; events keep accumulating afterwards.
+    bool exportChromeJson(const QString &filePath) const;
+
+    static quint64 newFlowId() { return s_nextFlow.fetch_add(1, std::memory_order_relaxed); }
+    static quint64 currentFlow();
+
+    // Raw recorders behind the macros.
+    static void complete(const char *cat, const char *name, qint64 startNs, qint64 endNs);
+    static void instant(const char *cat, const char *name);
+    static void counter(const char *name, double value);
+    static void flow(char phase, const char *cat, const char *name, quint64 id);
+
+    static qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    struct Event {
+        qint64 tsNs;
+        qint64 durNs;       // 'X' only
+        const char *cat;
+        const char *name;
+        double value;       // 'C' only
+        quint64 id;         // flows
+        char phase;         // X, i, C, s, t, f
+    };
+    static const int kChunkEvents = 4096;
+    static const int kMaxChunks = 256;      // per thread: ~1M events, then new events are dropped
+    struct Chunk {
+        std::atomic<int> count{0};
+        Event events[kChunkEvents];
+    };
+    struct Buffer {
+        quint32 tid = 0;
+        const char *threadName = nullptr;
+        mutable QMutex chunksMutex;         // guards the chunk list, not the events
+        QVector<Chunk*> chunks;
+    };
+
+    Tracer() = default;
+    static Buffer *threadBuffer();
+    static void append(const Event &e);
+
+    static std::atomic<bool> s_enabled;
+    static std::atomic<quint64> s_nextFlow;
+    mutable QMutex m_buffersMutex;
+    QVector<Buffer*> m_buffers;
+    qint64 m_originNs = 0;
+};
+
+// Slice ('X' event) covering a scope.
+class TraceZone
+{
+public:
+    TraceZone(const char *cat, const char *name)
+        : m_cat(cat), m_name(name), m_start(Tracer::enabled() ? Tracer::nowNs() : 0) {}
+    ~TraceZone() { if (m_start) Tracer::complete(m_cat, m_name, m_start, Tracer::nowNs()); }
+    TraceZone(const TraceZone &) = delete;
+    TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+    const char *m_cat;
+    const char *m_name;
+    qint64 m_start;
+};
+
+// Makes `id` the thread's current flow for the scope (restores the previous one on exit).
+class TraceFlowScope
+{
+public:
+    explicit TraceFlowScope(quint64 id);
+    ~TraceFlowScope();
+    TraceFlowScope(const TraceFlowScope &) = delete;
+    TraceFlowScope &operator=(const TraceFlowScope &) = delete;
+
+private:
+    quint64 m_previous;
+};
+
+#ifdef QPX_NO_TRACE
+#  define TRACE_ZONE(cat, name) do {} while (0)
+#  define TRACE_INSTANT(cat, name) do {} while (0)
+#  define TRACE_COUNTER(name, value) do {} while (0)
+#  define TRACE_FLOW_BEGIN(cat, name, id) do {} while (0)
+#  define TRACE_FLOW_STEP(cat, name, id) do {} while (0)
+#  define TRACE_FLOW_END(cat, name, id) do {} while (0)
+#else
+#  define QPX_TRACE_CAT2(a, b) a##b
+#  define QPX_TRACE_CAT(a, b) QPX_TRACE_CAT2(a, b)
+#  define TRACE_ZONE(cat, name) TraceZone QPX_TRACE_CAT(qpxTraceZone_, __LINE__)(cat, name)
+#  define TRACE_INSTANT(cat, name) \
+    do { if (Tracer::enabled()) Tracer::instant(cat, name); } while (0)
+#  define TRACE_COUNTER(name, value) \
+    do { if (Tracer::enabled()) Tracer::counter(name, double(value)); } while (0)
+#  define TRACE_FLOW_BEGIN(cat, name, id) \
+    do { if (Tracer::enabled()) Tracer::flow('s', cat, name, id); } while (0)
+#  define TRACE_FLOW_STEP(cat, name, id) \
+    do { if (Tracer::enabled()) Tracer::flow('t', cat, name, id); } while (0)
+#  define TRACE_FLOW_END(cat, name, id) \
+    do { if (Tracer::enabled()) Tracer::flow('f', cat, name, id); } while (0)
+#endif
+
+#endif // TRACER_H
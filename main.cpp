@@ -6,6 +6,9 @@
 #include "Data/datamanager.h"
 #include "Utils/configurationmanager.h"
 #include "Utils/marketcalendar.h"
+#include "Utils/logger.h"
+#include "Utils/latencymonitor.h"
+#include "Utils/tracer.h"
 
 // --- path helpers (Windows-friendly, no schema change) ---
 static QString qp_cfgRoot() {
@@ -33,12 +36,39 @@ int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    // Background log writer (Logs/QphoeniX.log); data-path logging goes through it.
+    Logger::instance()->start();
+    // Per-stage latency percentiles, appended every 5 minutes and at exit.
+    LatencyMonitor::instance()->startPeriodicDump("Logs/latency.log", 300);
+    // Startup/request timeline (Logs/trace.json, open in ui.perfetto.dev) when QPX_TRACE is set.
+    const bool tracing = qEnvironmentVariableIsSet("QPX_TRACE");
+    Tracer::instance()->setEnabled(tracing);
+    Tracer::instance()->setThreadName("main");
+
+    // Flushes the latency/trace files and the log on every way out of main(), after the
+    // objects below (and whatever they log while being destroyed) are gone.
+    struct ShutdownGuard {
+        bool tracing;
+        ~ShutdownGuard() {
+            LatencyMonitor::instance()->dumpToFile("Logs/latency.log");
+            if (tracing)
+                Tracer::instance()->exportChromeJson("Logs/trace.json");
+            Logger::instance()->stop();
+        }
+    } shutdownGuard{ tracing };
+
     // Initialize ConfigurationManager first
     const QString configPath = qp_cfgFile("config.json");
-    ConfigurationManager::instance()->loadConfiguration(configPath);
+    {
+        TRACE_ZONE("startup", "loadConfiguration");
+        ConfigurationManager::instance()->loadConfiguration(configPath);
+    }
 
     // Initialize MarketCalendar and load holidays
-    MarketCalendar::instance()->loadHolidays();
+    {
+        TRACE_ZONE("startup", "loadHolidays");
+        MarketCalendar::instance()->loadHolidays();
+    }
 
     // Get the API key from the configuration
     QString apiKey = ConfigurationManager::instance()->getApiKey();
@@ -51,9 +81,13 @@ int main(int argc, char *argv[])
     KiteConnectAPI kiteAPI(apiKey);
 
     // Create and show the main window
+    TRACE_INSTANT("startup", "mainWindow.begin");
     MainWindow w;
     w.setKiteConnectAPI(&kiteAPI);
-    w.show();
+    {
+        TRACE_ZONE("startup", "MainWindow::show");
+        w.show();
+    }
 
     // Initialize DataManager
     DataManager::instance();